@@ -18,7 +18,9 @@ from pydantic import BaseModel
 from typing import List, Dict, Any, Optional
 import httpx
 import base64
+import io
 import os
+import wave
 from dotenv import load_dotenv
 import logging
 
@@ -27,6 +29,21 @@ load_dotenv()
 logging.basicConfig(level=logging.INFO)
 logger = logging.getLogger(__name__)
 
+# TTS output format: 16-bit mono PCM, wrapped in WAV so receivers know the format.
+# ElevenLabs only serves pcm_44100 to Pro accounts and above, so other tiers fall back
+# to the next rate; the first rate the account accepts is kept for later requests.
+TTS_SAMPLE_RATES = [44100, 24000, 16000]
+tts_sample_rate_index = 0
+
+def pcm_to_wav(pcm: bytes, sample_rate: int, num_channels: int = 1) -> bytes:
+    buffer = io.BytesIO()
+    with wave.open(buffer, "wb") as wav_file:
+        wav_file.setnchannels(num_channels)
+        wav_file.setsampwidth(2)
+        wav_file.setframerate(sample_rate)
+        wav_file.writeframes(pcm)
+    return buffer.getvalue()
+
 app = FastAPI(title="MetaHuman Backend")
 
 # Enable CORS for demo
@@ -160,37 +177,47 @@ async def generate_llm_response(messages: List[Message]) -> str:
         raise
 
 async def text_to_speech(text: str) -> bytes:
+    global tts_sample_rate_index
     try:
         api_key = os.getenv("TTS_API_KEY")
         if not api_key:
             logger.warning("TTS_API_KEY not set, returning dummy audio data")
             return b"DUMMY_AUDIO_DATA"
         async with httpx.AsyncClient() as client:
-            response = await client.post(
-                "https://api.elevenlabs.io/v1/text-to-speech/voice_id",
-                headers={
-                    "xi-api-key": api_key,
-                    "Content-Type": "application/json"
-                },
-                json={
-                    "text": text,
-                    "model_id": "eleven_monolingual_v1",
-                    "voice_settings": {
-                        "stability": 0.5,
-                        "similarity_boost": 0.5
-                    }
-                },
-                timeout=30.0
-            )
-            if response.status_code != 200:
+            while True:
+                sample_rate = TTS_SAMPLE_RATES[tts_sample_rate_index]
+                response = await client.post(
+                    "https://api.elevenlabs.io/v1/text-to-speech/voice_id",
+                    params={"output_format": f"pcm_{sample_rate}"},
+                    headers={
+                        "xi-api-key": api_key,
+                        "Content-Type": "application/json"
+                    },
+                    json={
+                        "text": text,
+                        "model_id": "eleven_monolingual_v1",
+                        "voice_settings": {
+                            "stability": 0.5,
+                            "similarity_boost": 0.5
+                        }
+                    },
+                    timeout=30.0
+                )
+                if response.status_code == 200:
+                    return pcm_to_wav(response.content, sample_rate)
+                format_refused = response.status_code in (400, 401, 403, 422) and "output_format" in response.text
+                if format_refused and tts_sample_rate_index + 1 < len(TTS_SAMPLE_RATES):
+                    logger.warning(f"TTS account does not allow pcm_{sample_rate}, falling back to pcm_{TTS_SAMPLE_RATES[tts_sample_rate_index + 1]}")
+                    tts_sample_rate_index += 1
+                    continue
                 logger.error(f"TTS API error: {response.text}")
                 raise HTTPException(status_code=response.status_code, detail="TTS API error")
-            return response.content
     except Exception as e:
         logger.error(f"Error in text-to-speech: {e}")
         raise
 
 async def audio_to_blendshapes(audio_data: bytes) -> list:
+    # audio_data is the WAV from text_to_speech, not the MP3 ElevenLabs returns by default
     try:
         api_key = os.getenv("NEUROSYNC_API_KEY")
         if not api_key:
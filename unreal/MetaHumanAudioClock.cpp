@@ -0,0 +1,139 @@
+/**
+ * MetaHumanAudioClock.cpp
+ *
+ * Implementation of FMetaHumanAudioClock and UMetaHumanClockedSoundWave.
+ */
+
+#include "MetaHumanAudioClock.h"
+
+FMetaHumanAudioClock::FMetaHumanAudioClock()
+    : Version(0)
+    , RenderedFrames(0)
+    , LastRenderTime(0.0)
+    , SampleRate(0)
+{
+}
+
+void FMetaHumanAudioClock::Reset(int32 InSampleRate)
+{
+    const uint32 StartVersion = Version.load(std::memory_order_relaxed);
+    Version.store(StartVersion + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    RenderedFrames.store(0, std::memory_order_relaxed);
+    LastRenderTime.store(0.0, std::memory_order_relaxed);
+    SampleRate.store(InSampleRate, std::memory_order_relaxed);
+
+    Version.store(StartVersion + 2, std::memory_order_release);
+}
+
+void FMetaHumanAudioClock::AddRenderedFrames(int32 NumFrames, double RenderTime)
+{
+    // Mark the pair as being written so readers retry instead of mixing old and new values
+    const uint32 StartVersion = Version.load(std::memory_order_relaxed);
+    Version.store(StartVersion + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    RenderedFrames.store(RenderedFrames.load(std::memory_order_relaxed) + NumFrames, std::memory_order_relaxed);
+    LastRenderTime.store(RenderTime, std::memory_order_relaxed);
+
+    Version.store(StartVersion + 2, std::memory_order_release);
+}
+
+bool FMetaHumanAudioClock::GetPlaybackTime(double Now, double OutputLatency, double& OutSeconds) const
+{
+    // Read a consistent snapshot; the writer only holds the pair for a few instructions
+    int64 Frames = 0;
+    double RenderTime = 0.0;
+    int32 Rate = 0;
+    for (;;)
+    {
+        const uint32 StartVersion = Version.load(std::memory_order_acquire);
+        Frames = RenderedFrames.load(std::memory_order_relaxed);
+        RenderTime = LastRenderTime.load(std::memory_order_relaxed);
+        Rate = SampleRate.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if ((StartVersion & 1) == 0 && Version.load(std::memory_order_relaxed) == StartVersion)
+        {
+            break;
+        }
+        FPlatformProcess::Yield();
+    }
+
+    if (Frames <= 0 || Rate <= 0)
+    {
+        return false;
+    }
+
+    // The last rendered frame is heard OutputLatency after rendering; advance in real time from there
+    const double RenderedSeconds = (double)Frames / Rate;
+    OutSeconds = FMath::Clamp(RenderedSeconds - OutputLatency + (Now - RenderTime), 0.0, RenderedSeconds);
+    return true;
+}
+
+int32 UMetaHumanClockedSoundWave::GeneratePCMData(uint8* PCMData, const int32 SamplesNeeded)
+{
+    const int32 BytesQueuedBefore = GetAvailableAudioByteCount();
+    const int32 BytesGenerated = Super::GeneratePCMData(PCMData, SamplesNeeded);
+    const int32 BytesQueuedAfter = GetAvailableAudioByteCount();
+
+    // On an underrun the base class pads the buffer with silence, which must not advance the
+    // clock. Both the bytes queued beforehand and the drop in the queue are lower bounds on the
+    // bytes taken from it (the game thread may queue more meanwhile), so count the larger one.
+    const int32 BytesFromQueue = FMath::Clamp(FMath::Max(FMath::Min(BytesQueuedBefore, BytesGenerated), BytesQueuedBefore - BytesQueuedAfter), 0, BytesGenerated);
+    const int32 BytesPerFrame = sizeof(int16) * FMath::Max(NumChannels, 1);
+    const int32 FramesGenerated = BytesGenerated / BytesPerFrame;
+    const int32 FramesFromQueue = BytesFromQueue / BytesPerFrame;
+    if (FramesFromQueue > 0)
+    {
+        Clock.AddRenderedFrames(FramesFromQueue, FPlatformTime::Seconds());
+    }
+
+    // Ramp the gain down frame by frame from where the fade was requested, then render silence
+    const int32 FadeFrames = FadeOutFrames.load(std::memory_order_acquire);
+    if (FadeFrames > 0 && FramesGenerated > 0)
+    {
+        const int32 Channels = FMath::Max(NumChannels, 1);
+        int16* Samples = reinterpret_cast<int16*>(PCMData);
+        for (int32 FrameIndex = 0; FrameIndex < FramesGenerated; FrameIndex++)
+        {
+            const float Gain = FMath::Max(1.0f - (float)FadeOutPosition / FadeFrames, 0.0f);
+            for (int32 ChannelIndex = 0; ChannelIndex < Channels; ChannelIndex++)
+            {
+                int16& Sample = Samples[FrameIndex * Channels + ChannelIndex];
+                Sample = (int16)(Sample * Gain);
+            }
+            FadeOutPosition = FMath::Min(FadeOutPosition + 1, FadeFrames);
+        }
+
+        if (FadeOutPosition >= FadeFrames && FadeOutCompleteTime.load(std::memory_order_relaxed) <= 0.0)
+        {
+            FadeOutCompleteTime.store(FPlatformTime::Seconds(), std::memory_order_release);
+        }
+    }
+
+    return BytesGenerated;
+}
+
+void UMetaHumanClockedSoundWave::SetFormat(int32 InSampleRate, int32 InNumChannels)
+{
+    SetSampleRate(InSampleRate);
+    NumChannels = InNumChannels;
+    Clock.Reset(InSampleRate);
+    FadeOutFrames.store(0, std::memory_order_relaxed);
+    FadeOutPosition = 0;
+    FadeOutCompleteTime.store(0.0, std::memory_order_relaxed);
+}
+
+void UMetaHumanClockedSoundWave::BeginFadeOut(int32 NumFrames)
+{
+    // Only the first request counts; a second interrupt must not restart the fade at full gain
+    int32 NoFade = 0;
+    FadeOutFrames.compare_exchange_strong(NoFade, FMath::Max(NumFrames, 1), std::memory_order_release);
+}
+
+bool UMetaHumanClockedSoundWave::GetFadeOutCompleteTime(double& OutRenderTime) const
+{
+    OutRenderTime = FadeOutCompleteTime.load(std::memory_order_acquire);
+    return OutRenderTime > 0.0;
+}
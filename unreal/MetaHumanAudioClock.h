@@ -0,0 +1,158 @@
+/**
+ * MetaHumanAudioClock.h
+ *
+ * This header file defines UMetaHumanClockedSoundWave, a procedural sound wave that counts
+ * the samples the audio renderer pulls from it, and FMetaHumanAudioClock, the lock-free
+ * clock it publishes that count through.
+ *
+ * Libraries/Modules used:
+ * - CoreMinimal.h: Core Unreal Engine functionality
+ * - Sound/SoundWaveProcedural.h: Procedural sound wave base class
+ *
+ * The render thread is the only writer of the clock; the game thread and animation worker
+ * threads read it at any time. A reader gets the number of frames rendered and the time
+ * they were rendered as one consistent pair, and extrapolates the playback position from
+ * them, so lip-sync does not depend on when in the frame the read happens.
+ *
+ * The sound wave can also fade its audio out on the render thread, starting with the next
+ * sample the renderer pulls, so an interrupt silences it without a click and records when
+ * the last audible sample was rendered.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Sound/SoundWaveProcedural.h"
+#include <atomic>
+#include "MetaHumanAudioClock.generated.h"
+
+/**
+ * Single-writer, multi-reader playback clock fed by the audio render thread
+ */
+class METAHUMANSTREAMING_API FMetaHumanAudioClock
+{
+public:
+    FMetaHumanAudioClock();
+
+    /**
+     * Set the sample rate and clear the rendered frame count
+     *
+     * Must not be called while the audio renderer may be writing.
+     *
+     * @param InSampleRate - Sample rate of the counted audio
+     */
+    void Reset(int32 InSampleRate);
+
+    /**
+     * Record frames handed to the audio renderer (audio render thread)
+     *
+     * @param NumFrames - Number of frames (samples per channel) rendered
+     * @param RenderTime - FPlatformTime::Seconds() when they were rendered
+     */
+    void AddRenderedFrames(int32 NumFrames, double RenderTime);
+
+    /**
+     * Get the playback position heard at the given time (any thread)
+     *
+     * Frames reach the speaker OutputLatency seconds after they are rendered. The position
+     * advances in real time from the last render and never passes the last rendered frame.
+     *
+     * @param Now - FPlatformTime::Seconds() to evaluate the clock at
+     * @param OutputLatency - Seconds between rendering and hearing a frame
+     * @param OutSeconds - Receives the playback position in seconds
+     * @return bool - False if nothing has been rendered yet
+     */
+    bool GetPlaybackTime(double Now, double OutputLatency, double& OutSeconds) const;
+
+    /**
+     * Get the number of frames rendered so far (any thread)
+     *
+     * @return int64 - Rendered frames
+     */
+    int64 GetRenderedFrames() const { return RenderedFrames.load(std::memory_order_relaxed); }
+
+private:
+    // Sequence counter guarding the pair below; odd while the writer is updating it
+    std::atomic<uint32> Version;
+
+    // Frames rendered so far and the time the last of them were rendered
+    std::atomic<int64> RenderedFrames;
+    std::atomic<double> LastRenderTime;
+
+    // Sample rate of the counted audio
+    std::atomic<int32> SampleRate;
+};
+
+/**
+ * Procedural sound wave that publishes how much of its audio has been rendered
+ *
+ * UCLASS: Unreal Engine macro for defining a class that can be used in Blueprint
+ * GENERATED_BODY: Unreal Engine macro for generating boilerplate code
+ */
+UCLASS()
+class METAHUMANSTREAMING_API UMetaHumanClockedSoundWave : public USoundWaveProcedural
+{
+    GENERATED_BODY()
+
+public:
+    /**
+     * Pull queued audio for the renderer and count the frames taken from the queue
+     *
+     * Silence the base class pads an underrun with is rendered but not counted, so the
+     * clock stops where the queued audio ran out.
+     *
+     * Called on the audio render thread.
+     *
+     * @param PCMData - Buffer to fill with 16-bit PCM
+     * @param SamplesNeeded - Number of samples (all channels) requested
+     * @return int32 - Number of bytes written
+     */
+    virtual int32 GeneratePCMData(uint8* PCMData, const int32 SamplesNeeded) override;
+
+    /**
+     * Get the playback clock of this sound wave
+     *
+     * @return const FMetaHumanAudioClock& - The clock, safe to read from any thread
+     */
+    const FMetaHumanAudioClock& GetClock() const { return Clock; }
+
+    /**
+     * Set the format of the queued audio and reset the clock
+     *
+     * Call before the sound starts playing.
+     *
+     * @param InSampleRate - Sample rate of the 16-bit PCM audio
+     * @param InNumChannels - Number of interleaved channels
+     */
+    void SetFormat(int32 InSampleRate, int32 InNumChannels);
+
+    /**
+     * Fade the audio out, starting with the next frame the renderer pulls (game thread)
+     *
+     * Frames after the fade are rendered as silence.
+     *
+     * @param NumFrames - Length of the linear fade in frames (samples per channel)
+     */
+    void BeginFadeOut(int32 NumFrames);
+
+    /**
+     * Get when the fade out finished rendering (any thread)
+     *
+     * @param OutRenderTime - Receives FPlatformTime::Seconds() when the last faded frame was rendered
+     * @return bool - False if no fade has finished
+     */
+    bool GetFadeOutCompleteTime(double& OutRenderTime) const;
+
+private:
+    // Playback clock fed from GeneratePCMData
+    FMetaHumanAudioClock Clock;
+
+    // Length of the requested fade out in frames, or 0 if none was requested
+    std::atomic<int32> FadeOutFrames{ 0 };
+
+    // Frames of the fade rendered so far (render thread only)
+    int32 FadeOutPosition = 0;
+
+    // Time the fade finished rendering, or 0 while it has not
+    std::atomic<double> FadeOutCompleteTime{ 0.0 };
+};
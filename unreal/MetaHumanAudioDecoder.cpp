@@ -0,0 +1,432 @@
+/**
+ * MetaHumanAudioDecoder.cpp
+ *
+ * Implementation of FMetaHumanAudioDecoder, which turns received audio into 16-bit PCM.
+ */
+
+#include "MetaHumanAudioDecoder.h"
+#include "MetaHumanOpus.h"
+
+namespace MetaHumanAudioDecoder
+{
+    // WAVE format tags
+    constexpr uint16 WaveFormatPCM = 0x0001;
+    constexpr uint16 WaveFormatFloat = 0x0003;
+    constexpr uint16 WaveFormatExtensible = 0xFFFE;
+
+    // Size of an Ogg page header before its segment table
+    constexpr int32 OggPageHeaderSize = 27;
+
+    // Ogg Opus granule positions always count 48 kHz samples
+    constexpr int32 OggOpusSampleRate = 48000;
+
+    template <typename T>
+    T ReadAt(const uint8* Data, int64 Offset)
+    {
+        T Value;
+        FMemory::Memcpy(&Value, Data + Offset, sizeof(T));
+        return Value;
+    }
+
+    bool MatchesTag(TConstArrayView<uint8> Data, int64 Offset, const char* Tag, int32 TagSize)
+    {
+        return Offset + TagSize <= Data.Num() && FMemory::Memcmp(Data.GetData() + Offset, Tag, TagSize) == 0;
+    }
+
+    /**
+     * Format of one MPEG audio frame header
+     */
+    struct FMp3FrameHeader
+    {
+        int32 SampleRate = 0;
+        int32 NumChannels = 0;
+        int32 FrameSize = 0;
+    };
+
+    /**
+     * Read an MPEG-1/2/2.5 Layer III frame header
+     */
+    bool ReadMp3FrameHeader(TConstArrayView<uint8> Data, int64 Offset, FMp3FrameHeader& OutHeader)
+    {
+        static constexpr int32 BitratesV1[16] = { 0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 0 };
+        static constexpr int32 BitratesV2[16] = { 0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160, 0 };
+        static constexpr int32 SampleRatesV1[4] = { 44100, 48000, 32000, 0 };
+
+        if (Offset + 4 > Data.Num())
+        {
+            return false;
+        }
+
+        const uint8* Header = Data.GetData() + Offset;
+        const int32 VersionBits = (Header[1] >> 3) & 0x3;
+        const int32 LayerBits = (Header[1] >> 1) & 0x3;
+        const int32 BitrateIndex = Header[2] >> 4;
+        const int32 SampleRateIndex = (Header[2] >> 2) & 0x3;
+        if (Header[0] != 0xFF || (Header[1] & 0xE0) != 0xE0 || VersionBits == 1 || LayerBits != 1 ||
+            BitratesV1[BitrateIndex] == 0 || SampleRatesV1[SampleRateIndex] == 0)
+        {
+            return false;
+        }
+
+        // Version bits: 3 = MPEG-1, 2 = MPEG-2, 0 = MPEG-2.5
+        const bool bMpeg1 = VersionBits == 3;
+        const int32 Bitrate = (bMpeg1 ? BitratesV1[BitrateIndex] : BitratesV2[BitrateIndex]) * 1000;
+        OutHeader.SampleRate = SampleRatesV1[SampleRateIndex] >> (bMpeg1 ? 0 : (VersionBits == 2 ? 1 : 2));
+        OutHeader.NumChannels = (Header[3] >> 6) == 3 ? 1 : 2;
+        OutHeader.FrameSize = (bMpeg1 ? 144 : 72) * Bitrate / OutHeader.SampleRate + ((Header[2] >> 1) & 0x1);
+        return true;
+    }
+
+    /**
+     * Find the first Layer III frame, after an ID3v2 tag if there is one
+     */
+    int64 FindMp3Frame(TConstArrayView<uint8> Data)
+    {
+        int64 Offset = 0;
+        if (MatchesTag(Data, 0, "ID3", 3) && Data.Num() >= 10)
+        {
+            // The tag size is a 28-bit syncsafe integer following the 10-byte tag header
+            const uint8* Tag = Data.GetData();
+            Offset = 10 + ((Tag[6] & 0x7F) << 21 | (Tag[7] & 0x7F) << 14 | (Tag[8] & 0x7F) << 7 | (Tag[9] & 0x7F));
+        }
+
+        // A frame header counts only if another one follows it, so PCM rarely passes for MP3
+        FMp3FrameHeader Header;
+        FMp3FrameHeader NextHeader;
+        if (ReadMp3FrameHeader(Data, Offset, Header) &&
+            (Offset + Header.FrameSize == Data.Num() || ReadMp3FrameHeader(Data, Offset + Header.FrameSize, NextHeader)))
+        {
+            return Offset;
+        }
+        return INDEX_NONE;
+    }
+
+    /**
+     * Find the payload of the first page of an Ogg stream
+     */
+    int64 GetFirstOggPayloadOffset(TConstArrayView<uint8> Data)
+    {
+        if (!MatchesTag(Data, 0, "OggS", 4) || Data.Num() < OggPageHeaderSize)
+        {
+            return INDEX_NONE;
+        }
+        return OggPageHeaderSize + Data[26];
+    }
+
+    /**
+     * Convert non-16-bit WAV samples to 16-bit PCM
+     */
+    bool ConvertWavSamples(const uint8* Samples, int64 NumSamples, uint16 FormatTag, int32 BitsPerSample, TArray<uint8>& OutPCM)
+    {
+        OutPCM.SetNumUninitialized(NumSamples * sizeof(int16));
+        int16* Dest = reinterpret_cast<int16*>(OutPCM.GetData());
+
+        if (FormatTag == WaveFormatFloat && BitsPerSample == 32)
+        {
+            for (int64 SampleIndex = 0; SampleIndex < NumSamples; SampleIndex++)
+            {
+                const float Sample = ReadAt<float>(Samples, SampleIndex * 4);
+                Dest[SampleIndex] = (int16)FMath::Clamp(FMath::RoundToInt(Sample * 32767.0f), -32768, 32767);
+            }
+            return true;
+        }
+
+        if (FormatTag != WaveFormatPCM)
+        {
+            return false;
+        }
+
+        // Integer samples keep their top 16 bits; 8-bit samples are unsigned
+        const int32 BytesPerSample = BitsPerSample / 8;
+        switch (BitsPerSample)
+        {
+        case 8:
+            for (int64 SampleIndex = 0; SampleIndex < NumSamples; SampleIndex++)
+            {
+                Dest[SampleIndex] = (int16)((Samples[SampleIndex] - 128) * 256);
+            }
+            return true;
+        case 24:
+        case 32:
+            for (int64 SampleIndex = 0; SampleIndex < NumSamples; SampleIndex++)
+            {
+                Dest[SampleIndex] = ReadAt<int16>(Samples, SampleIndex * BytesPerSample + BytesPerSample - 2);
+            }
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    /**
+     * Decode a RIFF WAVE file
+     */
+    bool DecodeWav(TConstArrayView<uint8> Data, FMetaHumanAudioFormat& OutFormat, TArray<uint8>& OutPCM, int32& OutPCMOffset, int32& OutPCMSize)
+    {
+        const uint8* Bytes = Data.GetData();
+        uint16 FormatTag = 0;
+        int32 BitsPerSample = 0;
+        int32 BlockAlign = 0;
+        bool bHasFormat = false;
+
+        // Walk the chunks until the data chunk; the format chunk must come before it
+        int64 Offset = 12;
+        while (Offset + 8 <= Data.Num())
+        {
+            const int64 ChunkSize = ReadAt<uint32>(Bytes, Offset + 4);
+            const int64 ChunkOffset = Offset + 8;
+
+            if (MatchesTag(Data, Offset, "fmt ", 4) && ChunkSize >= 16 && ChunkOffset + 16 <= Data.Num())
+            {
+                FormatTag = ReadAt<uint16>(Bytes, ChunkOffset);
+                OutFormat.NumChannels = ReadAt<uint16>(Bytes, ChunkOffset + 2);
+                OutFormat.SampleRate = (int32)ReadAt<uint32>(Bytes, ChunkOffset + 4);
+                BlockAlign = ReadAt<uint16>(Bytes, ChunkOffset + 12);
+                BitsPerSample = ReadAt<uint16>(Bytes, ChunkOffset + 14);
+                if (FormatTag == WaveFormatExtensible && ChunkSize >= 40 && ChunkOffset + 26 <= Data.Num())
+                {
+                    // The real format tag leads the sub-format GUID
+                    FormatTag = ReadAt<uint16>(Bytes, ChunkOffset + 24);
+                }
+                bHasFormat = true;
+            }
+            else if (MatchesTag(Data, Offset, "data", 4))
+            {
+                if (!bHasFormat || OutFormat.NumChannels <= 0 || OutFormat.SampleRate <= 0 || BlockAlign != OutFormat.NumChannels * BitsPerSample / 8 || BlockAlign == 0)
+                {
+                    UE_LOG(LogTemp, Error, TEXT("WAV audio has a missing or invalid format chunk"));
+                    return false;
+                }
+
+                // Streamed WAVs may leave the size unset; use whatever whole frames arrived
+                const int64 DataSize = FMath::Min<int64>(ChunkSize, Data.Num() - ChunkOffset);
+                OutFormat.NumFrames = DataSize / BlockAlign;
+                if (FormatTag == WaveFormatPCM && BitsPerSample == 16)
+                {
+                    OutPCM.Reset();
+                    OutPCMOffset = (int32)ChunkOffset;
+                    OutPCMSize = (int32)(OutFormat.NumFrames * BlockAlign);
+                    return true;
+                }
+
+                if (!ConvertWavSamples(Bytes + ChunkOffset, OutFormat.NumFrames * OutFormat.NumChannels, FormatTag, BitsPerSample, OutPCM))
+                {
+                    UE_LOG(LogTemp, Error, TEXT("Unsupported WAV sample format (format %d, %d bits)"), FormatTag, BitsPerSample);
+                    return false;
+                }
+                OutPCMOffset = 0;
+                OutPCMSize = OutPCM.Num();
+                return true;
+            }
+
+            // Chunks are padded to an even size
+            Offset = ChunkOffset + ChunkSize + (ChunkSize & 1);
+        }
+
+        UE_LOG(LogTemp, Error, TEXT("WAV audio has no data chunk"));
+        return false;
+    }
+
+    /**
+     * Decode an Ogg Opus file
+     */
+    bool DecodeOggOpus(TConstArrayView<uint8> Data, FMetaHumanAudioFormat& OutFormat, TArray<uint8>& OutPCM)
+    {
+        const uint8* Bytes = Data.GetData();
+        FMetaHumanOpusDecoder Decoder;
+        TArray<uint8> Packet;
+        int32 PacketIndex = 0;
+        int32 PreSkip = 0;
+        int64 FinalGranule = -1;
+        uint32 StreamSerial = 0;
+
+        OutPCM.Reset();
+
+        // Reassemble packets from page segments; a 255-byte segment continues the packet
+        int64 Offset = 0;
+        while (Offset + OggPageHeaderSize <= Data.Num() && MatchesTag(Data, Offset, "OggS", 4))
+        {
+            const int64 Granule = ReadAt<int64>(Bytes, Offset + 6);
+            const uint32 Serial = ReadAt<uint32>(Bytes, Offset + 14);
+            const int32 NumSegments = Bytes[Offset + 26];
+            const int64 SegmentTableOffset = Offset + OggPageHeaderSize;
+            int64 SegmentOffset = SegmentTableOffset + NumSegments;
+            if (SegmentOffset > Data.Num())
+            {
+                break;
+            }
+
+            // Only the first logical stream is played
+            if (Offset == 0)
+            {
+                StreamSerial = Serial;
+            }
+            const bool bOwnPage = Serial == StreamSerial;
+            if (bOwnPage && Granule >= 0)
+            {
+                FinalGranule = Granule;
+            }
+
+            for (int32 SegmentIndex = 0; SegmentIndex < NumSegments; SegmentIndex++)
+            {
+                const int32 SegmentSize = Bytes[SegmentTableOffset + SegmentIndex];
+                if (SegmentOffset + SegmentSize > Data.Num())
+                {
+                    SegmentOffset = Data.Num() + 1;
+                    break;
+                }
+                if (bOwnPage)
+                {
+                    Packet.Append(Bytes + SegmentOffset, SegmentSize);
+                }
+                SegmentOffset += SegmentSize;
+                if (SegmentSize == 255 || !bOwnPage)
+                {
+                    continue;
+                }
+
+                // The first packet is the identification header and the second the comment header
+                if (PacketIndex == 0)
+                {
+                    if (Packet.Num() < 19 || FMemory::Memcmp(Packet.GetData(), "OpusHead", 8) != 0 || Packet[18] != 0)
+                    {
+                        UE_LOG(LogTemp, Error, TEXT("Ogg stream is not a supported Opus stream"));
+                        return false;
+                    }
+                    OutFormat.NumChannels = Packet[9];
+                    PreSkip = ReadAt<uint16>(Packet.GetData(), 10);
+                    if (!Decoder.Initialize(OggOpusSampleRate, OutFormat.NumChannels))
+                    {
+                        return false;
+                    }
+                }
+                else if (PacketIndex > 1 && Decoder.DecodePacket(Packet, OutPCM) == INDEX_NONE)
+                {
+                    return false;
+                }
+                PacketIndex++;
+                Packet.Reset();
+            }
+
+            if (SegmentOffset > Data.Num())
+            {
+                break;
+            }
+            Offset = SegmentOffset;
+        }
+
+        if (!Decoder.IsInitialized())
+        {
+            UE_LOG(LogTemp, Error, TEXT("Ogg Opus audio has no identification header"));
+            return false;
+        }
+
+        // Drop the encoder delay at the start and the padding after the last granule position
+        const int32 BytesPerFrame = sizeof(int16) * OutFormat.NumChannels;
+        int64 NumFrames = OutPCM.Num() / BytesPerFrame;
+        const int64 SkipFrames = FMath::Min<int64>(PreSkip, NumFrames);
+        OutPCM.RemoveAt(0, SkipFrames * BytesPerFrame, false);
+        NumFrames -= SkipFrames;
+        if (FinalGranule >= PreSkip)
+        {
+            NumFrames = FMath::Min(NumFrames, FinalGranule - PreSkip);
+        }
+        OutPCM.SetNum(NumFrames * BytesPerFrame, false);
+
+        OutFormat.SampleRate = OggOpusSampleRate;
+        OutFormat.NumFrames = NumFrames;
+        return true;
+    }
+}
+
+EMetaHumanAudioContainer FMetaHumanAudioDecoder::DetectContainer(TConstArrayView<uint8> Data)
+{
+    using namespace MetaHumanAudioDecoder;
+
+    if (MatchesTag(Data, 0, "RIFF", 4) && MatchesTag(Data, 8, "WAVE", 4))
+    {
+        return EMetaHumanAudioContainer::Wav;
+    }
+
+    const int64 OggPayloadOffset = GetFirstOggPayloadOffset(Data);
+    if (OggPayloadOffset != INDEX_NONE && MatchesTag(Data, OggPayloadOffset, "OpusHead", 8))
+    {
+        return EMetaHumanAudioContainer::OggOpus;
+    }
+
+    if (FindMp3Frame(Data) != INDEX_NONE)
+    {
+        return EMetaHumanAudioContainer::Mp3;
+    }
+
+    return EMetaHumanAudioContainer::RawPCM;
+}
+
+bool FMetaHumanAudioDecoder::Decode(TConstArrayView<uint8> Data, const FMetaHumanAudioFormat& RawFormat, FMetaHumanAudioFormat& OutFormat,
+    TArray<uint8>& OutPCM, int32& OutPCMOffset, int32& OutPCMSize)
+{
+    using namespace MetaHumanAudioDecoder;
+
+    OutFormat = FMetaHumanAudioFormat();
+    OutFormat.Container = DetectContainer(Data);
+    OutPCM.Reset();
+    OutPCMOffset = 0;
+    OutPCMSize = 0;
+
+    switch (OutFormat.Container)
+    {
+    case EMetaHumanAudioContainer::Wav:
+        return DecodeWav(Data, OutFormat, OutPCM, OutPCMOffset, OutPCMSize);
+
+    case EMetaHumanAudioContainer::OggOpus:
+        if (!DecodeOggOpus(Data, OutFormat, OutPCM))
+        {
+            return false;
+        }
+        OutPCMSize = OutPCM.Num();
+        return true;
+
+    case EMetaHumanAudioContainer::Mp3:
+    {
+        // Describe the stream so the sender can tell what to change
+        FMp3FrameHeader Header;
+        ReadMp3FrameHeader(Data, FindMp3Frame(Data), Header);
+        UE_LOG(LogTemp, Error, TEXT("MP3 audio (%d Hz, %d channels) cannot be decoded at runtime; send WAV, Ogg Opus or raw PCM instead"),
+            Header.SampleRate, Header.NumChannels);
+        return false;
+    }
+
+    case EMetaHumanAudioContainer::RawPCM:
+    default:
+    {
+        if (RawFormat.SampleRate <= 0 || RawFormat.NumChannels <= 0)
+        {
+            UE_LOG(LogTemp, Error, TEXT("Raw PCM audio needs a sample rate and channel count"));
+            return false;
+        }
+
+        const int32 BytesPerFrame = sizeof(int16) * RawFormat.NumChannels;
+        OutFormat.SampleRate = RawFormat.SampleRate;
+        OutFormat.NumChannels = RawFormat.NumChannels;
+        OutFormat.NumFrames = Data.Num() / BytesPerFrame;
+        OutPCMSize = (int32)(OutFormat.NumFrames * BytesPerFrame);
+        return true;
+    }
+    }
+}
+
+const TCHAR* FMetaHumanAudioDecoder::GetContainerName(EMetaHumanAudioContainer Container)
+{
+    switch (Container)
+    {
+    case EMetaHumanAudioContainer::Wav:
+        return TEXT("WAV");
+    case EMetaHumanAudioContainer::Mp3:
+        return TEXT("MP3");
+    case EMetaHumanAudioContainer::OggOpus:
+        return TEXT("Ogg Opus");
+    case EMetaHumanAudioContainer::RawPCM:
+    default:
+        return TEXT("raw PCM");
+    }
+}
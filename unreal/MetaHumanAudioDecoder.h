@@ -0,0 +1,107 @@
+/**
+ * MetaHumanAudioDecoder.h
+ *
+ * This header file defines FMetaHumanAudioDecoder, which recognizes the container of audio
+ * received from the backend server and turns it into 16-bit interleaved PCM for a
+ * procedural sound wave.
+ *
+ * Libraries/Modules used:
+ * - CoreMinimal.h: Core Unreal Engine functionality
+ * - MetaHumanOpus.h: Opus packet decoding
+ *
+ * Supported input:
+ * - WAV: 8/16/24/32-bit integer or 32-bit float PCM; 16-bit data is used in place
+ * - Ogg Opus: decoded packet by packet at 48 kHz
+ * - MP3: recognized and described, but not decoded since the engine has no runtime MP3 decoder
+ * - Raw PCM: anything else, played with the format given by the message
+ *
+ * Everything here is free of UObjects, so it runs on the ingest worker threads.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Container of received audio
+ */
+enum class EMetaHumanAudioContainer : uint8
+{
+    // Headerless 16-bit PCM
+    RawPCM,
+
+    // RIFF WAVE file
+    Wav,
+
+    // MPEG-1/2 Layer III stream, with or without an ID3 tag
+    Mp3,
+
+    // Opus in an Ogg container
+    OggOpus
+};
+
+/**
+ * Format of decoded audio
+ */
+struct FMetaHumanAudioFormat
+{
+    // Container the audio arrived in
+    EMetaHumanAudioContainer Container = EMetaHumanAudioContainer::RawPCM;
+
+    // Sample rate in Hz
+    int32 SampleRate = 0;
+
+    // Number of interleaved channels
+    int32 NumChannels = 0;
+
+    // Number of frames (samples per channel)
+    int64 NumFrames = 0;
+
+    /**
+     * Get the duration of the audio
+     *
+     * @return double - Duration in seconds
+     */
+    double GetDuration() const { return SampleRate > 0 ? (double)NumFrames / SampleRate : 0.0; }
+};
+
+/**
+ * Container detection and decoding of received audio
+ */
+class METAHUMANSTREAMING_API FMetaHumanAudioDecoder
+{
+public:
+    /**
+     * Recognize the container of audio bytes from their first bytes
+     *
+     * @param Data - The received audio
+     * @return EMetaHumanAudioContainer - Detected container; RawPCM if nothing matches
+     */
+    static EMetaHumanAudioContainer DetectContainer(TConstArrayView<uint8> Data);
+
+    /**
+     * Decode audio to 16-bit interleaved PCM
+     *
+     * 16-bit PCM stored in the input (raw PCM, or the data chunk of a 16-bit WAV) is not
+     * copied: OutPCM is left empty and OutPCMOffset and OutPCMSize locate it in Data.
+     * Everything else is converted into OutPCM.
+     *
+     * @param Data - The received audio
+     * @param RawFormat - Sample rate and channels of raw PCM, which has no header
+     * @param OutFormat - Receives the format of the PCM
+     * @param OutPCM - Receives converted PCM, or is emptied if the PCM is used in place
+     * @param OutPCMOffset - Receives the offset of in-place PCM within Data
+     * @param OutPCMSize - Receives the size of in-place PCM
+     * @return bool - True if the audio was decoded
+     */
+    static bool Decode(TConstArrayView<uint8> Data, const FMetaHumanAudioFormat& RawFormat, FMetaHumanAudioFormat& OutFormat,
+        TArray<uint8>& OutPCM, int32& OutPCMOffset, int32& OutPCMSize);
+
+    /**
+     * Get a readable name for a container
+     *
+     * @param Container - The container
+     * @return const TCHAR* - Name of the container
+     */
+    static const TCHAR* GetContainerName(EMetaHumanAudioContainer Container);
+};
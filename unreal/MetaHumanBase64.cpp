@@ -0,0 +1,531 @@
+/**
+ * MetaHumanBase64.cpp
+ *
+ * Implementation of FMetaHumanBase64. The vector paths follow the pshufb lookup scheme
+ * described by Wojciech Muła and Daniel Lemire: each character is validated and
+ * translated to its 6-bit value with nibble lookups, then four 6-bit values are merged
+ * into three bytes with multiply-add instructions.
+ *
+ * Also implements the MetaHuman.Base64Benchmark console command.
+ */
+
+#include "MetaHumanBase64.h"
+#include "MetaHumanStreamingStats.h"
+#include "HAL/IConsoleManager.h"
+#include "Math/RandomStream.h"
+#include "Misc/Base64.h"
+
+#if PLATFORM_ALWAYS_HAS_SSE4_1 || PLATFORM_ALWAYS_HAS_AVX_2
+#include <immintrin.h>
+#endif
+
+DECLARE_CYCLE_STAT(TEXT("Base64 Decode"), STAT_MetaHumanBase64Decode, STATGROUP_MetaHumanStreaming);
+
+namespace MetaHumanBase64
+{
+    // Marks characters outside the base64 alphabet in the decode table
+    constexpr uint8 InvalidValue = 0xFF;
+
+    /**
+     * Instruction set a decode runs with; only paths the build targets can be selected
+     */
+    enum class EDecodePath : uint8
+    {
+        Scalar,
+        SSE41,
+        AVX2
+    };
+
+#if PLATFORM_ALWAYS_HAS_AVX_2
+    constexpr EDecodePath BestPath = EDecodePath::AVX2;
+#elif PLATFORM_ALWAYS_HAS_SSE4_1
+    constexpr EDecodePath BestPath = EDecodePath::SSE41;
+#else
+    constexpr EDecodePath BestPath = EDecodePath::Scalar;
+#endif
+
+    /**
+     * Character to 6-bit value table for the scalar path
+     */
+    struct FDecodeTable
+    {
+        uint8 Values[256];
+
+        constexpr FDecodeTable()
+            : Values()
+        {
+            for (int32 Index = 0; Index < 256; Index++)
+            {
+                Values[Index] = InvalidValue;
+            }
+            for (int32 Index = 0; Index < 26; Index++)
+            {
+                Values['A' + Index] = (uint8)Index;
+                Values['a' + Index] = (uint8)(26 + Index);
+            }
+            for (int32 Index = 0; Index < 10; Index++)
+            {
+                Values['0' + Index] = (uint8)(52 + Index);
+            }
+            Values['+'] = 62;
+            Values['/'] = 63;
+        }
+    };
+
+    constexpr FDecodeTable DecodeTable;
+
+    template <typename CharType>
+    FORCEINLINE uint32 GetValue(CharType Char)
+    {
+        const uint32 Code = (uint32)Char;
+        return Code < 256 ? DecodeTable.Values[Code] : InvalidValue;
+    }
+
+    /**
+     * Decode one group of four characters; Values above 63 flag an invalid character
+     */
+    template <typename CharType>
+    FORCEINLINE bool DecodeQuad(const CharType* Source, uint8* Dest)
+    {
+        const uint32 A = GetValue(Source[0]);
+        const uint32 B = GetValue(Source[1]);
+        const uint32 C = GetValue(Source[2]);
+        const uint32 D = GetValue(Source[3]);
+        if ((A | B | C | D) & 0xC0)
+        {
+            return false;
+        }
+
+        const uint32 Triple = (A << 18) | (B << 12) | (C << 6) | D;
+        Dest[0] = (uint8)(Triple >> 16);
+        Dest[1] = (uint8)(Triple >> 8);
+        Dest[2] = (uint8)Triple;
+        return true;
+    }
+
+    template <typename CharType>
+    int32 GetPadding(const CharType* Source, int32 Length)
+    {
+        if (Length < 4 || Source[Length - 1] != '=')
+        {
+            return 0;
+        }
+        return Source[Length - 2] == '=' ? 2 : 1;
+    }
+
+    template <typename CharType>
+    int32 GetDecodedSize(const CharType* Source, int32 Length)
+    {
+        if (Length % 4 != 0)
+        {
+            return INDEX_NONE;
+        }
+        return Length / 4 * 3 - GetPadding(Source, Length);
+    }
+
+#if PLATFORM_ALWAYS_HAS_SSE4_1
+    /**
+     * Load 16 characters as bytes
+     *
+     * packus saturates signed 16-bit values, so UTF-16 code units from 0x100 to 0x7FFF
+     * become 0xFF and those from 0x8000 become 0x00; both bytes are invalid.
+     */
+    template <typename CharType>
+    FORCEINLINE __m128i LoadChars16(const CharType* Source)
+    {
+        if constexpr (sizeof(CharType) == 1)
+        {
+            return _mm_loadu_si128(reinterpret_cast<const __m128i*>(Source));
+        }
+        else
+        {
+            const __m128i Low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Source));
+            const __m128i High = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Source + 8));
+            return _mm_packus_epi16(Low, High);
+        }
+    }
+
+    /**
+     * Decode 16 characters into 12 bytes; writes 16 bytes at Dest
+     */
+    FORCEINLINE bool DecodeBlock16(__m128i Input, uint8* Dest)
+    {
+        // Per high nibble: offset from character to 6-bit value and which low nibbles are valid
+        const __m128i ShiftLUT = _mm_setr_epi8(0, 0, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+        const __m128i MaskLUT = _mm_setr_epi8(
+            (char)0xA8, (char)0xF8, (char)0xF8, (char)0xF8, (char)0xF8, (char)0xF8, (char)0xF8, (char)0xF8,
+            (char)0xF8, (char)0xF8, (char)0xF0, 0x54, 0x50, 0x50, 0x50, 0x54);
+        const __m128i BitPosLUT = _mm_setr_epi8(0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, (char)0x80, 0, 0, 0, 0, 0, 0, 0, 0);
+
+        const __m128i HigherNibble = _mm_and_si128(_mm_srli_epi32(Input, 4), _mm_set1_epi8(0x0F));
+        const __m128i LowerNibble = _mm_and_si128(Input, _mm_set1_epi8(0x0F));
+
+        // '/' shares its high nibble with '+' but needs a different offset
+        const __m128i IsSlash = _mm_cmpeq_epi8(Input, _mm_set1_epi8('/'));
+        const __m128i Shift = _mm_blendv_epi8(_mm_shuffle_epi8(ShiftLUT, HigherNibble), _mm_set1_epi8(16), IsSlash);
+
+        const __m128i Mask = _mm_shuffle_epi8(MaskLUT, LowerNibble);
+        const __m128i Bit = _mm_shuffle_epi8(BitPosLUT, HigherNibble);
+        const __m128i Invalid = _mm_cmpeq_epi8(_mm_and_si128(Mask, Bit), _mm_setzero_si128());
+        if (_mm_movemask_epi8(Invalid) != 0)
+        {
+            return false;
+        }
+
+        // Merge 6-bit values pairwise into 12 bits, then into 24 bits per 32-bit lane
+        const __m128i Values = _mm_add_epi8(Input, Shift);
+        const __m128i Merged12 = _mm_maddubs_epi16(Values, _mm_set1_epi32(0x01400140));
+        const __m128i Merged24 = _mm_madd_epi16(Merged12, _mm_set1_epi32(0x00011000));
+        const __m128i Packed = _mm_shuffle_epi8(Merged24, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(Dest), Packed);
+        return true;
+    }
+#endif
+
+#if PLATFORM_ALWAYS_HAS_AVX_2
+    /**
+     * Load 32 characters as bytes; UTF-16 code units above 255 become 0xFF or 0x00 as in LoadChars16
+     */
+    template <typename CharType>
+    FORCEINLINE __m256i LoadChars32(const CharType* Source)
+    {
+        if constexpr (sizeof(CharType) == 1)
+        {
+            return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(Source));
+        }
+        else
+        {
+            // packus works per 128-bit lane, so restore the character order afterwards
+            const __m256i Low = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(Source));
+            const __m256i High = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(Source + 16));
+            return _mm256_permute4x64_epi64(_mm256_packus_epi16(Low, High), 0xD8);
+        }
+    }
+
+    /**
+     * Decode 32 characters into 24 bytes; writes 32 bytes at Dest
+     */
+    FORCEINLINE bool DecodeBlock32(__m256i Input, uint8* Dest)
+    {
+        const __m256i ShiftLUT = _mm256_broadcastsi128_si256(_mm_setr_epi8(0, 0, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0));
+        const __m256i MaskLUT = _mm256_broadcastsi128_si256(_mm_setr_epi8(
+            (char)0xA8, (char)0xF8, (char)0xF8, (char)0xF8, (char)0xF8, (char)0xF8, (char)0xF8, (char)0xF8,
+            (char)0xF8, (char)0xF8, (char)0xF0, 0x54, 0x50, 0x50, 0x50, 0x54));
+        const __m256i BitPosLUT = _mm256_broadcastsi128_si256(_mm_setr_epi8(0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, (char)0x80, 0, 0, 0, 0, 0, 0, 0, 0));
+
+        const __m256i HigherNibble = _mm256_and_si256(_mm256_srli_epi32(Input, 4), _mm256_set1_epi8(0x0F));
+        const __m256i LowerNibble = _mm256_and_si256(Input, _mm256_set1_epi8(0x0F));
+
+        const __m256i IsSlash = _mm256_cmpeq_epi8(Input, _mm256_set1_epi8('/'));
+        const __m256i Shift = _mm256_blendv_epi8(_mm256_shuffle_epi8(ShiftLUT, HigherNibble), _mm256_set1_epi8(16), IsSlash);
+
+        const __m256i Mask = _mm256_shuffle_epi8(MaskLUT, LowerNibble);
+        const __m256i Bit = _mm256_shuffle_epi8(BitPosLUT, HigherNibble);
+        const __m256i Invalid = _mm256_cmpeq_epi8(_mm256_and_si256(Mask, Bit), _mm256_setzero_si256());
+        if (_mm256_movemask_epi8(Invalid) != 0)
+        {
+            return false;
+        }
+
+        const __m256i Values = _mm256_add_epi8(Input, Shift);
+        const __m256i Merged12 = _mm256_maddubs_epi16(Values, _mm256_set1_epi32(0x01400140));
+        const __m256i Merged24 = _mm256_madd_epi16(Merged12, _mm256_set1_epi32(0x00011000));
+        const __m256i PackedLanes = _mm256_shuffle_epi8(Merged24, _mm256_broadcastsi128_si256(
+            _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1)));
+
+        // Each lane holds 12 bytes; move them next to each other
+        const __m256i Packed = _mm256_permutevar8x32_epi32(PackedLanes, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(Dest), Packed);
+        return true;
+    }
+#endif
+
+    template <EDecodePath Path, typename CharType>
+    bool Decode(const CharType* Source, int32 Length, uint8* Dest, int32 DestSize, int32& OutDecodedSize)
+    {
+        SCOPE_CYCLE_COUNTER(STAT_MetaHumanBase64Decode);
+
+        OutDecodedSize = 0;
+        const int32 DecodedSize = GetDecodedSize(Source, Length);
+        if (DecodedSize == INDEX_NONE || DecodedSize > DestSize)
+        {
+            return false;
+        }
+        if (Length == 0)
+        {
+            return true;
+        }
+
+        // The last group may be padded, so the unpadded loops stop before it. The vector
+        // loops store a few bytes past their output, so they also stop short of DestSize.
+        const int32 BodyLength = Length - 4;
+        int32 SourceIndex = 0;
+        int32 DestIndex = 0;
+
+        if constexpr (sizeof(CharType) <= 2)
+        {
+#if PLATFORM_ALWAYS_HAS_AVX_2
+            while (Path == EDecodePath::AVX2 && SourceIndex + 32 <= BodyLength && DestIndex + 32 <= DestSize)
+            {
+                if (!DecodeBlock32(LoadChars32(Source + SourceIndex), Dest + DestIndex))
+                {
+                    return false;
+                }
+                SourceIndex += 32;
+                DestIndex += 24;
+            }
+#endif
+#if PLATFORM_ALWAYS_HAS_SSE4_1
+            while (Path != EDecodePath::Scalar && SourceIndex + 16 <= BodyLength && DestIndex + 16 <= DestSize)
+            {
+                if (!DecodeBlock16(LoadChars16(Source + SourceIndex), Dest + DestIndex))
+                {
+                    return false;
+                }
+                SourceIndex += 16;
+                DestIndex += 12;
+            }
+#endif
+        }
+
+        for (; SourceIndex < BodyLength; SourceIndex += 4, DestIndex += 3)
+        {
+            if (!DecodeQuad(Source + SourceIndex, Dest + DestIndex))
+            {
+                return false;
+            }
+        }
+
+        // Decode the last group, replacing padding with 'A' (value 0)
+        const int32 Padding = GetPadding(Source, Length);
+        CharType LastGroup[4] = { Source[BodyLength], Source[BodyLength + 1], Source[BodyLength + 2], Source[BodyLength + 3] };
+        for (int32 Index = 4 - Padding; Index < 4; Index++)
+        {
+            LastGroup[Index] = 'A';
+        }
+        uint8 LastBytes[3];
+        if (!DecodeQuad(LastGroup, LastBytes))
+        {
+            return false;
+        }
+        FMemory::Memcpy(Dest + DestIndex, LastBytes, 3 - Padding);
+
+        OutDecodedSize = DecodedSize;
+        return true;
+    }
+
+    template <typename CharType>
+    bool DecodeToArray(const CharType* Source, int32 Length, TArray<uint8>& OutData)
+    {
+        const int32 DecodedSize = GetDecodedSize(Source, Length);
+        if (DecodedSize == INDEX_NONE)
+        {
+            OutData.Reset();
+            return false;
+        }
+
+        int32 WrittenSize = 0;
+        OutData.SetNumUninitialized(DecodedSize);
+        if (!Decode<BestPath>(Source, Length, OutData.GetData(), OutData.Num(), WrittenSize))
+        {
+            OutData.Reset();
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * A decode path under test, for text and for UTF-8 bytes
+     */
+    struct FBenchmarkPath
+    {
+        const TCHAR* Name;
+        bool (*DecodeText)(const TCHAR*, int32, uint8*, int32, int32&);
+        bool (*DecodeBytes)(const uint8*, int32, uint8*, int32, int32&);
+    };
+
+    /**
+     * Get the decode paths this build can run
+     */
+    TArray<FBenchmarkPath> GetBenchmarkPaths()
+    {
+        TArray<FBenchmarkPath> Paths;
+        Paths.Add({ TEXT("scalar"), &Decode<EDecodePath::Scalar, TCHAR>, &Decode<EDecodePath::Scalar, uint8> });
+#if PLATFORM_ALWAYS_HAS_SSE4_1
+        Paths.Add({ TEXT("SSE4.1"), &Decode<EDecodePath::SSE41, TCHAR>, &Decode<EDecodePath::SSE41, uint8> });
+#endif
+#if PLATFORM_ALWAYS_HAS_AVX_2
+        Paths.Add({ TEXT("AVX2"), &Decode<EDecodePath::AVX2, TCHAR>, &Decode<EDecodePath::AVX2, uint8> });
+#endif
+        return Paths;
+    }
+
+    /**
+     * Check that a path decodes a case to the expected bytes, or rejects it when it should
+     */
+    template <typename CharType>
+    bool CheckCase(bool (*DecodeFunction)(const CharType*, int32, uint8*, int32, int32&), const CharType* Source, int32 Length, const TArray<uint8>* Expected)
+    {
+        const int32 DecodedSize = GetDecodedSize(Source, Length);
+        TArray<uint8> Decoded;
+        Decoded.SetNumZeroed(FMath::Max(DecodedSize, 0));
+        int32 WrittenSize = 0;
+        const bool bDecoded = DecodedSize != INDEX_NONE && DecodeFunction(Source, Length, Decoded.GetData(), Decoded.Num(), WrittenSize);
+        if (!Expected)
+        {
+            return !bDecoded;
+        }
+        return bDecoded && WrittenSize == Expected->Num() && FMemory::Memcmp(Decoded.GetData(), Expected->GetData(), WrittenSize) == 0;
+    }
+
+    /**
+     * Check every decode path against FBase64 and the source bytes, then log their throughput
+     */
+    void RunBenchmark(const TArray<FString>& Args)
+    {
+        const int32 NumCases = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 2000;
+        const int32 PayloadSize = Args.Num() > 1 ? FMath::Max(FCString::Atoi(*Args[1]), 1) : 1024 * 1024;
+        const TArray<FBenchmarkPath> Paths = GetBenchmarkPaths();
+        FRandomStream Random(0x6D68);
+
+        // Characters no base64 decoder accepts, including UTF-16 units packus turns into 0xFF and 0x00
+        const TCHAR InvalidChars[] = { TEXT('*'), TEXT('-'), TEXT(' '), TEXT('\0'), (TCHAR)0x00E9, (TCHAR)0x0141, (TCHAR)0x8000, (TCHAR)0xFFFF };
+
+        // Random lengths cover every padding and every mix of vector blocks and scalar tail
+        TArray<int32> Mismatches;
+        Mismatches.SetNumZeroed(Paths.Num() + 1);
+        for (int32 CaseIndex = 0; CaseIndex < NumCases; CaseIndex++)
+        {
+            TArray<uint8> Source;
+            Source.SetNumUninitialized(Random.RandRange(0, CaseIndex % 10 == 0 ? 4096 : 200));
+            for (uint8& Byte : Source)
+            {
+                Byte = (uint8)Random.RandRange(0, 255);
+            }
+            FString Text = FBase64::Encode(Source);
+
+            // A quarter of the cases get an invalid character, a few more lose their last character
+            const int32 CaseKind = Random.RandRange(0, 7);
+            bool bValid = true;
+            if (CaseKind < 2 && Text.Len() > 0)
+            {
+                Text[Random.RandRange(0, Text.Len() - 1)] = InvalidChars[Random.RandRange(0, UE_ARRAY_COUNT(InvalidChars) - 1)];
+                bValid = false;
+            }
+            else if (CaseKind == 2 && Text.Len() > 0)
+            {
+                Text.LeftChopInline(1, false);
+                bValid = false;
+            }
+            const TArray<uint8>* Expected = bValid ? &Source : nullptr;
+
+            // FBase64 only serves as a reference on valid text, since it reads other characters its own way
+            TArray<uint8> Reference;
+            if (bValid && (!FBase64::Decode(Text, Reference) || Reference != Source))
+            {
+                Mismatches[Paths.Num()]++;
+            }
+
+            // UTF-8 input cannot hold UTF-16 units, so non-ASCII characters become a single high byte
+            TArray<uint8> Utf8;
+            Utf8.SetNumUninitialized(Text.Len());
+            for (int32 Index = 0; Index < Text.Len(); Index++)
+            {
+                Utf8[Index] = Text[Index] < 128 ? (uint8)Text[Index] : (uint8)0xC3;
+            }
+
+            for (int32 PathIndex = 0; PathIndex < Paths.Num(); PathIndex++)
+            {
+                const bool bTextOk = CheckCase<TCHAR>(Paths[PathIndex].DecodeText, *Text, Text.Len(), Expected);
+                const bool bBytesOk = CheckCase<uint8>(Paths[PathIndex].DecodeBytes, Utf8.GetData(), Utf8.Num(), Expected);
+                if (!bTextOk || !bBytesOk)
+                {
+                    if (Mismatches[PathIndex]++ == 0)
+                    {
+                        UE_LOG(LogTemp, Error, TEXT("Base64 %s path mismatch (%s input) on %d characters: %s"),
+                            Paths[PathIndex].Name, bTextOk ? TEXT("UTF-8") : TEXT("text"), Text.Len(), *Text.Left(64));
+                    }
+                }
+            }
+        }
+
+        // Throughput on one large payload, like a long utterance's audio
+        TArray<uint8> Payload;
+        Payload.SetNumUninitialized(PayloadSize);
+        for (uint8& Byte : Payload)
+        {
+            Byte = (uint8)Random.RandRange(0, 255);
+        }
+        const FString PayloadText = FBase64::Encode(Payload);
+        const FTCHARToUTF8 PayloadUtf8(*PayloadText);
+        TArray<uint8> Decoded;
+        Decoded.SetNumUninitialized(PayloadSize);
+        const int32 NumRuns = FMath::Clamp(256 * 1024 * 1024 / PayloadSize, 1, 1000);
+        const double PayloadMB = PayloadSize / (1024.0 * 1024.0);
+
+        UE_LOG(LogTemp, Display, TEXT("Base64 benchmark: %d random cases, %d byte payload decoded %d times"), NumCases, PayloadSize, NumRuns);
+        double StartTime = FPlatformTime::Seconds();
+        for (int32 Run = 0; Run < NumRuns; Run++)
+        {
+            FBase64::Decode(PayloadText, Decoded);
+        }
+        const double ReferenceSeconds = (FPlatformTime::Seconds() - StartTime) / NumRuns;
+        UE_LOG(LogTemp, Display, TEXT("  %-8s text %8.1f MB/s                   %d mismatches"), TEXT("FBase64"), PayloadMB / ReferenceSeconds, Mismatches[Paths.Num()]);
+
+        for (int32 PathIndex = 0; PathIndex < Paths.Num(); PathIndex++)
+        {
+            int32 WrittenSize = 0;
+            StartTime = FPlatformTime::Seconds();
+            for (int32 Run = 0; Run < NumRuns; Run++)
+            {
+                Paths[PathIndex].DecodeText(*PayloadText, PayloadText.Len(), Decoded.GetData(), Decoded.Num(), WrittenSize);
+            }
+            const double TextSeconds = (FPlatformTime::Seconds() - StartTime) / NumRuns;
+
+            StartTime = FPlatformTime::Seconds();
+            for (int32 Run = 0; Run < NumRuns; Run++)
+            {
+                Paths[PathIndex].DecodeBytes(reinterpret_cast<const uint8*>(PayloadUtf8.Get()), PayloadUtf8.Length(), Decoded.GetData(), Decoded.Num(), WrittenSize);
+            }
+            const double BytesSeconds = (FPlatformTime::Seconds() - StartTime) / NumRuns;
+
+            UE_LOG(LogTemp, Display, TEXT("  %-8s text %8.1f MB/s, UTF-8 %8.1f MB/s (%.1fx FBase64), %d mismatches"),
+                Paths[PathIndex].Name, PayloadMB / TextSeconds, PayloadMB / BytesSeconds, ReferenceSeconds / TextSeconds, Mismatches[PathIndex]);
+        }
+    }
+
+    FAutoConsoleCommand Base64BenchmarkCommand(
+        TEXT("MetaHuman.Base64Benchmark"),
+        TEXT("Check the scalar and vector base64 paths against FBase64 on random lengths, padding and invalid characters, and log their decode throughput. Args: [Cases=2000] [PayloadBytes=1048576]"),
+        FConsoleCommandWithArgsDelegate::CreateStatic(&RunBenchmark));
+}
+
+int32 FMetaHumanBase64::GetDecodedSize(TConstArrayView<uint8> Source)
+{
+    return MetaHumanBase64::GetDecodedSize(Source.GetData(), Source.Num());
+}
+
+int32 FMetaHumanBase64::GetDecodedSize(FStringView Source)
+{
+    return MetaHumanBase64::GetDecodedSize(Source.GetData(), Source.Len());
+}
+
+bool FMetaHumanBase64::Decode(TConstArrayView<uint8> Source, TArrayView<uint8> Dest, int32& OutDecodedSize)
+{
+    return MetaHumanBase64::Decode<MetaHumanBase64::BestPath>(Source.GetData(), Source.Num(), Dest.GetData(), Dest.Num(), OutDecodedSize);
+}
+
+bool FMetaHumanBase64::Decode(FStringView Source, TArrayView<uint8> Dest, int32& OutDecodedSize)
+{
+    return MetaHumanBase64::Decode<MetaHumanBase64::BestPath>(Source.GetData(), Source.Len(), Dest.GetData(), Dest.Num(), OutDecodedSize);
+}
+
+bool FMetaHumanBase64::Decode(TConstArrayView<uint8> Source, TArray<uint8>& OutData)
+{
+    return MetaHumanBase64::DecodeToArray(Source.GetData(), Source.Num(), OutData);
+}
+
+bool FMetaHumanBase64::Decode(FStringView Source, TArray<uint8>& OutData)
+{
+    return MetaHumanBase64::DecodeToArray(Source.GetData(), Source.Len(), OutData);
+}
@@ -0,0 +1,117 @@
+/**
+ * MetaHumanBinaryMessage.cpp
+ *
+ * Implementation of FMetaHumanBinaryMessage, which reads and writes the header of binary
+ * WebSocket messages.
+ */
+
+#include "MetaHumanBinaryMessage.h"
+
+namespace MetaHumanBinaryMessage
+{
+    template <typename T>
+    T ReadAt(const uint8* Data, int32 Offset)
+    {
+        T Value;
+        FMemory::Memcpy(&Value, Data + Offset, sizeof(T));
+        return Value;
+    }
+
+    template <typename T>
+    void Write(TArray<uint8>& OutData, const T& Value)
+    {
+        OutData.Append(reinterpret_cast<const uint8*>(&Value), sizeof(T));
+    }
+}
+
+bool FMetaHumanBinaryMessage::Decode(TConstArrayView<uint8> Data, FMetaHumanBinaryMessageView& OutView)
+{
+    using namespace MetaHumanBinaryMessage;
+
+    if (Data.Num() < HeaderSize)
+    {
+        UE_LOG(LogTemp, Error, TEXT("Binary message is shorter than its header (%d bytes)"), Data.Num());
+        return false;
+    }
+
+    const uint8* Header = Data.GetData();
+    const uint32 MessageMagic = ReadAt<uint32>(Header, 0);
+    const uint8 MessageVersion = ReadAt<uint8>(Header, 4);
+    const uint8 TypeValue = ReadAt<uint8>(Header, 5);
+    const uint8 CodecValue = ReadAt<uint8>(Header, 6);
+    if (MessageMagic != Magic || MessageVersion != Version)
+    {
+        UE_LOG(LogTemp, Error, TEXT("Unsupported binary message (magic 0x%08x, version %d)"), MessageMagic, MessageVersion);
+        return false;
+    }
+    if (TypeValue > (uint8)EMetaHumanIngestMessageType::Interrupt)
+    {
+        UE_LOG(LogTemp, Error, TEXT("Unknown binary message type: %d"), TypeValue);
+        return false;
+    }
+
+    if (CodecValue > (uint8)EMetaHumanAudioCodec::Opus)
+    {
+        UE_LOG(LogTemp, Error, TEXT("Unknown binary message audio codec: %d"), CodecValue);
+        return false;
+    }
+
+    OutView.Type = (EMetaHumanIngestMessageType)TypeValue;
+    OutView.AudioCodec = (EMetaHumanAudioCodec)CodecValue;
+    OutView.Sequence = ReadAt<int32>(Header, 8);
+    OutView.SampleRate = (int32)ReadAt<uint32>(Header, 12);
+    OutView.Timestamp = ReadAt<double>(Header, 16);
+    OutView.NumChannels = ReadAt<uint16>(Header, 24);
+    OutView.Character = ReadAt<uint16>(Header, 26);
+    OutView.FrameRate = ReadAt<float>(Header, 28);
+
+    // Both sections must fit in the message
+    const uint32 AudioSize = ReadAt<uint32>(Header, 32);
+    const uint32 BlendshapeSize = ReadAt<uint32>(Header, 36);
+    if ((int64)HeaderSize + AudioSize + BlendshapeSize > Data.Num())
+    {
+        UE_LOG(LogTemp, Error, TEXT("Binary message is truncated (%u audio bytes, %u blendshape bytes, %d total)"), AudioSize, BlendshapeSize, Data.Num());
+        return false;
+    }
+
+    OutView.AudioOffset = HeaderSize;
+    OutView.AudioSize = (int32)AudioSize;
+    OutView.Blendshapes = Data.Slice(HeaderSize + AudioSize, BlendshapeSize);
+    return true;
+}
+
+bool FMetaHumanBinaryMessage::Encode(const FMetaHumanBinaryMessageView& View, TConstArrayView<uint8> Audio, TConstArrayView<uint8> Blendshapes, TArray<uint8>& OutData)
+{
+    using namespace MetaHumanBinaryMessage;
+
+    OutData.Reset();
+
+    if (View.NumChannels < 0 || View.NumChannels > MAX_uint16 || View.SampleRate < 0)
+    {
+        UE_LOG(LogTemp, Error, TEXT("Cannot encode binary message with %d Hz, %d channels"), View.SampleRate, View.NumChannels);
+        return false;
+    }
+
+    OutData.Reserve(HeaderSize + Audio.Num() + Blendshapes.Num());
+
+    // Write the fixed header
+    Write(OutData, Magic);
+    Write(OutData, Version);
+    Write(OutData, (uint8)View.Type);
+    Write(OutData, (uint8)View.AudioCodec);
+    Write(OutData, (uint8)0);
+    Write(OutData, View.Sequence);
+    Write(OutData, (uint32)View.SampleRate);
+    Write(OutData, View.Timestamp);
+    Write(OutData, (uint16)View.NumChannels);
+    Write(OutData, View.Character);
+    Write(OutData, View.FrameRate);
+    Write(OutData, (uint32)Audio.Num());
+    Write(OutData, (uint32)Blendshapes.Num());
+    check(OutData.Num() == HeaderSize);
+
+    // Write the sections
+    OutData.Append(Audio.GetData(), Audio.Num());
+    OutData.Append(Blendshapes.GetData(), Blendshapes.Num());
+    return true;
+}
@@ -0,0 +1,101 @@
+/**
+ * MetaHumanBinaryMessage.h
+ *
+ * This header file defines FMetaHumanBinaryMessage, the binary WebSocket message format
+ * that carries raw audio and binary blendshapes without base64 or JSON text.
+ *
+ * Libraries/Modules used:
+ * - CoreMinimal.h: Core Unreal Engine functionality
+ *
+ * Binary layout (all values little-endian):
+ * - Header (40 bytes):
+ *   - uint32 Magic            'MHMS'
+ *   - uint8  Version          Format version (currently 1)
+ *   - uint8  Type             EMetaHumanIngestMessageType
+ *   - uint8  AudioCodec       EMetaHumanAudioCodec of the stream's chunks (stream_start)
+ *   - uint8  Reserved         Must be zero
+ *   - int32  Sequence         Chunk sequence number (stream_chunk)
+ *   - uint32 SampleRate       Audio sample rate (stream_start)
+ *   - double Timestamp        Chunk stream time in seconds (stream_chunk)
+ *   - uint16 NumChannels      Audio channel count (stream_start)
+ *   - uint16 Character        Character the message is addressed to; 0 for the default character
+ *   - float  FrameRate        Blendshape frame rate (stream_start)
+ *   - uint32 AudioSize        Size of the audio section in bytes
+ *   - uint32 BlendshapeSize   Size of the blendshape section in bytes
+ * - Audio section: the utterance audio, or the chunk's 16-bit PCM or Opus packets, as raw bytes.
+ * - Blendshape section: a binary blendshape payload (see MetaHumanBlendshapeCodec.h).
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MetaHumanIngestPipeline.h"
+
+/**
+ * Decoded header of a binary message, with views into the message's sections
+ */
+struct FMetaHumanBinaryMessageView
+{
+    // Kind of message
+    EMetaHumanIngestMessageType Type = EMetaHumanIngestMessageType::Utterance;
+
+    // Character the message is addressed to; 0 for the default character
+    uint16 Character = 0;
+
+    // Stream chunk sequence number and timestamp
+    int32 Sequence = 0;
+    double Timestamp = 0.0;
+
+    // Stream format
+    int32 SampleRate = 0;
+    int32 NumChannels = 1;
+    float FrameRate = 0.0f;
+    EMetaHumanAudioCodec AudioCodec = EMetaHumanAudioCodec::PCM;
+
+    // Offset and size of the audio section within the message
+    int32 AudioOffset = 0;
+    int32 AudioSize = 0;
+
+    // Blendshape section, viewing the message bytes
+    TConstArrayView<uint8> Blendshapes;
+};
+
+/**
+ * Encoder/decoder for binary WebSocket messages
+ */
+class METAHUMANSTREAMING_API FMetaHumanBinaryMessage
+{
+public:
+    // Magic number at the start of every binary message ('MHMS' in little-endian byte order)
+    static constexpr uint32 Magic = 0x534D484D;
+
+    // Current version of the binary format
+    static constexpr uint8 Version = 1;
+
+    // Size of the fixed header in bytes
+    static constexpr int32 HeaderSize = 40;
+
+    /**
+     * Decode the header of a binary message
+     *
+     * No bytes are copied; the sections are returned as offsets and views into Data.
+     *
+     * @param Data - The complete message
+     * @param OutView - Receives the header fields and section locations
+     * @return bool - True if the header is valid and the sections fit in the message
+     */
+    static bool Decode(TConstArrayView<uint8> Data, FMetaHumanBinaryMessageView& OutView);
+
+    /**
+     * Encode a binary message
+     *
+     * This is used by test harnesses and tools that need to produce binary messages.
+     *
+     * @param View - Header fields; the section locations are ignored
+     * @param Audio - Audio section
+     * @param Blendshapes - Blendshape section
+     * @param OutData - Receives the message
+     * @return bool - True if the message could be encoded
+     */
+    static bool Encode(const FMetaHumanBinaryMessageView& View, TConstArrayView<uint8> Audio, TConstArrayView<uint8> Blendshapes, TArray<uint8>& OutData);
+};
@@ -0,0 +1,605 @@
+/**
+ * MetaHumanBlendshapeCodec.cpp
+ *
+ * Implementation of FMetaHumanBlendshapeCodec, which converts blendshape animation
+ * between FBlendshapeTimeline and a compact binary wire format, and of the
+ * MetaHuman.BlendshapeCodecReport and MetaHuman.BlendshapeParseBenchmark console commands.
+ */
+
+#include "MetaHumanBlendshapeCodec.h"
+#include "MetaHumanBlendshapeTimeline.h"
+#include "MetaHumanMessageParser.h"
+#include "MetaHumanIngestPipeline.h"
+#include "MetaHumanStreamingStats.h"
+#include "Math/Float16.h"
+#include "Misc/FileHelper.h"
+#include "HAL/IConsoleManager.h"
+#include "Serialization/JsonSerializer.h"
+#include "Dom/JsonObject.h"
+
+DECLARE_CYCLE_STAT(TEXT("Blendshape Decode"), STAT_MetaHumanBlendshapeDecode, STATGROUP_MetaHumanStreaming);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Blendshape Compression Ratio"), STAT_MetaHumanBlendshapeCompression, STATGROUP_MetaHumanStreaming);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Blendshape Decode (M samples/s)"), STAT_MetaHumanBlendshapeThroughput, STATGROUP_MetaHumanStreaming);
+
+namespace MetaHumanBlendshapeCodec
+{
+    // Maximum length of a channel name in the channel table
+    constexpr int32 MaxChannelNameLength = 255;
+
+    /**
+     * Bounds-checked little-endian reader over a byte buffer
+     */
+    struct FByteCursor
+    {
+        const uint8* Data;
+        int32 Size;
+        int32 Offset;
+
+        bool CanRead(int32 NumBytes) const
+        {
+            return NumBytes >= 0 && Offset + NumBytes <= Size;
+        }
+
+        template <typename T>
+        bool Read(T& OutValue)
+        {
+            if (!CanRead(sizeof(T)))
+            {
+                return false;
+            }
+            FMemory::Memcpy(&OutValue, Data + Offset, sizeof(T));
+            Offset += sizeof(T);
+            return true;
+        }
+    };
+
+    template <typename T>
+    void Write(TArray<uint8>& OutData, const T& Value)
+    {
+        OutData.Append(reinterpret_cast<const uint8*>(&Value), sizeof(T));
+    }
+
+    bool IsQuantized(EBlendshapeSampleFormat SampleFormat)
+    {
+        return SampleFormat == EBlendshapeSampleFormat::Quantized8 || SampleFormat == EBlendshapeSampleFormat::Quantized12;
+    }
+
+    /**
+     * Get the size of a sample, or the smallest size for the varint formats
+     */
+    int32 GetSampleSize(EBlendshapeSampleFormat SampleFormat)
+    {
+        switch (SampleFormat)
+        {
+        case EBlendshapeSampleFormat::Float16:
+            return sizeof(FFloat16);
+        case EBlendshapeSampleFormat::Quantized8:
+        case EBlendshapeSampleFormat::Quantized12:
+            return 1;
+        case EBlendshapeSampleFormat::Float32:
+        default:
+            return sizeof(float);
+        }
+    }
+
+    /**
+     * Get the largest quantized value of a quantized format
+     */
+    int32 GetQuantizedMax(EBlendshapeSampleFormat SampleFormat)
+    {
+        return SampleFormat == EBlendshapeSampleFormat::Quantized12 ? 4095 : 255;
+    }
+
+    FORCEINLINE int32 ZigZagDecode(uint32 Value)
+    {
+        return (int32)(Value >> 1) ^ -(int32)(Value & 1);
+    }
+
+    FORCEINLINE uint32 ZigZagEncode(int32 Value)
+    {
+        return ((uint32)Value << 1) ^ (uint32)(Value >> 31);
+    }
+
+    void WriteVarint(TArray<uint8>& OutData, uint32 Value)
+    {
+        while (Value >= 0x80)
+        {
+            OutData.Add((uint8)(Value | 0x80));
+            Value >>= 7;
+        }
+        OutData.Add((uint8)Value);
+    }
+
+    FORCEINLINE bool ReadVarint(FByteCursor& Cursor, uint32& OutValue)
+    {
+        OutValue = 0;
+        for (int32 Shift = 0; Shift < 32; Shift += 7)
+        {
+            if (Cursor.Offset >= Cursor.Size)
+            {
+                return false;
+            }
+            const uint8 Byte = Cursor.Data[Cursor.Offset++];
+            OutValue |= (uint32)(Byte & 0x7F) << Shift;
+            if (Byte < 0x80)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * Unpack quantized, delta-coded rows into a weight matrix
+     *
+     * Runs of eight single-byte varints are unpacked together, and the running quantized
+     * values are accumulated and dequantized four channels per vector instruction.
+     */
+    bool DecodeQuantizedRows(FByteCursor& Cursor, int32 NumChannels, int32 NumFrames, int32 QuantizedMax, float* OutWeights)
+    {
+        constexpr uint64 ContinuationBits = 0x8080808080808080ull;
+
+        TArray<int32> Accumulator;
+        TArray<int32> Deltas;
+        Accumulator.SetNumZeroed(NumChannels);
+        Deltas.SetNumUninitialized(NumChannels);
+        int32* AccumulatorData = Accumulator.GetData();
+        int32* DeltaData = Deltas.GetData();
+
+        const VectorRegister4Float Scale = VectorSetFloat1(1.0f / QuantizedMax);
+        const VectorRegister4Float Zero = GlobalVectorConstants::FloatZero;
+        const VectorRegister4Float One = GlobalVectorConstants::FloatOne;
+
+        for (int32 FrameIndex = 0; FrameIndex < NumFrames; FrameIndex++)
+        {
+            // Unpack the row's deltas; smooth motion makes nearly all of them one byte long
+            int32 ChannelIndex = 0;
+            while (ChannelIndex < NumChannels)
+            {
+                uint64 Word;
+                if (ChannelIndex + 8 <= NumChannels && Cursor.CanRead(sizeof(Word)))
+                {
+                    FMemory::Memcpy(&Word, Cursor.Data + Cursor.Offset, sizeof(Word));
+                    if ((Word & ContinuationBits) == 0)
+                    {
+                        for (int32 ByteIndex = 0; ByteIndex < 8; ByteIndex++)
+                        {
+                            DeltaData[ChannelIndex + ByteIndex] = ZigZagDecode((uint32)(Word >> (ByteIndex * 8)) & 0xFF);
+                        }
+                        ChannelIndex += 8;
+                        Cursor.Offset += sizeof(Word);
+                        continue;
+                    }
+                }
+
+                uint32 Value;
+                if (!ReadVarint(Cursor, Value))
+                {
+                    return false;
+                }
+                DeltaData[ChannelIndex++] = ZigZagDecode(Value);
+            }
+
+            // Accumulate and dequantize four channels at a time
+            float* Row = OutWeights + (int64)FrameIndex * NumChannels;
+            ChannelIndex = 0;
+            for (; ChannelIndex + 4 <= NumChannels; ChannelIndex += 4)
+            {
+                const VectorRegister4Int Sum = VectorIntAdd(VectorIntLoad(AccumulatorData + ChannelIndex), VectorIntLoad(DeltaData + ChannelIndex));
+                VectorIntStore(Sum, AccumulatorData + ChannelIndex);
+                const VectorRegister4Float Weight = VectorMultiply(VectorIntToFloat(Sum), Scale);
+                VectorStore(VectorMin(VectorMax(Weight, Zero), One), Row + ChannelIndex);
+            }
+            for (; ChannelIndex < NumChannels; ChannelIndex++)
+            {
+                AccumulatorData[ChannelIndex] += DeltaData[ChannelIndex];
+                Row[ChannelIndex] = FMath::Clamp(AccumulatorData[ChannelIndex] / (float)QuantizedMax, 0.0f, 1.0f);
+            }
+        }
+
+        return true;
+    }
+
+    /**
+     * Encode a recorded session in every sample format and log the results
+     */
+    void RunCodecReport(const TArray<FString>& Args)
+    {
+        if (Args.Num() < 1)
+        {
+            UE_LOG(LogTemp, Display, TEXT("Usage: MetaHuman.BlendshapeCodecReport <binary payload or blendshape JSON file>"));
+            return;
+        }
+
+        // Load the session from a binary payload or from the JSON the backend sends
+        TArray<uint8> FileData;
+        if (!FFileHelper::LoadFileToArray(FileData, *Args[0]))
+        {
+            UE_LOG(LogTemp, Error, TEXT("Failed to read %s"), *Args[0]);
+            return;
+        }
+        FBlendshapeTimeline Session;
+        if (FMetaHumanBlendshapeCodec::IsBinaryPayload(FileData))
+        {
+            FMetaHumanBlendshapeCodec::Decode(FileData, Session);
+        }
+        else
+        {
+            FString Json;
+            FFileHelper::BufferToString(Json, FileData.GetData(), FileData.Num());
+            FMetaHumanMessageParser::ParseBlendshapes(Json, 60.0f, Session);
+        }
+        if (Session.IsEmpty())
+        {
+            UE_LOG(LogTemp, Error, TEXT("%s holds no blendshape frames"), *Args[0]);
+            return;
+        }
+
+        UE_LOG(LogTemp, Display, TEXT("Blendshape session %s: %d frames x %d channels at %.1f fps (%d bytes on disk)"),
+            *Args[0], Session.GetNumFrames(), Session.GetNumChannels(), Session.FrameRate, FileData.Num());
+
+        const EBlendshapeSampleFormat Formats[] = { EBlendshapeSampleFormat::Float32, EBlendshapeSampleFormat::Float16, EBlendshapeSampleFormat::Quantized12, EBlendshapeSampleFormat::Quantized8 };
+        const TCHAR* FormatNames[] = { TEXT("float32"), TEXT("float16"), TEXT("12-bit delta"), TEXT("8-bit delta") };
+        const double RawSize = (double)Session.Weights.Num() * sizeof(float);
+        for (int32 FormatIndex = 0; FormatIndex < UE_ARRAY_COUNT(Formats); FormatIndex++)
+        {
+            TArray<uint8> Payload;
+            FBlendshapeTimeline Decoded;
+            if (!FMetaHumanBlendshapeCodec::Encode(Session, Formats[FormatIndex], Payload))
+            {
+                continue;
+            }
+
+            // Decode repeatedly so short sessions still give a stable throughput
+            const int32 NumRuns = FMath::Clamp(10000000 / FMath::Max(Session.Weights.Num(), 1), 1, 1000);
+            const double StartTime = FPlatformTime::Seconds();
+            for (int32 Run = 0; Run < NumRuns; Run++)
+            {
+                FMetaHumanBlendshapeCodec::Decode(Payload, Decoded);
+            }
+            const double DecodeSeconds = (FPlatformTime::Seconds() - StartTime) / NumRuns;
+
+            float MaxError = 0.0f;
+            for (int32 SampleIndex = 0; SampleIndex < Session.Weights.Num(); SampleIndex++)
+            {
+                MaxError = FMath::Max(MaxError, FMath::Abs(FMath::Clamp(Session.Weights[SampleIndex], 0.0f, 1.0f) - Decoded.Weights[SampleIndex]));
+            }
+
+            UE_LOG(LogTemp, Display, TEXT("  %-12s %9d bytes, %6.2fx vs float32, %7.1fx vs file, decode %8.1f M samples/s, max error %.5f"),
+                FormatNames[FormatIndex], Payload.Num(), RawSize / Payload.Num(), (double)FileData.Num() / Payload.Num(),
+                Session.Weights.Num() / DecodeSeconds / 1.0e6, MaxError);
+        }
+    }
+
+    FAutoConsoleCommand CodecReportCommand(
+        TEXT("MetaHuman.BlendshapeCodecReport"),
+        TEXT("Encode a recorded blendshape session in every sample format and log size, compression ratio, decode throughput and error. Args: <File>"),
+        FConsoleCommandWithArgsDelegate::CreateStatic(&RunCodecReport));
+
+    /**
+     * Build a stream_chunk message of synthetic JSON blendshape frames
+     */
+    FString MakeParseBenchmarkMessage(int32 NumFrames, int32 NumChannels, float FrameRate, bool bFramesArray)
+    {
+        FString Message;
+        Message.Reserve(NumFrames * NumChannels * 24);
+        Message += TEXT("{\"type\": \"stream_chunk\", \"sequence\": 0, \"timestamp\": 0, \"blendshapes\": ");
+        Message += bFramesArray ? TEXT("[") : TEXT("{\"frames\": [");
+        for (int32 FrameIndex = 0; FrameIndex < NumFrames; FrameIndex++)
+        {
+            Message += FString::Printf(TEXT("%s{\"time\": %.4f, \"blendshapes\": {"), FrameIndex > 0 ? TEXT(", ") : TEXT(""), FrameIndex / FrameRate);
+            for (int32 ChannelIndex = 0; ChannelIndex < NumChannels; ChannelIndex++)
+            {
+                const float Weight = 0.5f + 0.5f * FMath::Sin(FrameIndex * 0.1f + ChannelIndex);
+                Message += FString::Printf(TEXT("%s\"blendshape%03d\": %.6f"), ChannelIndex > 0 ? TEXT(", ") : TEXT(""), ChannelIndex, Weight);
+            }
+            Message += TEXT("}}");
+        }
+        Message += bFramesArray ? TEXT("]}") : TEXT("]}}");
+        return Message;
+    }
+
+    /**
+     * Decode the blendshapes the way the receiver did before the single-pass parser: parse the
+     * message, serialize its blendshapes object back to text and parse that text again
+     */
+    bool DecodeByReparse(const FString& Message, float FrameRate, FBlendshapeTimeline& OutTimeline)
+    {
+        TSharedPtr<FJsonObject> MessageObject;
+        const TSharedPtr<FJsonObject>* BlendshapesObject = nullptr;
+        if (!FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(Message), MessageObject) ||
+            !MessageObject->TryGetObjectField(TEXT("blendshapes"), BlendshapesObject))
+        {
+            return false;
+        }
+
+        FString BlendshapeJSON;
+        TSharedPtr<FJsonObject> ReparsedObject;
+        const TArray<TSharedPtr<FJsonValue>>* FramesArray = nullptr;
+        if (!FJsonSerializer::Serialize(BlendshapesObject->ToSharedRef(), TJsonWriterFactory<>::Create(&BlendshapeJSON)) ||
+            !FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(BlendshapeJSON), ReparsedObject) ||
+            !ReparsedObject->TryGetArrayField(TEXT("frames"), FramesArray))
+        {
+            return false;
+        }
+
+        OutTimeline.Reset(TArray<FString>(), FrameRate, FramesArray->Num());
+        for (const TSharedPtr<FJsonValue>& FrameValue : *FramesArray)
+        {
+            const TSharedPtr<FJsonObject>& Values = FrameValue->AsObject()->GetObjectField(TEXT("blendshapes"));
+            for (const TPair<FString, TSharedPtr<FJsonValue>>& Pair : Values->Values)
+            {
+                if (OutTimeline.FindChannel(Pair.Key) == INDEX_NONE)
+                {
+                    OutTimeline.AddChannel(Pair.Key);
+                }
+            }
+            TArrayView<float> Row = OutTimeline.AddFrame();
+            for (const TPair<FString, TSharedPtr<FJsonValue>>& Pair : Values->Values)
+            {
+                Row[OutTimeline.FindChannel(Pair.Key)] = Pair.Value->AsNumber();
+            }
+        }
+        return true;
+    }
+
+    /**
+     * Time the reparse, DOM and single-pass decoding of 10, 20 and 30 s of JSON blendshapes
+     */
+    void RunParseBenchmark(const TArray<FString>& Args)
+    {
+        const int32 NumChannels = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 52;
+        const float FrameRate = Args.Num() > 1 ? FMath::Max(FCString::Atof(*Args[1]), 1.0f) : 60.0f;
+        const int32 NumRuns = 5;
+
+        for (const int32 Seconds : { 10, 20, 30 })
+        {
+            const int32 NumFrames = FMath::RoundToInt(Seconds * FrameRate);
+            const FString Message = MakeParseBenchmarkMessage(NumFrames, NumChannels, FrameRate, false);
+
+            FBlendshapeTimeline ReparseTimeline;
+            double StartTime = FPlatformTime::Seconds();
+            for (int32 Run = 0; Run < NumRuns; Run++)
+            {
+                DecodeByReparse(Message, FrameRate, ReparseTimeline);
+            }
+            const double ReparseSeconds = (FPlatformTime::Seconds() - StartTime) / NumRuns;
+
+            FMetaHumanIngestResult DomResult;
+            StartTime = FPlatformTime::Seconds();
+            for (int32 Run = 0; Run < NumRuns; Run++)
+            {
+                TSharedPtr<FJsonObject> MessageObject;
+                DomResult = FMetaHumanIngestResult();
+                if (FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(Message), MessageObject))
+                {
+                    FMetaHumanIngestPipeline::DecodeMessageObject(MessageObject, FrameRate, DomResult);
+                }
+            }
+            const double DomSeconds = (FPlatformTime::Seconds() - StartTime) / NumRuns;
+
+            FMetaHumanIngestResult SinglePassResult;
+            StartTime = FPlatformTime::Seconds();
+            for (int32 Run = 0; Run < NumRuns; Run++)
+            {
+                SinglePassResult = FMetaHumanIngestResult();
+                FMetaHumanIngestPipeline::DecodeMessage(Message, FrameRate, SinglePassResult);
+            }
+            const double SinglePassSeconds = (FPlatformTime::Seconds() - StartTime) / NumRuns;
+
+            // Every path must read the same frames, and the DOM and single-pass paths must read the bare frames array too
+            FMetaHumanIngestResult DomArrayResult;
+            FMetaHumanIngestResult SinglePassArrayResult;
+            const FString ArrayMessage = MakeParseBenchmarkMessage(NumFrames, NumChannels, FrameRate, true);
+            TSharedPtr<FJsonObject> ArrayMessageObject;
+            if (FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(ArrayMessage), ArrayMessageObject))
+            {
+                FMetaHumanIngestPipeline::DecodeMessageObject(ArrayMessageObject, FrameRate, DomArrayResult);
+            }
+            FMetaHumanIngestPipeline::DecodeMessage(ArrayMessage, FrameRate, SinglePassArrayResult);
+            const bool bMatch = ReparseTimeline.GetNumFrames() == NumFrames &&
+                ReparseTimeline.Weights == DomResult.BlendshapeTimeline.Weights &&
+                ReparseTimeline.Weights == SinglePassResult.BlendshapeTimeline.Weights &&
+                ReparseTimeline.Weights == DomArrayResult.BlendshapeTimeline.Weights &&
+                ReparseTimeline.Weights == SinglePassArrayResult.BlendshapeTimeline.Weights;
+
+            UE_LOG(LogTemp, Display, TEXT("Blendshape parse %d s (%d frames x %d channels, %.1f MB of JSON): reparse %.1f ms, DOM %.1f ms (%.1fx), single pass %.1f ms (%.1fx)%s"),
+                Seconds, NumFrames, NumChannels, Message.Len() * sizeof(TCHAR) / (1024.0 * 1024.0),
+                ReparseSeconds * 1000.0, DomSeconds * 1000.0, ReparseSeconds / DomSeconds, SinglePassSeconds * 1000.0, ReparseSeconds / SinglePassSeconds,
+                bMatch ? TEXT("") : TEXT(", RESULTS DIFFER"));
+        }
+    }
+
+    FAutoConsoleCommand ParseBenchmarkCommand(
+        TEXT("MetaHuman.BlendshapeParseBenchmark"),
+        TEXT("Decode 10, 20 and 30 s of JSON blendshapes by reserializing and reparsing the DOM, from the DOM directly and in a single pass, and log the time of each. Args: [Channels=52] [FrameRate=60]"),
+        FConsoleCommandWithArgsDelegate::CreateStatic(&RunParseBenchmark));
+}
+
+bool FMetaHumanBlendshapeCodec::IsBinaryPayload(TConstArrayView<uint8> Data)
+{
+    uint32 PayloadMagic = 0;
+    if (Data.Num() < (int32)sizeof(PayloadMagic))
+    {
+        return false;
+    }
+    FMemory::Memcpy(&PayloadMagic, Data.GetData(), sizeof(PayloadMagic));
+    return PayloadMagic == Magic;
+}
+
+bool FMetaHumanBlendshapeCodec::Decode(TConstArrayView<uint8> Data, FBlendshapeTimeline& OutTimeline)
+{
+    using namespace MetaHumanBlendshapeCodec;
+
+    SCOPE_CYCLE_COUNTER(STAT_MetaHumanBlendshapeDecode);
+    const double StartTime = FPlatformTime::Seconds();
+
+    // Read the fixed header
+    FByteCursor Cursor{ Data.GetData(), Data.Num(), 0 };
+    uint32 PayloadMagic = 0;
+    uint16 PayloadVersion = 0;
+    uint8 SampleFormatValue = 0;
+    uint8 Reserved8 = 0;
+    uint16 NumChannels = 0;
+    uint16 Reserved16 = 0;
+    uint32 NumFrames = 0;
+    float PayloadFrameRate = 0.0f;
+
+    if (!Cursor.Read(PayloadMagic) || !Cursor.Read(PayloadVersion) || !Cursor.Read(SampleFormatValue) ||
+        !Cursor.Read(Reserved8) || !Cursor.Read(NumChannels) || !Cursor.Read(Reserved16) ||
+        !Cursor.Read(NumFrames) || !Cursor.Read(PayloadFrameRate))
+    {
+        UE_LOG(LogTemp, Error, TEXT("Binary blendshape payload is shorter than its header"));
+        return false;
+    }
+
+    if (PayloadMagic != Magic || PayloadVersion != Version)
+    {
+        UE_LOG(LogTemp, Error, TEXT("Unsupported binary blendshape payload (magic 0x%08x, version %d)"), PayloadMagic, PayloadVersion);
+        return false;
+    }
+
+    if (SampleFormatValue > (uint8)EBlendshapeSampleFormat::Quantized12 || PayloadFrameRate <= 0.0f)
+    {
+        UE_LOG(LogTemp, Error, TEXT("Invalid binary blendshape header (format %d, frame rate %f)"), SampleFormatValue, PayloadFrameRate);
+        return false;
+    }
+
+    const EBlendshapeSampleFormat SampleFormat = (EBlendshapeSampleFormat)SampleFormatValue;
+
+    // Read the channel table
+    TArray<FString> ChannelNames;
+    ChannelNames.Reserve(NumChannels);
+    for (int32 ChannelIndex = 0; ChannelIndex < NumChannels; ChannelIndex++)
+    {
+        uint8 NameLength = 0;
+        if (!Cursor.Read(NameLength) || !Cursor.CanRead(NameLength))
+        {
+            UE_LOG(LogTemp, Error, TEXT("Binary blendshape channel table is truncated"));
+            return false;
+        }
+
+        FUTF8ToTCHAR NameConverter(reinterpret_cast<const ANSICHAR*>(Cursor.Data + Cursor.Offset), NameLength);
+        ChannelNames.Emplace(NameConverter.Length(), NameConverter.Get());
+        Cursor.Offset += NameLength;
+    }
+
+    // Make sure all rows are present before allocating frames (varint rows take at least a byte per sample)
+    const int64 NumSamples = (int64)NumChannels * NumFrames;
+    if ((int64)Cursor.Offset + NumSamples * GetSampleSize(SampleFormat) > Cursor.Size)
+    {
+        UE_LOG(LogTemp, Error, TEXT("Binary blendshape payload is missing frame data (%u frames expected)"), NumFrames);
+        return false;
+    }
+
+    // Unpack the rows straight into the weight matrix
+    OutTimeline.Reset(MoveTemp(ChannelNames), PayloadFrameRate);
+    OutTimeline.Weights.SetNumUninitialized(NumSamples);
+    const uint8* Samples = Cursor.Data + Cursor.Offset;
+    if (IsQuantized(SampleFormat))
+    {
+        if (!DecodeQuantizedRows(Cursor, NumChannels, NumFrames, GetQuantizedMax(SampleFormat), OutTimeline.Weights.GetData()))
+        {
+            UE_LOG(LogTemp, Error, TEXT("Binary blendshape payload has truncated quantized rows"));
+            OutTimeline.Weights.Reset();
+            return false;
+        }
+    }
+    else if (SampleFormat == EBlendshapeSampleFormat::Float16)
+    {
+        for (int64 SampleIndex = 0; SampleIndex < NumSamples; SampleIndex++)
+        {
+            FFloat16 HalfValue;
+            FMemory::Memcpy(&HalfValue.Encoded, Samples + SampleIndex * sizeof(uint16), sizeof(uint16));
+            OutTimeline.Weights[SampleIndex] = HalfValue.GetFloat();
+        }
+    }
+    else
+    {
+        FMemory::Memcpy(OutTimeline.Weights.GetData(), Samples, NumSamples * sizeof(float));
+    }
+
+    // Report how much smaller than float32 rows the payload was, and how fast it decoded
+    const double DecodeSeconds = FPlatformTime::Seconds() - StartTime;
+    SET_FLOAT_STAT(STAT_MetaHumanBlendshapeCompression, NumSamples * sizeof(float) / (double)Data.Num());
+    SET_FLOAT_STAT(STAT_MetaHumanBlendshapeThroughput, DecodeSeconds > 0.0 ? NumSamples / DecodeSeconds / 1.0e6 : 0.0);
+
+    return true;
+}
+
+bool FMetaHumanBlendshapeCodec::Encode(const FBlendshapeTimeline& Timeline, EBlendshapeSampleFormat SampleFormat, TArray<uint8>& OutData)
+{
+    using namespace MetaHumanBlendshapeCodec;
+
+    OutData.Reset();
+
+    if (Timeline.FrameRate <= 0.0f)
+    {
+        UE_LOG(LogTemp, Error, TEXT("Cannot encode blendshapes with frame rate %f"), Timeline.FrameRate);
+        return false;
+    }
+
+    const TArray<FString>& ChannelNames = Timeline.ChannelNames;
+    if (ChannelNames.Num() > MAX_uint16)
+    {
+        UE_LOG(LogTemp, Error, TEXT("Cannot encode %d blendshape channels"), ChannelNames.Num());
+        return false;
+    }
+
+    OutData.Reserve(HeaderSize + ChannelNames.Num() * 16 + Timeline.Weights.Num() * GetSampleSize(SampleFormat));
+
+    // Write the fixed header
+    Write(OutData, Magic);
+    Write(OutData, Version);
+    Write(OutData, (uint8)SampleFormat);
+    Write(OutData, (uint8)0);
+    Write(OutData, (uint16)ChannelNames.Num());
+    Write(OutData, (uint16)0);
+    Write(OutData, (uint32)Timeline.GetNumFrames());
+    Write(OutData, Timeline.FrameRate);
+
+    // Write the channel table
+    for (const FString& ChannelName : ChannelNames)
+    {
+        FTCHARToUTF8 NameConverter(*ChannelName);
+        if (NameConverter.Length() > MaxChannelNameLength)
+        {
+            UE_LOG(LogTemp, Error, TEXT("Blendshape channel name is too long: %s"), *ChannelName);
+            OutData.Reset();
+            return false;
+        }
+        Write(OutData, (uint8)NameConverter.Length());
+        OutData.Append(reinterpret_cast<const uint8*>(NameConverter.Get()), NameConverter.Length());
+    }
+
+    // Write the packed rows
+    if (IsQuantized(SampleFormat))
+    {
+        // Delta against the previous row's quantized values, so the decoder's running sum is exact
+        const int32 QuantizedMax = GetQuantizedMax(SampleFormat);
+        const int32 NumChannels = ChannelNames.Num();
+        TArray<int32> Previous;
+        Previous.SetNumZeroed(NumChannels);
+        for (int32 SampleIndex = 0; SampleIndex < Timeline.Weights.Num(); SampleIndex++)
+        {
+            const int32 ChannelIndex = SampleIndex % NumChannels;
+            const int32 Quantized = FMath::RoundToInt(FMath::Clamp(Timeline.Weights[SampleIndex], 0.0f, 1.0f) * QuantizedMax);
+            WriteVarint(OutData, ZigZagEncode(Quantized - Previous[ChannelIndex]));
+            Previous[ChannelIndex] = Quantized;
+        }
+    }
+    else if (SampleFormat == EBlendshapeSampleFormat::Float16)
+    {
+        for (const float Value : Timeline.Weights)
+        {
+            FFloat16 HalfValue(Value);
+            Write(OutData, HalfValue.Encoded);
+        }
+    }
+    else
+    {
+        OutData.Append(reinterpret_cast<const uint8*>(Timeline.Weights.GetData()), Timeline.Weights.Num() * sizeof(float));
+    }
+
+    return true;
+}
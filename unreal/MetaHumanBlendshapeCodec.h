@@ -0,0 +1,109 @@
+/**
+ * MetaHumanBlendshapeCodec.h
+ *
+ * This header file defines FMetaHumanBlendshapeCodec, which converts blendshape animation
+ * between FBlendshapeTimeline and a compact binary wire format.
+ *
+ * Libraries/Modules used:
+ * - CoreMinimal.h: Core Unreal Engine functionality
+ *
+ * Binary layout (all values little-endian):
+ * - Header (20 bytes):
+ *   - uint32 Magic            'MHBS'
+ *   - uint16 Version          Format version (currently 1)
+ *   - uint8  SampleFormat     EBlendshapeSampleFormat
+ *   - uint8  Reserved         Must be zero
+ *   - uint16 NumChannels      Number of blendshape channels per frame
+ *   - uint16 Reserved         Must be zero
+ *   - uint32 NumFrames        Number of frames in the payload
+ *   - float  FrameRate        Frames per second
+ * - Channel table: NumChannels entries of { uint8 NameLength, UTF-8 name bytes }.
+ *   The position of a name in the table is the channel index used by every row.
+ * - Rows: NumFrames rows of NumChannels packed samples (float32 or float16), or for the
+ *   quantized formats one varint per sample: the weight clamped to 0..1 and quantized to
+ *   8 or 12 bits, minus the same channel's quantized value in the previous row (0 before
+ *   the first row), zigzag-encoded and written as a LEB128 varint. Weights vary smoothly,
+ *   so almost every sample takes a single byte.
+ *
+ * The console command MetaHuman.BlendshapeCodecReport <file> encodes a recorded session
+ * (a binary payload or blendshape JSON) in every format and logs size, compression ratio,
+ * decode throughput and quantization error.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Forward declarations
+struct FBlendshapeTimeline;
+
+/**
+ * Sample encoding used for the packed rows of a binary blendshape payload
+ */
+enum class EBlendshapeSampleFormat : uint8
+{
+    // 32-bit IEEE float per channel
+    Float32 = 0,
+
+    // 16-bit IEEE half float per channel
+    Float16 = 1,
+
+    // 8-bit quantized, delta-coded varint per channel
+    Quantized8 = 2,
+
+    // 12-bit quantized, delta-coded varint per channel
+    Quantized12 = 3
+};
+
+/**
+ * Encoder/decoder for the binary blendshape wire format
+ *
+ * The JSON payload repeats every channel name in every frame; the binary format sends the
+ * names once in a channel table and then only packed sample rows, which cuts the payload
+ * size and removes per-frame string parsing on the receiving side.
+ */
+class METAHUMANSTREAMING_API FMetaHumanBlendshapeCodec
+{
+public:
+    // Magic number at the start of every binary payload ('MHBS' in little-endian byte order)
+    static constexpr uint32 Magic = 0x5342484D;
+
+    // Current version of the binary format
+    static constexpr uint16 Version = 1;
+
+    // Size of the fixed header in bytes
+    static constexpr int32 HeaderSize = 20;
+
+    /**
+     * Check whether a buffer starts with a binary blendshape header
+     *
+     * @param Data - The buffer to inspect
+     * @return bool - True if the buffer carries the binary blendshape magic number
+     */
+    static bool IsBinaryPayload(TConstArrayView<uint8> Data);
+
+    /**
+     * Decode a binary blendshape payload into a timeline
+     *
+     * The rows are unpacked straight into the timeline's weight matrix. Quantized rows are
+     * accumulated and dequantized four channels at a time with vector instructions.
+     *
+     * @param Data - The binary payload
+     * @param OutTimeline - Receives the decoded channels, frames and frame rate
+     * @return bool - True if the payload was well formed and fully decoded
+     */
+    static bool Decode(TConstArrayView<uint8> Data, FBlendshapeTimeline& OutTimeline);
+
+    /**
+     * Encode a timeline into a binary blendshape payload
+     *
+     * This is used by test harnesses and tools that need to produce binary payloads;
+     * FBlendshapeTimeline::AddFrame can build the timeline from per-frame name/value maps.
+     *
+     * @param Timeline - The timeline to encode
+     * @param SampleFormat - Encoding of the packed rows
+     * @param OutData - Receives the binary payload
+     * @return bool - True if the timeline could be encoded
+     */
+    static bool Encode(const FBlendshapeTimeline& Timeline, EBlendshapeSampleFormat SampleFormat, TArray<uint8>& OutData);
+};
@@ -0,0 +1,200 @@
+/**
+ * MetaHumanBlendshapeTimeline.cpp
+ *
+ * Implementation of FBlendshapeTimeline, the dense storage used for blendshape
+ * animation received from the backend server.
+ */
+
+#include "MetaHumanBlendshapeTimeline.h"
+
+void FBlendshapeTimeline::Reset(TArray<FString>&& InChannelNames, float InFrameRate, int32 NumFramesToReserve)
+{
+    ChannelNames = MoveTemp(InChannelNames);
+    FrameRate = InFrameRate;
+    Weights.Reset((int64)NumFramesToReserve * ChannelNames.Num());
+}
+
+TArrayView<float> FBlendshapeTimeline::AddFrame()
+{
+    const int32 RowStart = Weights.AddZeroed(GetNumChannels());
+    return TArrayView<float>(Weights.GetData() + RowStart, GetNumChannels());
+}
+
+void FBlendshapeTimeline::AddFrame(const TMap<FString, float>& BlendshapeValues)
+{
+    // Register new channels first so the row is allocated at its final width
+    for (const TPair<FString, float>& Pair : BlendshapeValues)
+    {
+        if (FindChannel(Pair.Key) == INDEX_NONE)
+        {
+            AddChannel(Pair.Key);
+        }
+    }
+
+    TArrayView<float> Row = AddFrame();
+    for (const TPair<FString, float>& Pair : BlendshapeValues)
+    {
+        Row[FindChannel(Pair.Key)] = Pair.Value;
+    }
+}
+
+void FBlendshapeTimeline::WriteFrames(int32 FirstFrame, const FBlendshapeTimeline& Source)
+{
+    FirstFrame = FMath::Max(FirstFrame, 0);
+
+    // Map each source column to a column of this timeline
+    TArray<int32, TInlineAllocator<256>> ColumnMap;
+    ColumnMap.Reserve(Source.GetNumChannels());
+    bool bSameLayout = Source.GetNumChannels() == GetNumChannels();
+    for (int32 SourceChannel = 0; SourceChannel < Source.GetNumChannels(); SourceChannel++)
+    {
+        int32 Channel = FindChannel(Source.ChannelNames[SourceChannel]);
+        if (Channel == INDEX_NONE)
+        {
+            Channel = AddChannel(Source.ChannelNames[SourceChannel]);
+        }
+        ColumnMap.Add(Channel);
+        bSameLayout &= Channel == SourceChannel;
+    }
+
+    // Grow the timeline, holding the last frame across any gap
+    const int32 EndFrame = FirstFrame + Source.GetNumFrames();
+    while (GetNumFrames() < EndFrame)
+    {
+        TArrayView<float> Row = AddFrame();
+        if (GetNumFrames() > 1 && GetNumFrames() <= FirstFrame)
+        {
+            FMemory::Memcpy(Row.GetData(), Row.GetData() - GetNumChannels(), GetNumChannels() * sizeof(float));
+        }
+    }
+
+    // Copy the source rows
+    for (int32 SourceFrame = 0; SourceFrame < Source.GetNumFrames(); SourceFrame++)
+    {
+        TArrayView<const float> SourceRow = Source.GetRow(SourceFrame);
+        TArrayView<float> Row = GetMutableRow(FirstFrame + SourceFrame);
+        if (bSameLayout)
+        {
+            FMemory::Memcpy(Row.GetData(), SourceRow.GetData(), SourceRow.Num() * sizeof(float));
+        }
+        else
+        {
+            for (int32 SourceChannel = 0; SourceChannel < SourceRow.Num(); SourceChannel++)
+            {
+                Row[ColumnMap[SourceChannel]] = SourceRow[SourceChannel];
+            }
+        }
+    }
+}
+
+void FBlendshapeTimeline::Sample(double Time, EBlendshapeInterpolation Interpolation, TArrayView<float> OutWeights) const
+{
+    const int32 NumChannels = GetNumChannels();
+    const int32 NumFrames = GetNumFrames();
+    check(OutWeights.Num() == NumChannels);
+    if (NumFrames == 0)
+    {
+        return;
+    }
+
+    // Split the time into a frame index and the fraction towards the next frame
+    const double FramePosition = FMath::Clamp(Time * FrameRate, 0.0, (double)(NumFrames - 1));
+    const int32 Frame1 = FMath::Min(FMath::FloorToInt(FramePosition), NumFrames - 1);
+    const int32 Frame2 = FMath::Min(Frame1 + 1, NumFrames - 1);
+    const float Alpha = (float)(FramePosition - Frame1);
+
+    const float* Row1 = GetRow(Frame1).GetData();
+    float* Out = OutWeights.GetData();
+    if (Interpolation == EBlendshapeInterpolation::Step || Frame1 == Frame2 || Alpha <= 0.0f)
+    {
+        FMemory::Memcpy(Out, Row1, NumChannels * sizeof(float));
+        return;
+    }
+
+    const float* Row2 = GetRow(Frame2).GetData();
+    const int32 NumVectorChannels = NumChannels & ~3;
+
+    if (Interpolation == EBlendshapeInterpolation::Linear)
+    {
+        // Out = Row1 + (Row2 - Row1) * Alpha
+        const VectorRegister4Float AlphaVector = VectorSetFloat1(Alpha);
+        for (int32 Channel = 0; Channel < NumVectorChannels; Channel += 4)
+        {
+            const VectorRegister4Float Value1 = VectorLoad(Row1 + Channel);
+            const VectorRegister4Float Value2 = VectorLoad(Row2 + Channel);
+            VectorStore(VectorMultiplyAdd(VectorSubtract(Value2, Value1), AlphaVector, Value1), Out + Channel);
+        }
+        for (int32 Channel = NumVectorChannels; Channel < NumChannels; Channel++)
+        {
+            Out[Channel] = FMath::Lerp(Row1[Channel], Row2[Channel], Alpha);
+        }
+        return;
+    }
+
+    // Uniform Catmull-Rom basis weights for the four surrounding frames
+    const float* Row0 = GetRow(FMath::Max(Frame1 - 1, 0)).GetData();
+    const float* Row3 = GetRow(FMath::Min(Frame2 + 1, NumFrames - 1)).GetData();
+    const float Alpha2 = Alpha * Alpha;
+    const float Alpha3 = Alpha2 * Alpha;
+    const float Weight0 = 0.5f * (-Alpha3 + 2.0f * Alpha2 - Alpha);
+    const float Weight1 = 0.5f * (3.0f * Alpha3 - 5.0f * Alpha2 + 2.0f);
+    const float Weight2 = 0.5f * (-3.0f * Alpha3 + 4.0f * Alpha2 + Alpha);
+    const float Weight3 = 0.5f * (Alpha3 - Alpha2);
+
+    // The spline overshoots around sharp changes; keep the weights in their valid range
+    const VectorRegister4Float WeightVector0 = VectorSetFloat1(Weight0);
+    const VectorRegister4Float WeightVector1 = VectorSetFloat1(Weight1);
+    const VectorRegister4Float WeightVector2 = VectorSetFloat1(Weight2);
+    const VectorRegister4Float WeightVector3 = VectorSetFloat1(Weight3);
+    for (int32 Channel = 0; Channel < NumVectorChannels; Channel += 4)
+    {
+        VectorRegister4Float Value = VectorMultiply(VectorLoad(Row0 + Channel), WeightVector0);
+        Value = VectorMultiplyAdd(VectorLoad(Row1 + Channel), WeightVector1, Value);
+        Value = VectorMultiplyAdd(VectorLoad(Row2 + Channel), WeightVector2, Value);
+        Value = VectorMultiplyAdd(VectorLoad(Row3 + Channel), WeightVector3, Value);
+        VectorStore(VectorMin(VectorMax(Value, GlobalVectorConstants::FloatZero), GlobalVectorConstants::FloatOne), Out + Channel);
+    }
+    for (int32 Channel = NumVectorChannels; Channel < NumChannels; Channel++)
+    {
+        const float Value = Row0[Channel] * Weight0 + Row1[Channel] * Weight1 + Row2[Channel] * Weight2 + Row3[Channel] * Weight3;
+        Out[Channel] = FMath::Clamp(Value, 0.0f, 1.0f);
+    }
+}
+
+int32 FBlendshapeTimeline::FindChannel(const FString& ChannelName) const
+{
+    return ChannelNames.IndexOfByKey(ChannelName);
+}
+
+int32 FBlendshapeTimeline::AddChannel(const FString& ChannelName)
+{
+    const int32 OldNumChannels = GetNumChannels();
+    const int32 NumFrames = GetNumFrames();
+    const int32 ChannelIndex = ChannelNames.Add(ChannelName);
+
+    // Widen existing rows from the back so no value is overwritten before it is moved
+    if (NumFrames > 0)
+    {
+        const int32 NewNumChannels = OldNumChannels + 1;
+        Weights.AddUninitialized(NumFrames);
+        for (int32 FrameIndex = NumFrames - 1; FrameIndex >= 0; FrameIndex--)
+        {
+            float* NewRow = Weights.GetData() + (int64)FrameIndex * NewNumChannels;
+            const float* OldRow = Weights.GetData() + (int64)FrameIndex * OldNumChannels;
+            FMemory::Memmove(NewRow, OldRow, OldNumChannels * sizeof(float));
+            NewRow[ChannelIndex] = 0.0f;
+        }
+    }
+
+    return ChannelIndex;
+}
+
+SIZE_T FBlendshapeTimeline::GetAllocatedSize() const
+{
+    SIZE_T Size = ChannelNames.GetAllocatedSize() + Weights.GetAllocatedSize();
+    for (const FString& ChannelName : ChannelNames)
+    {
+        Size += ChannelName.GetAllocatedSize();
+    }
+    return Size;
+}
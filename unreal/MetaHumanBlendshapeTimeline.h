@@ -0,0 +1,177 @@
+/**
+ * MetaHumanBlendshapeTimeline.h
+ *
+ * This header file defines FBlendshapeTimeline, the dense storage used for blendshape
+ * animation received from the backend server.
+ *
+ * Libraries/Modules used:
+ * - CoreMinimal.h: Core Unreal Engine functionality
+ *
+ * The timeline stores a single channel name table and one contiguous, row-major matrix of
+ * weights (frames x channels). Reading a frame is a pointer offset into that matrix, so
+ * per-frame reads touch one cache-friendly block of floats instead of a hash map.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MetaHumanBlendshapeTimeline.generated.h"
+
+/**
+ * How a timeline is evaluated between its frames
+ *
+ * UENUM: Unreal Engine macro for defining an enum that can be used in Blueprint
+ */
+UENUM(BlueprintType)
+enum class EBlendshapeInterpolation : uint8
+{
+    // Hold each frame until the next one starts
+    Step,
+
+    // Blend linearly between the two surrounding frames
+    Linear,
+
+    // Catmull-Rom spline through the four surrounding frames, clamped to 0..1
+    CatmullRom
+};
+
+/**
+ * Structure to hold a blendshape animation as a dense frames x channels matrix
+ *
+ * USTRUCT: Unreal Engine macro for defining a struct that can be used in Blueprint
+ * GENERATED_BODY: Unreal Engine macro for generating boilerplate code
+ */
+USTRUCT(BlueprintType)
+struct METAHUMANSTREAMING_API FBlendshapeTimeline
+{
+    GENERATED_BODY()
+
+    // Blendshape channel names; the index of a name is its column in every row
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Blendshape")
+    TArray<FString> ChannelNames;
+
+    // Row-major weights (0.0 to 1.0), NumFrames * NumChannels values
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Blendshape")
+    TArray<float> Weights;
+
+    // Frame rate of the timeline (frames per second)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Blendshape")
+    float FrameRate = 60.0f;
+
+    /**
+     * Clear the timeline and set up its channel table
+     *
+     * @param InChannelNames - Channel names for every row
+     * @param InFrameRate - Frame rate of the timeline
+     * @param NumFramesToReserve - Number of frames to preallocate
+     */
+    void Reset(TArray<FString>&& InChannelNames, float InFrameRate, int32 NumFramesToReserve = 0);
+
+    /**
+     * Get the number of channels per frame
+     *
+     * @return int32 - Number of channels
+     */
+    FORCEINLINE int32 GetNumChannels() const { return ChannelNames.Num(); }
+
+    /**
+     * Get the number of frames in the timeline
+     *
+     * @return int32 - Number of frames
+     */
+    FORCEINLINE int32 GetNumFrames() const { return ChannelNames.Num() > 0 ? Weights.Num() / ChannelNames.Num() : 0; }
+
+    /**
+     * Check whether the timeline contains any frames
+     *
+     * @return bool - True if there are no frames
+     */
+    FORCEINLINE bool IsEmpty() const { return GetNumFrames() == 0; }
+
+    /**
+     * Get the weights of a frame
+     *
+     * @param FrameIndex - Index of the frame
+     * @return TArrayView<const float> - One weight per channel
+     */
+    FORCEINLINE TArrayView<const float> GetRow(int32 FrameIndex) const
+    {
+        check(FrameIndex >= 0 && FrameIndex < GetNumFrames());
+        return TArrayView<const float>(Weights.GetData() + (int64)FrameIndex * GetNumChannels(), GetNumChannels());
+    }
+
+    /**
+     * Get the writable weights of a frame
+     *
+     * @param FrameIndex - Index of the frame
+     * @return TArrayView<float> - One weight per channel
+     */
+    FORCEINLINE TArrayView<float> GetMutableRow(int32 FrameIndex)
+    {
+        check(FrameIndex >= 0 && FrameIndex < GetNumFrames());
+        return TArrayView<float>(Weights.GetData() + (int64)FrameIndex * GetNumChannels(), GetNumChannels());
+    }
+
+    /**
+     * Evaluate the timeline at an arbitrary time
+     *
+     * Channels are blended four at a time with vector instructions. Times before the first
+     * frame or after the last frame hold that frame.
+     *
+     * @param Time - Time in seconds from the first frame
+     * @param Interpolation - How to blend between frames
+     * @param OutWeights - Receives one weight per channel; must hold GetNumChannels() values
+     */
+    void Sample(double Time, EBlendshapeInterpolation Interpolation, TArrayView<float> OutWeights) const;
+
+    /**
+     * Append a zero-initialized frame
+     *
+     * @return TArrayView<float> - Writable weights of the new frame
+     */
+    TArrayView<float> AddFrame();
+
+    /**
+     * Append a frame from a map of channel names to values
+     *
+     * Channels not yet in the channel table are added; earlier frames read them as zero.
+     *
+     * @param BlendshapeValues - Map of blendshape names to values
+     */
+    void AddFrame(const TMap<FString, float>& BlendshapeValues);
+
+    /**
+     * Write frames from another timeline starting at a frame index
+     *
+     * Channels are matched by name and unknown channels are added. The timeline grows as
+     * needed; a gap before FirstFrame is filled by holding the last existing frame, and
+     * frames that already exist in the written range are overwritten.
+     *
+     * @param FirstFrame - Frame index of the first source frame in this timeline
+     * @param Source - Frames to write
+     */
+    void WriteFrames(int32 FirstFrame, const FBlendshapeTimeline& Source);
+
+    /**
+     * Find the column of a channel
+     *
+     * @param ChannelName - Name of the channel
+     * @return int32 - Channel index, or INDEX_NONE if the channel is unknown
+     */
+    int32 FindChannel(const FString& ChannelName) const;
+
+    /**
+     * Add a channel, widening any existing rows
+     *
+     * @param ChannelName - Name of the channel
+     * @return int32 - Index of the channel
+     */
+    int32 AddChannel(const FString& ChannelName);
+
+    /**
+     * Get the memory used by the timeline
+     *
+     * @return SIZE_T - Allocated bytes
+     */
+    SIZE_T GetAllocatedSize() const;
+};
@@ -0,0 +1,545 @@
+/**
+ * MetaHumanIngestPipeline.cpp
+ *
+ * Implementation of FMetaHumanIngestPipeline, which turns raw messages from the
+ * backend into decoded audio and blendshape data on worker threads.
+ */
+
+#include "MetaHumanIngestPipeline.h"
+#include "MetaHumanBlendshapeCodec.h"
+#include "MetaHumanBinaryMessage.h"
+#include "MetaHumanMessageParser.h"
+#include "MetaHumanBase64.h"
+#include "MetaHumanAudioDecoder.h"
+#include "Dom/JsonObject.h"
+#include "Misc/ScopeExit.h"
+#include "Async/Async.h"
+
+namespace MetaHumanIngestPipeline
+{
+    // Format assumed for raw PCM utterance audio when the message does not give one
+    constexpr int32 DefaultRawSampleRate = 44100;
+    constexpr int32 DefaultRawNumChannels = 1;
+
+    // Longest text message checked for being an interrupt; control messages are a few dozen characters
+    constexpr int32 MaxControlMessageLength = 256;
+
+    /**
+     * Copy an already parsed "blendshapes" value into a timeline: an object with a "frames"
+     * array or the frames array itself
+     */
+    bool ReadBlendshapesValue(const FJsonValue& BlendshapesValue, float FrameRate, FBlendshapeTimeline& OutTimeline)
+    {
+        const TArray<TSharedPtr<FJsonValue>>* FramesArray = nullptr;
+        const TSharedPtr<FJsonObject>* BlendshapesObject = nullptr;
+        if (BlendshapesValue.TryGetObject(BlendshapesObject))
+        {
+            (*BlendshapesObject)->TryGetArrayField(TEXT("frames"), FramesArray);
+        }
+        else
+        {
+            BlendshapesValue.TryGetArray(FramesArray);
+        }
+        if (!FramesArray || FramesArray->Num() == 0)
+        {
+            return false;
+        }
+
+        OutTimeline.Reset(TArray<FString>(), FrameRate, FramesArray->Num());
+        for (const TSharedPtr<FJsonValue>& FrameValue : *FramesArray)
+        {
+            const TSharedPtr<FJsonObject>* FrameObject = nullptr;
+            const TSharedPtr<FJsonObject>* ValuesObject = nullptr;
+            if (!FrameValue->TryGetObject(FrameObject) || !(*FrameObject)->TryGetObjectField(TEXT("blendshapes"), ValuesObject))
+            {
+                continue;
+            }
+
+            // Register new channels first so the row is allocated at its final width
+            for (const TPair<FString, TSharedPtr<FJsonValue>>& Pair : (*ValuesObject)->Values)
+            {
+                if (OutTimeline.FindChannel(Pair.Key) == INDEX_NONE)
+                {
+                    OutTimeline.AddChannel(Pair.Key);
+                }
+            }
+
+            TArrayView<float> Row = OutTimeline.AddFrame();
+            for (const TPair<FString, TSharedPtr<FJsonValue>>& Pair : (*ValuesObject)->Values)
+            {
+                Row[OutTimeline.FindChannel(Pair.Key)] = Pair.Value->AsNumber();
+            }
+        }
+
+        return !OutTimeline.IsEmpty();
+    }
+
+    /**
+     * Decode the blendshapes of a message from "blendshapes_binary" or the JSON "blendshapes"
+     */
+    bool DecodeBlendshapes(const FJsonObject& JsonObject, float DefaultFrameRate, bool bRequired, FMetaHumanIngestResult& OutResult)
+    {
+        const double StartTime = FPlatformTime::Seconds();
+        ON_SCOPE_EXIT
+        {
+            OutResult.Timings.BlendshapeDecodeSeconds = FPlatformTime::Seconds() - StartTime;
+        };
+
+        // Prefer the binary blendshape payload when the sender provides one
+        FString BlendshapeBinaryBase64;
+        if (JsonObject.TryGetStringField(TEXT("blendshapes_binary"), BlendshapeBinaryBase64))
+        {
+            TArray<uint8> BlendshapeBytes;
+            if (!FMetaHumanBase64::Decode(BlendshapeBinaryBase64, BlendshapeBytes))
+            {
+                UE_LOG(LogTemp, Error, TEXT("Failed to decode base64 blendshape payload"));
+                return false;
+            }
+            return FMetaHumanBlendshapeCodec::Decode(BlendshapeBytes, OutResult.BlendshapeTimeline);
+        }
+
+        // Fall back to the JSON blendshapes
+        const TSharedPtr<FJsonValue> BlendshapesValue = JsonObject.TryGetField(TEXT("blendshapes"));
+        if (!BlendshapesValue.IsValid() || (BlendshapesValue->Type != EJson::Object && BlendshapesValue->Type != EJson::Array))
+        {
+            if (bRequired)
+            {
+                UE_LOG(LogTemp, Error, TEXT("Message does not contain blendshape data"));
+            }
+            return !bRequired;
+        }
+
+        // The message's own frame rate wins over the default
+        double FrameRate = DefaultFrameRate;
+        if (!JsonObject.TryGetNumberField(TEXT("frame_rate"), FrameRate) || FrameRate <= 0.0)
+        {
+            FrameRate = DefaultFrameRate;
+        }
+
+        // Read the frames from the DOM directly instead of serializing and reparsing them
+        return ReadBlendshapesValue(*BlendshapesValue, (float)FrameRate, OutResult.BlendshapeTimeline);
+    }
+
+    /**
+     * Decode a base64 audio field into the result, if present
+     */
+    bool DecodeAudioField(const FJsonObject& JsonObject, const TCHAR* FieldName, bool bRequired, FMetaHumanIngestResult& OutResult)
+    {
+        FString AudioBase64;
+        if (!JsonObject.TryGetStringField(FieldName, AudioBase64))
+        {
+            if (bRequired)
+            {
+                UE_LOG(LogTemp, Error, TEXT("Message does not contain %s"), FieldName);
+            }
+            return !bRequired;
+        }
+
+        const double StartTime = FPlatformTime::Seconds();
+        const bool bDecoded = FMetaHumanIngestPipeline::DecodeAudioBase64(AudioBase64, OutResult.AudioData);
+        OutResult.Timings.AudioDecodeSeconds = FPlatformTime::Seconds() - StartTime;
+        return bDecoded;
+    }
+}
+
+bool FMetaHumanIngestPipeline::DecodeMessage(const FString& Message, float DefaultFrameRate, FMetaHumanIngestResult& OutResult)
+{
+    // Tokenize the message once, decoding fields as they stream past
+    if (!FMetaHumanMessageParser::ParseMessage(Message, DefaultFrameRate, OutResult))
+    {
+        return false;
+    }
+    return OutResult.Type != EMetaHumanIngestMessageType::Utterance || DecodeUtteranceAudio(OutResult);
+}
+
+bool FMetaHumanIngestPipeline::DecodeBinaryMessage(TArray<uint8>&& Message, FMetaHumanIngestResult& OutResult)
+{
+    const double StartTime = FPlatformTime::Seconds();
+    FMetaHumanBinaryMessageView View;
+    if (!FMetaHumanBinaryMessage::Decode(Message, View))
+    {
+        return false;
+    }
+    OutResult.Timings.ParseSeconds = FPlatformTime::Seconds() - StartTime;
+
+    OutResult.Type = View.Type;
+    OutResult.CharacterId = GetBinaryCharacterId(View.Character);
+    OutResult.Sequence = View.Sequence;
+    OutResult.Timestamp = View.Timestamp;
+    OutResult.SampleRate = View.SampleRate;
+    OutResult.NumChannels = View.NumChannels;
+    OutResult.FrameRate = View.FrameRate;
+    OutResult.AudioCodec = View.AudioCodec;
+
+    switch (View.Type)
+    {
+    case EMetaHumanIngestMessageType::Utterance:
+        if (View.AudioSize == 0 || View.Blendshapes.Num() == 0)
+        {
+            UE_LOG(LogTemp, Error, TEXT("Binary utterance is missing audio or blendshape data"));
+            return false;
+        }
+        break;
+    case EMetaHumanIngestMessageType::StreamStart:
+        if (View.SampleRate <= 0)
+        {
+            UE_LOG(LogTemp, Error, TEXT("Binary stream_start message is missing a valid sample_rate"));
+            return false;
+        }
+        break;
+    default:
+        break;
+    }
+
+    // Decode the blendshape section straight from the message bytes
+    if (View.Blendshapes.Num() > 0)
+    {
+        const double BlendshapeStartTime = FPlatformTime::Seconds();
+        const bool bDecoded = FMetaHumanBlendshapeCodec::Decode(View.Blendshapes, OutResult.BlendshapeTimeline);
+        OutResult.Timings.BlendshapeDecodeSeconds = FPlatformTime::Seconds() - BlendshapeStartTime;
+        if (!bDecoded)
+        {
+            return false;
+        }
+    }
+
+    // The audio section is raw bytes; keep the message and point at it
+    OutResult.BinaryAudioOffset = View.AudioOffset;
+    OutResult.BinaryAudioSize = View.AudioSize;
+    OutResult.BinaryMessage = MoveTemp(Message);
+    if (View.Type != EMetaHumanIngestMessageType::Utterance)
+    {
+        return true;
+    }
+    return !OutResult.BlendshapeTimeline.IsEmpty() && DecodeUtteranceAudio(OutResult);
+}
+
+bool FMetaHumanIngestPipeline::DecodeMessageObject(const TSharedPtr<FJsonObject>& JsonObject, float DefaultFrameRate, FMetaHumanIngestResult& OutResult)
+{
+    using namespace MetaHumanIngestPipeline;
+
+    if (!JsonObject.IsValid())
+    {
+        return false;
+    }
+
+    FString MessageType;
+    JsonObject->TryGetStringField(TEXT("type"), MessageType);
+    JsonObject->TryGetStringField(TEXT("character"), OutResult.CharacterId);
+
+    if (MessageType.IsEmpty())
+    {
+        OutResult.Type = EMetaHumanIngestMessageType::Utterance;
+        JsonObject->TryGetNumberField(TEXT("sample_rate"), OutResult.SampleRate);
+        JsonObject->TryGetNumberField(TEXT("num_channels"), OutResult.NumChannels);
+        return DecodeAudioField(*JsonObject, TEXT("audio_base64"), true, OutResult) &&
+            DecodeBlendshapes(*JsonObject, DefaultFrameRate, true, OutResult) &&
+            !OutResult.BlendshapeTimeline.IsEmpty() &&
+            DecodeUtteranceAudio(OutResult);
+    }
+
+    if (MessageType == TEXT("stream_start"))
+    {
+        double StreamFrameRate = DefaultFrameRate;
+        OutResult.Type = EMetaHumanIngestMessageType::StreamStart;
+        if (!JsonObject->TryGetNumberField(TEXT("sample_rate"), OutResult.SampleRate) || OutResult.SampleRate <= 0)
+        {
+            UE_LOG(LogTemp, Error, TEXT("stream_start message is missing a valid sample_rate"));
+            return false;
+        }
+        JsonObject->TryGetNumberField(TEXT("num_channels"), OutResult.NumChannels);
+        JsonObject->TryGetNumberField(TEXT("frame_rate"), StreamFrameRate);
+        OutResult.FrameRate = (float)StreamFrameRate;
+        FString CodecName;
+        JsonObject->TryGetStringField(TEXT("codec"), CodecName);
+        return FMetaHumanIngestPipeline::ParseCodecName(CodecName, OutResult.AudioCodec);
+    }
+
+    if (MessageType == TEXT("stream_chunk"))
+    {
+        OutResult.Type = EMetaHumanIngestMessageType::StreamChunk;
+        if (!JsonObject->TryGetNumberField(TEXT("sequence"), OutResult.Sequence) || !JsonObject->TryGetNumberField(TEXT("timestamp"), OutResult.Timestamp))
+        {
+            UE_LOG(LogTemp, Error, TEXT("stream_chunk message is missing sequence or timestamp"));
+            return false;
+        }
+
+        // Decode the chunk's audio segment (PCM or Opus packets) and blendshape frame range (binary or JSON)
+        const TCHAR* AudioField = JsonObject->HasField(TEXT("audio_opus_base64")) ? TEXT("audio_opus_base64") : TEXT("audio_pcm_base64");
+        return DecodeAudioField(*JsonObject, AudioField, false, OutResult) &&
+            DecodeBlendshapes(*JsonObject, DefaultFrameRate, false, OutResult);
+    }
+
+    if (MessageType == TEXT("stream_end"))
+    {
+        OutResult.Type = EMetaHumanIngestMessageType::StreamEnd;
+        return true;
+    }
+
+    if (MessageType == TEXT("interrupt"))
+    {
+        OutResult.Type = EMetaHumanIngestMessageType::Interrupt;
+        return true;
+    }
+
+    UE_LOG(LogTemp, Warning, TEXT("Unknown message type: %s"), *MessageType);
+    return false;
+}
+
+bool FMetaHumanIngestPipeline::ParseBlendshapeJson(const FString& BlendshapeJSON, float FrameRate, FBlendshapeTimeline& OutTimeline)
+{
+    return FMetaHumanMessageParser::ParseBlendshapes(BlendshapeJSON, FrameRate, OutTimeline);
+}
+
+bool FMetaHumanIngestPipeline::DecodeAudioBase64(const FString& AudioBase64, TArray<uint8>& OutAudioData)
+{
+    // Decode base64 string to binary data
+    if (!FMetaHumanBase64::Decode(AudioBase64, OutAudioData))
+    {
+        UE_LOG(LogTemp, Error, TEXT("Failed to decode base64 audio data"));
+        return false;
+    }
+    return true;
+}
+
+bool FMetaHumanIngestPipeline::DecodeUtteranceAudio(FMetaHumanIngestResult& Result)
+{
+    using namespace MetaHumanIngestPipeline;
+
+    const double StartTime = FPlatformTime::Seconds();
+    ON_SCOPE_EXIT
+    {
+        Result.Timings.AudioDecodeSeconds += FPlatformTime::Seconds() - StartTime;
+    };
+
+    // Headerless audio is taken to be in the format the message gives
+    FMetaHumanAudioFormat RawFormat;
+    RawFormat.SampleRate = Result.SampleRate > 0 ? Result.SampleRate : DefaultRawSampleRate;
+    RawFormat.NumChannels = Result.NumChannels > 0 ? Result.NumChannels : DefaultRawNumChannels;
+
+    FMetaHumanAudioFormat Format;
+    TArray<uint8> ConvertedPCM;
+    int32 PCMOffset = 0;
+    int32 PCMSize = 0;
+    if (!FMetaHumanAudioDecoder::Decode(Result.GetAudio(), RawFormat, Format, ConvertedPCM, PCMOffset, PCMSize))
+    {
+        return false;
+    }
+
+    if (ConvertedPCM.Num() > 0)
+    {
+        Result.AudioData = MoveTemp(ConvertedPCM);
+        Result.BinaryAudioSize = 0;
+    }
+    else if (Result.BinaryAudioSize > 0)
+    {
+        Result.BinaryAudioOffset += PCMOffset;
+        Result.BinaryAudioSize = PCMSize;
+    }
+    else
+    {
+        Result.AudioData.RemoveAt(0, PCMOffset, false);
+        Result.AudioData.SetNum(PCMSize, false);
+    }
+
+    Result.SampleRate = Format.SampleRate;
+    Result.NumChannels = Format.NumChannels;
+    UE_LOG(LogTemp, Verbose, TEXT("Decoded %s audio: %d Hz, %d channels, %.2f s"),
+        FMetaHumanAudioDecoder::GetContainerName(Format.Container), Format.SampleRate, Format.NumChannels, Format.GetDuration());
+    return Format.NumFrames > 0;
+}
+
+bool FMetaHumanIngestPipeline::ParseCodecName(const FString& CodecName, EMetaHumanAudioCodec& OutCodec)
+{
+    if (CodecName.IsEmpty() || CodecName == TEXT("pcm"))
+    {
+        OutCodec = EMetaHumanAudioCodec::PCM;
+        return true;
+    }
+    if (CodecName == TEXT("opus"))
+    {
+        OutCodec = EMetaHumanAudioCodec::Opus;
+        return true;
+    }
+
+    UE_LOG(LogTemp, Error, TEXT("Unsupported stream codec: %s"), *CodecName);
+    return false;
+}
+
+bool FMetaHumanIngestPipeline::IsInterruptMessage(const FString& Message, FString& OutCharacterId)
+{
+    using namespace MetaHumanIngestPipeline;
+
+    if (Message.Len() > MaxControlMessageLength || !Message.Contains(TEXT("\"interrupt\""), ESearchCase::CaseSensitive))
+    {
+        return false;
+    }
+
+    FMetaHumanIngestResult Result;
+    if (!DecodeMessage(Message, 0.0f, Result) || Result.Type != EMetaHumanIngestMessageType::Interrupt)
+    {
+        return false;
+    }
+    OutCharacterId = MoveTemp(Result.CharacterId);
+    return true;
+}
+
+bool FMetaHumanIngestPipeline::IsInterruptMessage(TConstArrayView<uint8> Message, FString& OutCharacterId)
+{
+    FMetaHumanBinaryMessageView View;
+    if (Message.Num() != FMetaHumanBinaryMessage::HeaderSize || !FMetaHumanBinaryMessage::Decode(Message, View) ||
+        View.Type != EMetaHumanIngestMessageType::Interrupt)
+    {
+        return false;
+    }
+    OutCharacterId = GetBinaryCharacterId(View.Character);
+    return true;
+}
+
+FString FMetaHumanIngestPipeline::GetBinaryCharacterId(uint16 Character)
+{
+    return Character == 0 ? FString() : LexToString(Character);
+}
+
+FString FMetaHumanIngestPipeline::PeekCharacterId(const FString& Message)
+{
+    const TCHAR FieldName[] = TEXT("\"character\"");
+    const int32 FieldIndex = Message.Find(FieldName, ESearchCase::CaseSensitive);
+    if (FieldIndex == INDEX_NONE)
+    {
+        return FString();
+    }
+
+    // Skip to the opening quote of the value: "character" <ws> : <ws> "
+    int32 Index = FieldIndex + UE_ARRAY_COUNT(FieldName) - 1;
+    while (Index < Message.Len() && FChar::IsWhitespace(Message[Index]))
+    {
+        Index++;
+    }
+    if (Index >= Message.Len() || Message[Index] != TEXT(':'))
+    {
+        return FString();
+    }
+    Index++;
+    while (Index < Message.Len() && FChar::IsWhitespace(Message[Index]))
+    {
+        Index++;
+    }
+    if (Index >= Message.Len() || Message[Index] != TEXT('"'))
+    {
+        return FString();
+    }
+
+    // Ids are plain text; a value with escapes is left to the decoder
+    const int32 ValueStart = Index + 1;
+    for (Index = ValueStart; Index < Message.Len() && Message[Index] != TEXT('"'); Index++)
+    {
+        if (Message[Index] == TEXT('\\'))
+        {
+            return FString();
+        }
+    }
+    return Index < Message.Len() ? Message.Mid(ValueStart, Index - ValueStart) : FString();
+}
+
+FString FMetaHumanIngestPipeline::PeekCharacterId(TConstArrayView<uint8> Message)
+{
+    FMetaHumanBinaryMessageView View;
+    return FMetaHumanBinaryMessage::Decode(Message, View) ? GetBinaryCharacterId(View.Character) : FString();
+}
+
+FMetaHumanIngestQueue::FMetaHumanIngestQueue()
+    : CompletedIngests(MakeShared<TQueue<FCompletedIngest, EQueueMode::Mpsc>, ESPMode::ThreadSafe>())
+    , NextTicket(0)
+{
+}
+
+void FMetaHumanIngestQueue::IngestMessageAsync(const FString& Key, const FString& Message, float DefaultFrameRate, TFunction<void()>&& OnDecoded)
+{
+    IngestAsync(Key, [Message, DefaultFrameRate](FMetaHumanIngestResult& Result)
+    {
+        return FMetaHumanIngestPipeline::DecodeMessage(Message, DefaultFrameRate, Result);
+    }, MoveTemp(OnDecoded));
+}
+
+void FMetaHumanIngestQueue::IngestBinaryMessageAsync(const FString& Key, TArray<uint8>&& Message, TFunction<void()>&& OnDecoded)
+{
+    IngestAsync(Key, [Message = MoveTemp(Message)](FMetaHumanIngestResult& Result) mutable
+    {
+        return FMetaHumanIngestPipeline::DecodeBinaryMessage(MoveTemp(Message), Result);
+    }, MoveTemp(OnDecoded));
+}
+
+void FMetaHumanIngestQueue::IngestAsync(const FString& Key, TUniqueFunction<bool(FMetaHumanIngestResult&)>&& DecodeFunction, TFunction<void()>&& OnDecoded)
+{
+    const uint64 Ticket = NextTicket++;
+    UncommittedTickets.FindOrAdd(Key).Add(Ticket);
+    const double ArrivalTime = FPlatformTime::Seconds();
+
+    AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [Completed = CompletedIngests, Ticket, ArrivalTime, DecodeFunction = MoveTemp(DecodeFunction), OnDecoded = MoveTemp(OnDecoded)]() mutable
+    {
+        // Decode and parse on the worker
+        FCompletedIngest Ingest;
+        Ingest.Ticket = Ticket;
+        Ingest.Result = MakeShared<FMetaHumanIngestResult>();
+        Ingest.Result->Timings.QueueSeconds = FPlatformTime::Seconds() - ArrivalTime;
+        if (!DecodeFunction(*Ingest.Result))
+        {
+            Ingest.Result.Reset();
+        }
+        Completed->Enqueue(MoveTemp(Ingest));
+
+        // Otherwise the owner picks the result up on its next tick
+        if (OnDecoded)
+        {
+            AsyncTask(ENamedThreads::GameThread, MoveTemp(OnDecoded));
+        }
+    });
+}
+
+void FMetaHumanIngestQueue::Interrupt(const FString& Key)
+{
+    FirstTicketAfterInterrupt.Add(Key, NextTicket);
+}
+
+void FMetaHumanIngestQueue::CommitCompleted(TFunctionRef<void(FMetaHumanIngestResult&)> CommitFunction)
+{
+    FCompletedIngest Ingest;
+    while (CompletedIngests->Dequeue(Ingest))
+    {
+        PendingIngests.Add(Ingest.Ticket, MoveTemp(Ingest.Result));
+    }
+
+    // Take every result whose predecessors under the same key are done; they are committed
+    // afterwards, so the commit function can ingest more messages without disturbing the walk
+    TArray<TPair<FString, FCompletedIngest>, TInlineAllocator<8>> ReadyIngests;
+    for (auto It = UncommittedTickets.CreateIterator(); It; ++It)
+    {
+        TArray<uint64>& Tickets = It.Value();
+        int32 NumReady = 0;
+        TSharedPtr<FMetaHumanIngestResult> ReadyResult;
+        while (NumReady < Tickets.Num() && PendingIngests.RemoveAndCopyValue(Tickets[NumReady], ReadyResult))
+        {
+            FCompletedIngest& Ready = ReadyIngests.Emplace_GetRef(It.Key(), FCompletedIngest()).Value;
+            Ready.Ticket = Tickets[NumReady];
+            Ready.Result = MoveTemp(ReadyResult);
+            NumReady++;
+        }
+
+        Tickets.RemoveAt(0, NumReady, false);
+        if (Tickets.Num() == 0)
+        {
+            It.RemoveCurrent();
+        }
+    }
+
+    for (TPair<FString, FCompletedIngest>& Ready : ReadyIngests)
+    {
+        // Messages that arrived before their key's last interrupt are dropped once decoded,
+        // including interrupts committed earlier in this loop
+        if (Ready.Value.Result.IsValid() && Ready.Value.Ticket >= FirstTicketAfterInterrupt.FindRef(Ready.Key))
+        {
+            CommitFunction(*Ready.Value.Result);
+        }
+    }
+}
@@ -0,0 +1,353 @@
+/**
+ * MetaHumanIngestPipeline.h
+ *
+ * This header file defines FMetaHumanIngestPipeline, which turns raw messages from the
+ * backend into decoded audio and blendshape data without touching any UObject, so the
+ * work can run on worker threads.
+ *
+ * Libraries/Modules used:
+ * - CoreMinimal.h: Core Unreal Engine functionality
+ * - Json: JSON parsing
+ * - Containers/Queue.h: Lock-free queue for results handed back by worker tasks
+ *
+ * The pipeline handles:
+ * - Parsing whole-utterance and streaming messages, as JSON text or binary frames
+ * - Base64-decoding audio and decoding its container (WAV, Ogg Opus or raw PCM) to 16-bit PCM
+ * - Decoding JSON or binary blendshapes into a timeline
+ * - Measuring the time spent in each stage
+ * - Decoding messages on worker tasks and committing the results on the game thread in
+ *   arrival order (FMetaHumanIngestQueue)
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MetaHumanBlendshapeTimeline.h"
+#include "MetaHumanOpus.h"
+#include "Containers/Queue.h"
+
+// Forward declarations
+class FJsonObject;
+
+/**
+ * Kind of message produced by the ingest pipeline
+ */
+enum class EMetaHumanIngestMessageType : uint8
+{
+    // Complete utterance with audio and blendshapes
+    Utterance,
+
+    // Start of a streamed utterance
+    StreamStart,
+
+    // Chunk of a streamed utterance
+    StreamChunk,
+
+    // End of a streamed utterance
+    StreamEnd,
+
+    // Stop playback and drop queued utterances; receivers act on it as soon as it arrives
+    Interrupt
+};
+
+/**
+ * Time spent in each ingest stage, in seconds
+ */
+struct FMetaHumanIngestTimings
+{
+    // Time from arrival until a worker picked the message up
+    double QueueSeconds = 0.0;
+
+    // Time spent parsing the message envelope
+    double ParseSeconds = 0.0;
+
+    // Time spent decoding audio
+    double AudioDecodeSeconds = 0.0;
+
+    // Time spent decoding blendshapes
+    double BlendshapeDecodeSeconds = 0.0;
+
+    // Time spent committing the result on the game thread
+    double CommitSeconds = 0.0;
+};
+
+/**
+ * Decoded message, ready to be committed on the game thread
+ */
+struct FMetaHumanIngestResult
+{
+    // Kind of message
+    EMetaHumanIngestMessageType Type = EMetaHumanIngestMessageType::Utterance;
+
+    // Character the message is addressed to, or empty for the default character
+    FString CharacterId;
+
+    // Decoded audio bytes (utterance audio or chunk PCM) of a text message, or PCM converted from compressed audio
+    TArray<uint8> AudioData;
+
+    // Bytes of a binary message, kept whole so the audio section is used in place
+    TArray<uint8> BinaryMessage;
+
+    // Location of the audio section within BinaryMessage; a size of 0 means the audio is in AudioData
+    int32 BinaryAudioOffset = 0;
+    int32 BinaryAudioSize = 0;
+
+    // Decoded blendshapes (utterance or chunk frame range)
+    FBlendshapeTimeline BlendshapeTimeline;
+
+    // Stream chunk sequence number and timestamp
+    int32 Sequence = 0;
+    double Timestamp = 0.0;
+
+    // Stream format from stream_start, or format of the decoded utterance audio
+    int32 SampleRate = 0;
+    int32 NumChannels = 1;
+    float FrameRate = 0.0f;
+
+    // Codec of the stream's chunk audio, from stream_start
+    EMetaHumanAudioCodec AudioCodec = EMetaHumanAudioCodec::PCM;
+
+    // Time spent in each stage
+    FMetaHumanIngestTimings Timings;
+
+    /**
+     * Get the audio bytes of the message, wherever they were decoded to
+     *
+     * @return TConstArrayView<uint8> - Utterance audio or chunk PCM
+     */
+    TConstArrayView<uint8> GetAudio() const
+    {
+        if (BinaryAudioSize > 0)
+        {
+            return TConstArrayView<uint8>(BinaryMessage.GetData() + BinaryAudioOffset, BinaryAudioSize);
+        }
+        return AudioData;
+    }
+};
+
+/**
+ * Stateless, thread-safe decoding of backend messages
+ */
+class METAHUMANSTREAMING_API FMetaHumanIngestPipeline
+{
+public:
+    /**
+     * Decode a message from its JSON text
+     *
+     * The text is tokenized once by FMetaHumanMessageParser; no DOM is built.
+     *
+     * @param Message - The JSON message text
+     * @param DefaultFrameRate - Frame rate assumed for JSON blendshapes when the message has no frame_rate
+     * @param OutResult - Receives the decoded message
+     * @return bool - True if the message was decoded
+     */
+    static bool DecodeMessage(const FString& Message, float DefaultFrameRate, FMetaHumanIngestResult& OutResult);
+
+    /**
+     * Decode a binary message
+     *
+     * The blendshape section is decoded in place and the message is moved into the result,
+     * so the audio section reaches the sound wave without an intermediate copy.
+     *
+     * @param Message - The complete binary message
+     * @param OutResult - Receives the decoded message
+     * @return bool - True if the message was decoded
+     */
+    static bool DecodeBinaryMessage(TArray<uint8>&& Message, FMetaHumanIngestResult& OutResult);
+
+    /**
+     * Decode a message from a parsed JSON object
+     *
+     * The "blendshapes" field may be an object with a "frames" array or the frames array itself.
+     *
+     * @param JsonObject - The parsed message
+     * @param DefaultFrameRate - Frame rate assumed for JSON blendshapes when the message has no frame_rate
+     * @param OutResult - Receives the decoded message
+     * @return bool - True if the message was decoded
+     */
+    static bool DecodeMessageObject(const TSharedPtr<FJsonObject>& JsonObject, float DefaultFrameRate, FMetaHumanIngestResult& OutResult);
+
+    /**
+     * Parse blendshape data from JSON
+     *
+     * The JSON string should contain an object with a "frames" array, or the array itself.
+     *
+     * @param BlendshapeJSON - JSON string containing blendshape data
+     * @param FrameRate - Frame rate of the blendshape frames
+     * @param OutTimeline - Receives the parsed blendshape frames
+     * @return bool - True if at least one frame was parsed
+     */
+    static bool ParseBlendshapeJson(const FString& BlendshapeJSON, float FrameRate, FBlendshapeTimeline& OutTimeline);
+
+    /**
+     * Decode base64-encoded audio
+     *
+     * @param AudioBase64 - Base64-encoded audio data
+     * @param OutAudioData - Receives the decoded bytes
+     * @return bool - True if the audio was decoded
+     */
+    static bool DecodeAudioBase64(const FString& AudioBase64, TArray<uint8>& OutAudioData);
+
+    /**
+     * Decode the container of an utterance's audio to 16-bit PCM
+     *
+     * 16-bit PCM already in the message is kept where it is and only trimmed to the samples;
+     * other audio is converted into AudioData. SampleRate and NumChannels are set to the
+     * decoded format; when they are already set, they describe raw PCM input.
+     *
+     * @param Result - The message whose audio to decode
+     * @return bool - True if the audio was decoded
+     */
+    static bool DecodeUtteranceAudio(FMetaHumanIngestResult& Result);
+
+    /**
+     * Read the codec named by a stream_start message
+     *
+     * @param CodecName - "pcm", "opus", or empty for PCM
+     * @param OutCodec - Receives the codec
+     * @return bool - False if the codec is not supported
+     */
+    static bool ParseCodecName(const FString& CodecName, EMetaHumanAudioCodec& OutCodec);
+
+    /**
+     * Check whether a message is an interrupt, so it can skip the ingest queue
+     *
+     * Only short messages naming the interrupt type are parsed; other messages cost a
+     * length check and at most one substring search.
+     *
+     * @param Message - The JSON message text
+     * @param OutCharacterId - Receives the character the interrupt is addressed to, or empty for the default character
+     * @return bool - True if the message is {"type": "interrupt"}
+     */
+    static bool IsInterruptMessage(const FString& Message, FString& OutCharacterId);
+
+    /**
+     * Check whether a binary message is an interrupt, so it can skip the ingest queue
+     *
+     * @param Message - The complete binary message
+     * @param OutCharacterId - Receives the character the interrupt is addressed to, or empty for the default character
+     * @return bool - True if the message is a header-only message of type Interrupt
+     */
+    static bool IsInterruptMessage(TConstArrayView<uint8> Message, FString& OutCharacterId);
+
+    /**
+     * Get the character id of a binary message's numeric character field
+     *
+     * @param Character - Character field of the binary header
+     * @return FString - The id as decimal text, or empty for 0 (the default character)
+     */
+    static FString GetBinaryCharacterId(uint16 Character);
+
+    /**
+     * Find the character a message is addressed to without decoding it
+     *
+     * Only the string value of the first "character" field is read, so the result can
+     * order the message among others for the same character before it is decoded; the
+     * decoded message's CharacterId is what it is delivered by.
+     *
+     * @param Message - The JSON message text
+     * @return FString - The character id, or empty if none was found
+     */
+    static FString PeekCharacterId(const FString& Message);
+
+    /**
+     * Find the character a binary message is addressed to from its header
+     *
+     * @param Message - The complete binary message
+     * @return FString - The character id, or empty for the default character or an invalid header
+     */
+    static FString PeekCharacterId(TConstArrayView<uint8> Message);
+};
+
+/**
+ * Decodes messages on the task graph's worker pool and commits the results in arrival order
+ *
+ * Each message is ingested under a key, normally the character it is addressed to. Results
+ * are committed in the order their messages were ingested under the same key, whatever
+ * order the workers finish in; a message still being decoded only holds back its own key.
+ *
+ * Every function must be called on the game thread.
+ */
+class METAHUMANSTREAMING_API FMetaHumanIngestQueue
+{
+public:
+    FMetaHumanIngestQueue();
+
+    FMetaHumanIngestQueue(const FMetaHumanIngestQueue&) = delete;
+    FMetaHumanIngestQueue& operator=(const FMetaHumanIngestQueue&) = delete;
+
+    /**
+     * Decode a JSON message on a worker task
+     *
+     * @param Key - Orders the message among the others ingested under the same key
+     * @param Message - The JSON message text
+     * @param DefaultFrameRate - Frame rate assumed for JSON blendshapes when the message has no frame_rate
+     * @param OnDecoded - Called on the game thread once the result can be committed, or null
+     */
+    void IngestMessageAsync(const FString& Key, const FString& Message, float DefaultFrameRate, TFunction<void()>&& OnDecoded = nullptr);
+
+    /**
+     * Decode a binary message on a worker task
+     *
+     * The bytes move into the task and on into the result; they are never copied.
+     *
+     * @param Key - Orders the message among the others ingested under the same key
+     * @param Message - The complete binary message
+     * @param OnDecoded - Called on the game thread once the result can be committed, or null
+     */
+    void IngestBinaryMessageAsync(const FString& Key, TArray<uint8>&& Message, TFunction<void()>&& OnDecoded = nullptr);
+
+    /**
+     * Run a decode function on a worker task
+     *
+     * @param Key - Orders the message among the others ingested under the same key
+     * @param DecodeFunction - Fills the result on the worker; returns false if decoding failed
+     * @param OnDecoded - Called on the game thread once the result can be committed, or null
+     */
+    void IngestAsync(const FString& Key, TUniqueFunction<bool(FMetaHumanIngestResult&)>&& DecodeFunction, TFunction<void()>&& OnDecoded = nullptr);
+
+    /**
+     * Drop the results of every message ingested under a key so far, once they are decoded
+     *
+     * @param Key - Key the messages were ingested under
+     */
+    void Interrupt(const FString& Key);
+
+    /**
+     * Commit every decoded result whose predecessors under the same key have been committed
+     *
+     * Failed and interrupted messages are skipped. The commit function may ingest or
+     * interrupt messages itself.
+     *
+     * @param CommitFunction - Called with each result to commit, in order
+     */
+    void CommitCompleted(TFunctionRef<void(FMetaHumanIngestResult&)> CommitFunction);
+
+private:
+    /**
+     * Decoded message handed back by a worker task
+     */
+    struct FCompletedIngest
+    {
+        // Ticket assigned when the message was ingested
+        uint64 Ticket = 0;
+
+        // The decoded message, or null if decoding failed
+        TSharedPtr<FMetaHumanIngestResult> Result;
+    };
+
+    // Results handed back by worker tasks; shared so tasks still running after the queue is gone stay valid
+    TSharedRef<TQueue<FCompletedIngest, EQueueMode::Mpsc>, ESPMode::ThreadSafe> CompletedIngests;
+
+    // Results waiting for earlier tickets of the same key to complete, keyed by ticket
+    TMap<uint64, TSharedPtr<FMetaHumanIngestResult>> PendingIngests;
+
+    // Tickets not yet committed, in ingest order, by key
+    TMap<FString, TArray<uint64>> UncommittedTickets;
+
+    // First ticket ingested after each key's last interrupt; results of earlier tickets are dropped
+    TMap<FString, uint64> FirstTicketAfterInterrupt;
+
+    // Ticket of the next ingested message
+    uint64 NextTicket;
+};
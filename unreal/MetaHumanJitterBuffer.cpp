@@ -0,0 +1,181 @@
+/**
+ * MetaHumanJitterBuffer.cpp
+ *
+ * Implementation of FMetaHumanJitterBuffer, the playout buffer that sits between
+ * streamed chunks arriving from the backend and the receiver's audio and blendshape sinks.
+ */
+
+#include "MetaHumanJitterBuffer.h"
+#include "Algo/BinarySearch.h"
+
+namespace MetaHumanJitterBuffer
+{
+    // Gain of the RFC 3550 jitter estimator
+    constexpr double JitterGain = 1.0 / 16.0;
+
+    // Target depth as a multiple of the measured jitter
+    constexpr double JitterMultiplier = 4.0;
+
+    // Depth added to the target on every underrun
+    constexpr double UnderrunStep = 0.04;
+
+    // Per-chunk decay of the underrun depth while chunks keep arriving
+    constexpr double UnderrunDecay = 0.98;
+}
+
+FMetaHumanJitterBuffer::FMetaHumanJitterBuffer()
+{
+    Reset(0.1, 0.5);
+}
+
+void FMetaHumanJitterBuffer::Reset(double InMinTargetDelay, double InMaxTargetDelay)
+{
+    Chunks.Reset();
+    NextSequence = 0;
+    MinTargetDelay = FMath::Max(InMinTargetDelay, 0.0);
+    MaxTargetDelay = FMath::Max(InMaxTargetDelay, MinTargetDelay);
+    UnderrunDelay = 0.0;
+    Jitter = 0.0;
+    LastArrivalTime = 0.0;
+    LastTimestamp = 0.0;
+    bHasLastArrival = false;
+    bPlaying = false;
+    bHasReleased = false;
+    Underruns = 0;
+    LateDrops = 0;
+    LostChunks = 0;
+}
+
+bool FMetaHumanJitterBuffer::Insert(FMetaHumanStreamChunk&& Chunk, double ArrivalTime)
+{
+    using namespace MetaHumanJitterBuffer;
+
+    // Update the jitter estimate from the transit time difference to the previous arrival
+    if (bHasLastArrival)
+    {
+        const double TransitDelta = (ArrivalTime - LastArrivalTime) - (Chunk.Timestamp - LastTimestamp);
+        Jitter += (FMath::Abs(TransitDelta) - Jitter) * JitterGain;
+    }
+    LastArrivalTime = ArrivalTime;
+    LastTimestamp = Chunk.Timestamp;
+    bHasLastArrival = true;
+    UnderrunDelay *= UnderrunDecay;
+
+    // Drop chunks whose slot has already been played or skipped
+    if (Chunk.Sequence < NextSequence)
+    {
+        LateDrops++;
+        return false;
+    }
+
+    // Insert in sequence order, rejecting duplicates
+    const int32 InsertIndex = Algo::LowerBoundBy(Chunks, Chunk.Sequence, &FMetaHumanStreamChunk::Sequence);
+    if (Chunks.IsValidIndex(InsertIndex) && Chunks[InsertIndex].Sequence == Chunk.Sequence)
+    {
+        LateDrops++;
+        return false;
+    }
+    Chunks.Insert(MoveTemp(Chunk), InsertIndex);
+    return true;
+}
+
+void FMetaHumanJitterBuffer::Pop(double SinkBufferedSeconds, bool bStreamEnded, TArray<FMetaHumanStreamChunk>& OutChunks)
+{
+    using namespace MetaHumanJitterBuffer;
+
+    // The sink ran dry while the stream is still open: re-buffer with a deeper target
+    if (bPlaying && SinkBufferedSeconds <= 0.0 && !bStreamEnded)
+    {
+        Underruns++;
+        UnderrunDelay = FMath::Min(UnderrunDelay + UnderrunStep, MaxTargetDelay);
+        bPlaying = false;
+    }
+
+    // A missing chunk is given up on once the sink is dry and enough later audio is waiting
+    if (Chunks.Num() > 0 && Chunks[0].Sequence != NextSequence && SinkBufferedSeconds <= 0.0 &&
+        (bStreamEnded || GetHeldSeconds() >= GetTargetDelay()))
+    {
+        // The sink fills the gap before the next chunk's audio, so it stays on stream time
+        Chunks[0].NumLostBefore = Chunks[0].Sequence - NextSequence;
+        LostChunks += Chunks[0].NumLostBefore;
+        NextSequence = Chunks[0].Sequence;
+    }
+
+    // Wait until the target depth is buffered before (re)starting
+    if (!bPlaying)
+    {
+        const double AvailableSeconds = SinkBufferedSeconds + GetContiguousSeconds();
+        const bool bReachedTarget = AvailableSeconds >= GetTargetDelay();
+        const bool bDraining = bStreamEnded && (AvailableSeconds > 0.0 || bHasReleased);
+        if (!bReachedTarget && !bDraining)
+        {
+            return;
+        }
+        bPlaying = true;
+    }
+
+    // Release every contiguous chunk
+    int32 NumReleased = 0;
+    while (NumReleased < Chunks.Num() && Chunks[NumReleased].Sequence == NextSequence)
+    {
+        NextSequence++;
+        NumReleased++;
+    }
+
+    if (NumReleased > 0)
+    {
+        OutChunks.Reserve(OutChunks.Num() + NumReleased);
+        for (int32 ChunkIndex = 0; ChunkIndex < NumReleased; ChunkIndex++)
+        {
+            OutChunks.Add(MoveTemp(Chunks[ChunkIndex]));
+        }
+        Chunks.RemoveAt(0, NumReleased, false);
+        bHasReleased = true;
+    }
+}
+
+FMetaHumanJitterBufferStats FMetaHumanJitterBuffer::GetStats() const
+{
+    FMetaHumanJitterBufferStats Stats;
+    Stats.JitterSeconds = (float)Jitter;
+    Stats.TargetDelaySeconds = (float)GetTargetDelay();
+    Stats.BufferedChunks = Chunks.Num();
+    Stats.BufferedSeconds = (float)GetHeldSeconds();
+    Stats.Underruns = Underruns;
+    Stats.LateDrops = LateDrops;
+    Stats.LostChunks = LostChunks;
+    return Stats;
+}
+
+double FMetaHumanJitterBuffer::GetTargetDelay() const
+{
+    using namespace MetaHumanJitterBuffer;
+
+    return FMath::Clamp(JitterMultiplier * Jitter + UnderrunDelay, MinTargetDelay, MaxTargetDelay);
+}
+
+double FMetaHumanJitterBuffer::GetHeldSeconds() const
+{
+    double Seconds = 0.0;
+    for (const FMetaHumanStreamChunk& Chunk : Chunks)
+    {
+        Seconds += Chunk.Duration;
+    }
+    return Seconds;
+}
+
+double FMetaHumanJitterBuffer::GetContiguousSeconds() const
+{
+    double Seconds = 0.0;
+    int32 Sequence = NextSequence;
+    for (const FMetaHumanStreamChunk& Chunk : Chunks)
+    {
+        if (Chunk.Sequence != Sequence)
+        {
+            break;
+        }
+        Seconds += Chunk.Duration;
+        Sequence++;
+    }
+    return Seconds;
+}
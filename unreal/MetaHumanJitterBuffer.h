@@ -0,0 +1,209 @@
+/**
+ * MetaHumanJitterBuffer.h
+ *
+ * This header file defines FMetaHumanJitterBuffer, the playout buffer that sits between
+ * streamed chunks arriving from the backend and the receiver's audio and blendshape sinks.
+ *
+ * Libraries/Modules used:
+ * - CoreMinimal.h: Core Unreal Engine functionality
+ *
+ * The buffer:
+ * - Reorders chunks by sequence number and drops chunks that arrive after their slot was played
+ * - Measures inter-arrival jitter against the chunks' stream timestamps (RFC 3550 estimator)
+ * - Adapts its target depth to the measured jitter instead of using a fixed worst-case delay
+ * - Detects underruns of the sink and re-buffers to the target depth before resuming
+ *
+ * Audio and blendshapes travel in the same chunk and share its timestamp, so releasing a
+ * chunk hands both to their sinks at the same stream time and keeps them in sync.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MetaHumanBlendshapeTimeline.h"
+#include "MetaHumanJitterBuffer.generated.h"
+
+/**
+ * One chunk of a streamed utterance
+ */
+struct FMetaHumanStreamChunk
+{
+    // Sequence number of the chunk, starting at 0
+    int32 Sequence = 0;
+
+    // Stream time of the chunk's first audio sample and blendshape frame, in seconds
+    double Timestamp = 0.0;
+
+    // Seconds of audio carried by the chunk
+    double Duration = 0.0;
+
+    // Buffer holding the chunk's audio; for a binary message, the whole message, so the audio is not copied out of it
+    TArray<uint8> AudioBuffer;
+
+    // Location of the chunk's audio within AudioBuffer
+    int32 AudioOffset = 0;
+    int32 AudioSize = 0;
+
+    // Blendshape frames of the chunk
+    FBlendshapeTimeline BlendshapeFrames;
+
+    // Chunks given up as lost right before this one, set when the chunk is released
+    int32 NumLostBefore = 0;
+
+    /**
+     * Get the audio of the chunk
+     *
+     * @return TConstArrayView<uint8> - 16-bit PCM, or length-prefixed Opus packets for an Opus stream
+     */
+    TConstArrayView<uint8> GetAudio() const
+    {
+        return TConstArrayView<uint8>(AudioBuffer.GetData() + AudioOffset, AudioSize);
+    }
+};
+
+/**
+ * Structure to report the state of a jitter buffer
+ *
+ * USTRUCT: Unreal Engine macro for defining a struct that can be used in Blueprint
+ * GENERATED_BODY: Unreal Engine macro for generating boilerplate code
+ */
+USTRUCT(BlueprintType)
+struct METAHUMANSTREAMING_API FMetaHumanJitterBufferStats
+{
+    GENERATED_BODY()
+
+    // Smoothed inter-arrival jitter in seconds
+    UPROPERTY(BlueprintReadOnly, Category = "MetaHuman|Streaming")
+    float JitterSeconds = 0.0f;
+
+    // Current target depth in seconds
+    UPROPERTY(BlueprintReadOnly, Category = "MetaHuman|Streaming")
+    float TargetDelaySeconds = 0.0f;
+
+    // Seconds of audio held in the buffer
+    UPROPERTY(BlueprintReadOnly, Category = "MetaHuman|Streaming")
+    float BufferedSeconds = 0.0f;
+
+    // Number of chunks held in the buffer
+    UPROPERTY(BlueprintReadOnly, Category = "MetaHuman|Streaming")
+    int32 BufferedChunks = 0;
+
+    // Number of times the sink ran dry while the stream was still open
+    UPROPERTY(BlueprintReadOnly, Category = "MetaHuman|Streaming")
+    int32 Underruns = 0;
+
+    // Number of chunks dropped because they arrived after their slot was played
+    UPROPERTY(BlueprintReadOnly, Category = "MetaHuman|Streaming")
+    int32 LateDrops = 0;
+
+    // Number of chunks skipped because they had not arrived when their slot was due
+    UPROPERTY(BlueprintReadOnly, Category = "MetaHuman|Streaming")
+    int32 LostChunks = 0;
+};
+
+/**
+ * Adaptive playout buffer for streamed audio/blendshape chunks
+ */
+class METAHUMANSTREAMING_API FMetaHumanJitterBuffer
+{
+public:
+    FMetaHumanJitterBuffer();
+
+    /**
+     * Clear the buffer for a new stream
+     *
+     * @param InMinTargetDelay - Lowest target depth in seconds
+     * @param InMaxTargetDelay - Highest target depth in seconds
+     */
+    void Reset(double InMinTargetDelay, double InMaxTargetDelay);
+
+    /**
+     * Insert a received chunk
+     *
+     * @param Chunk - The chunk to insert
+     * @param ArrivalTime - Local time the chunk arrived, in seconds
+     * @return bool - False if the chunk was dropped as late or duplicate
+     */
+    bool Insert(FMetaHumanStreamChunk&& Chunk, double ArrivalTime);
+
+    /**
+     * Release the chunks that should be handed to the sinks now
+     *
+     * Chunks are released in sequence order. Before playback starts and after an underrun,
+     * nothing is released until the buffered audio reaches the target depth (or the stream
+     * has ended).
+     *
+     * @param SinkBufferedSeconds - Seconds of audio already handed to the sink and not yet played
+     * @param bStreamEnded - Whether the sender has ended the stream
+     * @param OutChunks - Receives the released chunks in order
+     */
+    void Pop(double SinkBufferedSeconds, bool bStreamEnded, TArray<FMetaHumanStreamChunk>& OutChunks);
+
+    /**
+     * Check whether the buffer holds no chunks
+     *
+     * @return bool - True if the buffer is empty
+     */
+    bool IsEmpty() const { return Chunks.Num() == 0; }
+
+    /**
+     * Get the current state of the buffer
+     *
+     * @return FMetaHumanJitterBufferStats - Jitter, depth and loss counters
+     */
+    FMetaHumanJitterBufferStats GetStats() const;
+
+private:
+    // Chunks held for playout, sorted by sequence number
+    TArray<FMetaHumanStreamChunk> Chunks;
+
+    // Sequence number of the next chunk to release
+    int32 NextSequence;
+
+    // Bounds of the target depth
+    double MinTargetDelay;
+    double MaxTargetDelay;
+
+    // Extra depth added after underruns; decays as chunks arrive on time
+    double UnderrunDelay;
+
+    // Smoothed inter-arrival jitter in seconds
+    double Jitter;
+
+    // Arrival and stream time of the previous chunk, for the jitter estimate
+    double LastArrivalTime;
+    double LastTimestamp;
+    bool bHasLastArrival;
+
+    // Flag indicating whether the sink is being fed (false while pre-buffering or re-buffering)
+    bool bPlaying;
+
+    // Flag indicating whether any chunk has been released for this stream
+    bool bHasReleased;
+
+    // Loss counters
+    int32 Underruns;
+    int32 LateDrops;
+    int32 LostChunks;
+
+    /**
+     * Get the depth the buffer currently aims for
+     *
+     * @return double - Target depth in seconds
+     */
+    double GetTargetDelay() const;
+
+    /**
+     * Get the seconds of audio held in the buffer
+     *
+     * @return double - Buffered audio in seconds
+     */
+    double GetHeldSeconds() const;
+
+    /**
+     * Get the seconds of audio held in contiguous chunks starting at NextSequence
+     *
+     * @return double - Contiguous buffered audio in seconds
+     */
+    double GetContiguousSeconds() const;
+};
@@ -0,0 +1,452 @@
+/**
+ * MetaHumanMessageParser.cpp
+ *
+ * Implementation of FMetaHumanMessageParser, which parses backend messages in a single
+ * pass over the JSON token stream.
+ */
+
+#include "MetaHumanMessageParser.h"
+#include "MetaHumanIngestPipeline.h"
+#include "MetaHumanBlendshapeCodec.h"
+#include "MetaHumanBase64.h"
+#include "Serialization/JsonReader.h"
+
+namespace MetaHumanMessageParser
+{
+    typedef TJsonReader<TCHAR> FReader;
+
+    /**
+     * Skip the value whose first token was just read
+     */
+    bool SkipValue(FReader& Reader, EJsonNotation Notation)
+    {
+        switch (Notation)
+        {
+        case EJsonNotation::ObjectStart:
+            return Reader.SkipObject();
+        case EJsonNotation::ArrayStart:
+            return Reader.SkipArray();
+        case EJsonNotation::Error:
+            return false;
+        default:
+            return true;
+        }
+    }
+
+    /**
+     * Read the channel values of the first frame, which defines the channel table
+     */
+    bool ParseFirstFrameChannels(FReader& Reader, float FrameRate, FBlendshapeTimeline& Timeline)
+    {
+        TArray<FString> ChannelNames;
+        TArray<float, TInlineAllocator<256>> Values;
+
+        EJsonNotation Notation;
+        while (Reader.ReadNext(Notation))
+        {
+            if (Notation == EJsonNotation::ObjectEnd)
+            {
+                Timeline.Reset(MoveTemp(ChannelNames), FrameRate);
+                if (Values.Num() > 0)
+                {
+                    FMemory::Memcpy(Timeline.AddFrame().GetData(), Values.GetData(), Values.Num() * sizeof(float));
+                }
+                return true;
+            }
+            if (Notation != EJsonNotation::Number)
+            {
+                if (!SkipValue(Reader, Notation))
+                {
+                    return false;
+                }
+                continue;
+            }
+
+            // Repeated keys keep the last value, as in the DOM
+            const int32 ChannelIndex = ChannelNames.IndexOfByKey(Reader.GetIdentifier());
+            if (ChannelIndex == INDEX_NONE)
+            {
+                ChannelNames.Add(Reader.GetIdentifier());
+                Values.Add((float)Reader.GetValueAsNumber());
+            }
+            else
+            {
+                Values[ChannelIndex] = (float)Reader.GetValueAsNumber();
+            }
+        }
+        return false;
+    }
+
+    /**
+     * Read the channel values of a later frame straight into a new timeline row
+     */
+    bool ParseFrameChannels(FReader& Reader, FBlendshapeTimeline& Timeline)
+    {
+        Timeline.AddFrame();
+        const int32 RowIndex = Timeline.GetNumFrames() - 1;
+        TArrayView<float> Row = Timeline.GetMutableRow(RowIndex);
+
+        // Frames normally list their channels in the same order, so try the next column first
+        int32 ExpectedChannel = 0;
+
+        EJsonNotation Notation;
+        while (Reader.ReadNext(Notation))
+        {
+            if (Notation == EJsonNotation::ObjectEnd)
+            {
+                return true;
+            }
+            if (Notation != EJsonNotation::Number)
+            {
+                if (!SkipValue(Reader, Notation))
+                {
+                    return false;
+                }
+                continue;
+            }
+
+            const FString& ChannelName = Reader.GetIdentifier();
+            int32 ChannelIndex = ExpectedChannel;
+            if (!Timeline.ChannelNames.IsValidIndex(ChannelIndex) || !Timeline.ChannelNames[ChannelIndex].Equals(ChannelName, ESearchCase::CaseSensitive))
+            {
+                ChannelIndex = Timeline.FindChannel(ChannelName);
+                if (ChannelIndex == INDEX_NONE)
+                {
+                    ChannelIndex = Timeline.AddChannel(ChannelName);
+                    Row = Timeline.GetMutableRow(RowIndex);
+                }
+            }
+            Row[ChannelIndex] = (float)Reader.GetValueAsNumber();
+            ExpectedChannel = ChannelIndex + 1;
+        }
+        return false;
+    }
+
+    /**
+     * Read one element of the frames array
+     */
+    bool ParseFrame(FReader& Reader, float FrameRate, FBlendshapeTimeline& Timeline)
+    {
+        EJsonNotation Notation;
+        while (Reader.ReadNext(Notation))
+        {
+            if (Notation == EJsonNotation::ObjectEnd)
+            {
+                return true;
+            }
+            if (Notation == EJsonNotation::ObjectStart && Reader.GetIdentifier() == TEXT("blendshapes"))
+            {
+                const bool bParsed = Timeline.GetNumChannels() == 0
+                    ? ParseFirstFrameChannels(Reader, FrameRate, Timeline)
+                    : ParseFrameChannels(Reader, Timeline);
+                if (!bParsed)
+                {
+                    return false;
+                }
+            }
+            else if (!SkipValue(Reader, Notation))
+            {
+                return false;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * Read the frames array, whose start token was just read
+     */
+    bool ParseFrames(FReader& Reader, float FrameRate, FBlendshapeTimeline& Timeline)
+    {
+        Timeline.Reset(TArray<FString>(), FrameRate);
+
+        EJsonNotation Notation;
+        while (Reader.ReadNext(Notation))
+        {
+            if (Notation == EJsonNotation::ArrayEnd)
+            {
+                return true;
+            }
+            if (Notation == EJsonNotation::ObjectStart)
+            {
+                if (!ParseFrame(Reader, FrameRate, Timeline))
+                {
+                    return false;
+                }
+            }
+            else if (!SkipValue(Reader, Notation))
+            {
+                return false;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * Read a blendshapes value, whose start token was just read: an object with a "frames"
+     * array or the frames array itself
+     */
+    bool ParseBlendshapesValue(FReader& Reader, EJsonNotation StartNotation, float FrameRate, FBlendshapeTimeline& Timeline)
+    {
+        if (StartNotation == EJsonNotation::ArrayStart)
+        {
+            return ParseFrames(Reader, FrameRate, Timeline);
+        }
+        if (StartNotation != EJsonNotation::ObjectStart)
+        {
+            return false;
+        }
+
+        EJsonNotation Notation;
+        while (Reader.ReadNext(Notation))
+        {
+            if (Notation == EJsonNotation::ObjectEnd)
+            {
+                return true;
+            }
+            if (Notation == EJsonNotation::ArrayStart && Reader.GetIdentifier() == TEXT("frames"))
+            {
+                if (!ParseFrames(Reader, FrameRate, Timeline))
+                {
+                    return false;
+                }
+            }
+            else if (!SkipValue(Reader, Notation))
+            {
+                return false;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * Decode a base64 binary blendshape payload
+     */
+    bool DecodeBinaryBlendshapes(const FString& BlendshapeBinaryBase64, FBlendshapeTimeline& OutTimeline)
+    {
+        TArray<uint8> BlendshapeBytes;
+        if (!FMetaHumanBase64::Decode(BlendshapeBinaryBase64, BlendshapeBytes))
+        {
+            UE_LOG(LogTemp, Error, TEXT("Failed to decode base64 blendshape payload"));
+            return false;
+        }
+        return FMetaHumanBlendshapeCodec::Decode(BlendshapeBytes, OutTimeline);
+    }
+}
+
+bool FMetaHumanMessageParser::ParseMessage(const FString& Message, float DefaultFrameRate, FMetaHumanIngestResult& OutResult)
+{
+    using namespace MetaHumanMessageParser;
+
+    const double StartTime = FPlatformTime::Seconds();
+    FMetaHumanIngestTimings& Timings = OutResult.Timings;
+
+    // Fields are captured as they stream past; the type may appear anywhere in the object
+    FString MessageType;
+    bool bHasUtteranceAudio = false;
+    bool bHasChunkAudio = false;
+    bool bHasBlendshapes = false;
+    bool bHasBinaryBlendshapes = false;
+    bool bHasSampleRate = false;
+    bool bHasSequence = false;
+    bool bHasTimestamp = false;
+    bool bHasFrameRate = false;
+    double StreamFrameRate = DefaultFrameRate;
+    FString CodecName;
+
+    TSharedRef<FReader> Reader = TJsonReaderFactory<TCHAR>::CreateFromView(Message);
+    EJsonNotation Notation;
+    if (!Reader->ReadNext(Notation) || Notation != EJsonNotation::ObjectStart)
+    {
+        UE_LOG(LogTemp, Error, TEXT("Failed to parse message as JSON"));
+        return false;
+    }
+
+    bool bClosed = false;
+    while (!bClosed && Reader->ReadNext(Notation))
+    {
+        const FString& Key = Reader->GetIdentifier();
+        switch (Notation)
+        {
+        case EJsonNotation::ObjectEnd:
+            bClosed = true;
+            break;
+        case EJsonNotation::String:
+            if (Key == TEXT("type"))
+            {
+                MessageType = Reader->GetValueAsString();
+            }
+            else if (Key == TEXT("codec"))
+            {
+                CodecName = Reader->GetValueAsString();
+            }
+            else if (Key == TEXT("character"))
+            {
+                OutResult.CharacterId = Reader->GetValueAsString();
+            }
+            else if (Key == TEXT("audio_base64") || Key == TEXT("audio_pcm_base64") || Key == TEXT("audio_opus_base64"))
+            {
+                // Decode straight from the tokenizer's string, without copying it out first
+                const double AudioStartTime = FPlatformTime::Seconds();
+                const bool bDecoded = FMetaHumanIngestPipeline::DecodeAudioBase64(Reader->GetValueAsString(), OutResult.AudioData);
+                Timings.AudioDecodeSeconds += FPlatformTime::Seconds() - AudioStartTime;
+                if (!bDecoded)
+                {
+                    return false;
+                }
+                bHasUtteranceAudio |= Key == TEXT("audio_base64");
+                bHasChunkAudio |= Key != TEXT("audio_base64");
+            }
+            else if (Key == TEXT("blendshapes_binary"))
+            {
+                const double BlendshapeStartTime = FPlatformTime::Seconds();
+                const bool bDecoded = DecodeBinaryBlendshapes(Reader->GetValueAsString(), OutResult.BlendshapeTimeline);
+                Timings.BlendshapeDecodeSeconds += FPlatformTime::Seconds() - BlendshapeStartTime;
+                if (!bDecoded)
+                {
+                    return false;
+                }
+                bHasBlendshapes = bHasBinaryBlendshapes = true;
+            }
+            break;
+        case EJsonNotation::Number:
+            if (Key == TEXT("sequence"))
+            {
+                OutResult.Sequence = (int32)Reader->GetValueAsNumber();
+                bHasSequence = true;
+            }
+            else if (Key == TEXT("timestamp"))
+            {
+                OutResult.Timestamp = Reader->GetValueAsNumber();
+                bHasTimestamp = true;
+            }
+            else if (Key == TEXT("sample_rate"))
+            {
+                OutResult.SampleRate = (int32)Reader->GetValueAsNumber();
+                bHasSampleRate = true;
+            }
+            else if (Key == TEXT("num_channels"))
+            {
+                OutResult.NumChannels = (int32)Reader->GetValueAsNumber();
+            }
+            else if (Key == TEXT("frame_rate"))
+            {
+                StreamFrameRate = Reader->GetValueAsNumber();
+                bHasFrameRate = StreamFrameRate > 0.0;
+            }
+            break;
+        case EJsonNotation::ObjectStart:
+        case EJsonNotation::ArrayStart:
+            // The binary payload wins over the JSON frames when the sender provides both
+            if (Key == TEXT("blendshapes") && !bHasBinaryBlendshapes)
+            {
+                const double BlendshapeStartTime = FPlatformTime::Seconds();
+                const bool bParsed = ParseBlendshapesValue(*Reader, Notation, DefaultFrameRate, OutResult.BlendshapeTimeline);
+                Timings.BlendshapeDecodeSeconds += FPlatformTime::Seconds() - BlendshapeStartTime;
+                if (!bParsed)
+                {
+                    UE_LOG(LogTemp, Error, TEXT("Failed to parse blendshape JSON data: %s"), *Reader->GetErrorMessage());
+                    return false;
+                }
+                bHasBlendshapes = true;
+            }
+            else if (!SkipValue(*Reader, Notation))
+            {
+                UE_LOG(LogTemp, Error, TEXT("Failed to parse message as JSON: %s"), *Reader->GetErrorMessage());
+                return false;
+            }
+            break;
+        default:
+            break;
+        }
+    }
+
+    // Whatever was not spent decoding audio or blendshapes was spent tokenizing the envelope
+    Timings.ParseSeconds += FPlatformTime::Seconds() - StartTime - Timings.AudioDecodeSeconds - Timings.BlendshapeDecodeSeconds;
+
+    if (!bClosed)
+    {
+        UE_LOG(LogTemp, Error, TEXT("Failed to parse message as JSON: %s"), *Reader->GetErrorMessage());
+        return false;
+    }
+
+    // The frame rate may follow the blendshapes, so the message's own rate is applied once it is known
+    if (bHasFrameRate && bHasBlendshapes && !bHasBinaryBlendshapes)
+    {
+        OutResult.BlendshapeTimeline.FrameRate = (float)StreamFrameRate;
+    }
+
+    if (MessageType.IsEmpty())
+    {
+        OutResult.Type = EMetaHumanIngestMessageType::Utterance;
+        if (!bHasUtteranceAudio)
+        {
+            UE_LOG(LogTemp, Error, TEXT("Message does not contain audio_base64"));
+            return false;
+        }
+        if (!bHasBlendshapes)
+        {
+            UE_LOG(LogTemp, Error, TEXT("Message does not contain blendshape data"));
+            return false;
+        }
+        return !OutResult.BlendshapeTimeline.IsEmpty();
+    }
+
+    if (MessageType == TEXT("stream_start"))
+    {
+        OutResult.Type = EMetaHumanIngestMessageType::StreamStart;
+        if (!bHasSampleRate || OutResult.SampleRate <= 0)
+        {
+            UE_LOG(LogTemp, Error, TEXT("stream_start message is missing a valid sample_rate"));
+            return false;
+        }
+        OutResult.FrameRate = (float)StreamFrameRate;
+        return FMetaHumanIngestPipeline::ParseCodecName(CodecName, OutResult.AudioCodec);
+    }
+
+    if (MessageType == TEXT("stream_chunk"))
+    {
+        OutResult.Type = EMetaHumanIngestMessageType::StreamChunk;
+        if (!bHasSequence || !bHasTimestamp)
+        {
+            UE_LOG(LogTemp, Error, TEXT("stream_chunk message is missing sequence or timestamp"));
+            return false;
+        }
+
+        // Only the chunk's PCM or Opus field carries chunk audio
+        if (!bHasChunkAudio)
+        {
+            OutResult.AudioData.Reset();
+        }
+        return true;
+    }
+
+    if (MessageType == TEXT("stream_end"))
+    {
+        OutResult.Type = EMetaHumanIngestMessageType::StreamEnd;
+        return true;
+    }
+
+    if (MessageType == TEXT("interrupt"))
+    {
+        OutResult.Type = EMetaHumanIngestMessageType::Interrupt;
+        return true;
+    }
+
+    UE_LOG(LogTemp, Warning, TEXT("Unknown message type: %s"), *MessageType);
+    return false;
+}
+
+bool FMetaHumanMessageParser::ParseBlendshapes(const FString& BlendshapeJSON, float FrameRate, FBlendshapeTimeline& OutTimeline)
+{
+    using namespace MetaHumanMessageParser;
+
+    TSharedRef<FReader> Reader = TJsonReaderFactory<TCHAR>::CreateFromView(BlendshapeJSON);
+    EJsonNotation Notation;
+    if (!Reader->ReadNext(Notation) || !ParseBlendshapesValue(*Reader, Notation, FrameRate, OutTimeline))
+    {
+        UE_LOG(LogTemp, Error, TEXT("Failed to parse blendshape JSON data: %s"), *Reader->GetErrorMessage());
+        return false;
+    }
+
+    return !OutTimeline.IsEmpty();
+}
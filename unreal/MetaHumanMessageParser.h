@@ -0,0 +1,53 @@
+/**
+ * MetaHumanMessageParser.h
+ *
+ * This header file defines FMetaHumanMessageParser, a single-pass parser for backend
+ * messages built on the streaming TJsonReader tokenizer.
+ *
+ * Libraries/Modules used:
+ * - CoreMinimal.h: Core Unreal Engine functionality
+ * - Json: JSON tokenizer
+ *
+ * The DOM path deserializes a message into an FJsonObject, serializes the "blendshapes"
+ * object back to a string and deserializes it again before copying values into the
+ * timeline. This parser reads the message text once and writes every blendshape value
+ * straight into the timeline's weight matrix, without building a DOM.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Forward declarations
+struct FBlendshapeTimeline;
+struct FMetaHumanIngestResult;
+
+/**
+ * Single-pass tokenizer-based parser for backend messages
+ */
+class METAHUMANSTREAMING_API FMetaHumanMessageParser
+{
+public:
+    /**
+     * Parse a complete message
+     *
+     * Accepts the same messages as FMetaHumanIngestPipeline::DecodeMessageObject. The
+     * "blendshapes" field may be an object with a "frames" array or the frames array itself.
+     *
+     * @param Message - The JSON message text
+     * @param DefaultFrameRate - Frame rate assumed for JSON blendshapes when the message has no frame_rate
+     * @param OutResult - Receives the decoded message
+     * @return bool - True if the message was parsed and decoded
+     */
+    static bool ParseMessage(const FString& Message, float DefaultFrameRate, FMetaHumanIngestResult& OutResult);
+
+    /**
+     * Parse blendshape data
+     *
+     * @param BlendshapeJSON - JSON object with a "frames" array, or the frames array itself
+     * @param FrameRate - Frame rate of the blendshape frames
+     * @param OutTimeline - Receives the parsed blendshape frames
+     * @return bool - True if at least one frame was parsed
+     */
+    static bool ParseBlendshapes(const FString& BlendshapeJSON, float FrameRate, FBlendshapeTimeline& OutTimeline);
+};
@@ -0,0 +1,283 @@
+/**
+ * MetaHumanOpus.cpp
+ *
+ * Implementation of FMetaHumanOpusPackets, FMetaHumanOpusDecoder and FMetaHumanOpusEncoder,
+ * and of the MetaHuman.OpusLoopback console command.
+ */
+
+#include "MetaHumanOpus.h"
+#include "MetaHumanStreamingStats.h"
+#include "HAL/IConsoleManager.h"
+
+THIRD_PARTY_INCLUDES_START
+#include "opus.h"
+THIRD_PARTY_INCLUDES_END
+
+DECLARE_CYCLE_STAT(TEXT("Opus Decode"), STAT_MetaHumanOpusDecode, STATGROUP_MetaHumanStreaming);
+
+namespace MetaHumanOpus
+{
+    // Largest packet the encoder writes; 20 ms of voice is far smaller
+    constexpr int32 MaxPacketSize = 1500;
+
+    /**
+     * Encode and decode a generated voice-band signal and log latency and throughput
+     */
+    void RunLoopback(const TArray<FString>& Args)
+    {
+        const int32 SampleRate = 48000;
+        const int32 Seconds = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 10;
+        const int32 Bitrate = Args.Num() > 1 ? FMath::Max(FCString::Atoi(*Args[1]), 6000) : 24000;
+
+        FMetaHumanOpusEncoder Encoder;
+        FMetaHumanOpusDecoder Decoder;
+        if (!Encoder.Initialize(SampleRate, 1, Bitrate) || !Decoder.Initialize(SampleRate, 1))
+        {
+            return;
+        }
+
+        // A sum of tones with a syllable-rate envelope, standing in for speech
+        const int32 FrameSize = Encoder.GetFrameSize();
+        const int32 NumPackets = Seconds * 1000 / FMetaHumanOpusEncoder::FrameMilliseconds;
+        TArray<int16> Signal;
+        Signal.SetNumUninitialized(NumPackets * FrameSize);
+        for (int32 SampleIndex = 0; SampleIndex < Signal.Num(); SampleIndex++)
+        {
+            const float Time = (float)SampleIndex / SampleRate;
+            const float Envelope = 0.5f + 0.5f * FMath::Sin(2.0f * PI * 4.0f * Time);
+            const float Tones = 0.5f * FMath::Sin(2.0f * PI * 220.0f * Time) + 0.3f * FMath::Sin(2.0f * PI * 660.0f * Time) + 0.2f * FMath::Sin(2.0f * PI * 1800.0f * Time);
+            Signal[SampleIndex] = (int16)(Envelope * Tones * 16000.0f);
+        }
+
+        // Encode every packet into one chunk payload, as a sender would
+        TArray<uint8> Payload;
+        const double EncodeStartTime = FPlatformTime::Seconds();
+        for (int32 PacketIndex = 0; PacketIndex < NumPackets; PacketIndex++)
+        {
+            if (!Encoder.EncodeFrame(TConstArrayView<int16>(Signal.GetData() + PacketIndex * FrameSize, FrameSize), Payload))
+            {
+                return;
+            }
+        }
+        const double EncodeSeconds = FPlatformTime::Seconds() - EncodeStartTime;
+
+        // Decode it back the way the receiver does
+        TArray<TConstArrayView<uint8>> Packets;
+        TArray<uint8> PCM;
+        PCM.Reserve(Signal.Num() * sizeof(int16));
+        const double DecodeStartTime = FPlatformTime::Seconds();
+        if (!FMetaHumanOpusPackets::Split(Payload, Packets))
+        {
+            return;
+        }
+        double WorstPacketSeconds = 0.0;
+        for (const TConstArrayView<uint8>& Packet : Packets)
+        {
+            const double PacketStartTime = FPlatformTime::Seconds();
+            if (Decoder.DecodePacket(Packet, PCM) == INDEX_NONE)
+            {
+                return;
+            }
+            WorstPacketSeconds = FMath::Max(WorstPacketSeconds, FPlatformTime::Seconds() - PacketStartTime);
+        }
+        const double DecodeSeconds = FPlatformTime::Seconds() - DecodeStartTime;
+
+        // A packet can be played once it is complete and decoded; the look-ahead delays its content further
+        const double PacketMs = FMetaHumanOpusEncoder::FrameMilliseconds;
+        const double LookaheadMs = Encoder.GetLookahead() * 1000.0 / SampleRate;
+        const double PCMBytes = Signal.Num() * sizeof(int16);
+        UE_LOG(LogTemp, Display, TEXT("Opus loopback: %d s at %d bps, %d packets, %d bytes (%.1fx smaller than PCM, %.1fx smaller than base64 PCM)"),
+            Seconds, Bitrate, Packets.Num(), Payload.Num(), PCMBytes / Payload.Num(), PCMBytes * 4.0 / 3.0 / Payload.Num());
+        UE_LOG(LogTemp, Display, TEXT("Opus loopback: encode %.0fx real time, decode %.0fx real time, worst packet decode %.3f ms"),
+            Seconds / EncodeSeconds, Seconds / DecodeSeconds, WorstPacketSeconds * 1000.0);
+        UE_LOG(LogTemp, Display, TEXT("Opus loopback: codec latency %.1f ms (%.0f ms packet + %.1f ms look-ahead + %.3f ms decode)"),
+            PacketMs + LookaheadMs + WorstPacketSeconds * 1000.0, PacketMs, LookaheadMs, WorstPacketSeconds * 1000.0);
+    }
+
+    FAutoConsoleCommand OpusLoopbackCommand(
+        TEXT("MetaHuman.OpusLoopback"),
+        TEXT("Encode and decode a generated signal with the stream's Opus settings and log latency and throughput. Args: [Seconds=10] [Bitrate=24000]"),
+        FConsoleCommandWithArgsDelegate::CreateStatic(&RunLoopback));
+}
+
+bool FMetaHumanOpusPackets::Split(TConstArrayView<uint8> Payload, TArray<TConstArrayView<uint8>>& OutPackets)
+{
+    OutPackets.Reset();
+
+    int32 Offset = 0;
+    while (Offset + (int32)sizeof(uint16) <= Payload.Num())
+    {
+        uint16 PacketSize;
+        FMemory::Memcpy(&PacketSize, Payload.GetData() + Offset, sizeof(uint16));
+        Offset += sizeof(uint16);
+        if (Offset + PacketSize > Payload.Num())
+        {
+            UE_LOG(LogTemp, Error, TEXT("Opus packet of %d bytes runs past the end of its chunk"), PacketSize);
+            return false;
+        }
+
+        OutPackets.Add(Payload.Slice(Offset, PacketSize));
+        Offset += PacketSize;
+    }
+
+    return Offset == Payload.Num();
+}
+
+void FMetaHumanOpusPackets::Append(TConstArrayView<uint8> Packet, TArray<uint8>& OutPayload)
+{
+    check(Packet.Num() <= MAX_uint16);
+    const uint16 PacketSize = (uint16)Packet.Num();
+    OutPayload.Append(reinterpret_cast<const uint8*>(&PacketSize), sizeof(uint16));
+    OutPayload.Append(Packet.GetData(), Packet.Num());
+}
+
+int32 FMetaHumanOpusPackets::GetNumFrames(TConstArrayView<uint8> Packet, int32 SampleRate)
+{
+    const int32 NumFrames = opus_packet_get_nb_samples(Packet.GetData(), Packet.Num(), SampleRate);
+    return NumFrames < 0 ? INDEX_NONE : NumFrames;
+}
+
+FMetaHumanOpusDecoder::~FMetaHumanOpusDecoder()
+{
+    Reset();
+}
+
+bool FMetaHumanOpusDecoder::Initialize(int32 InSampleRate, int32 InNumChannels)
+{
+    Reset();
+
+    int Error = OPUS_OK;
+    Decoder = opus_decoder_create(InSampleRate, InNumChannels, &Error);
+    if (Error != OPUS_OK || !Decoder)
+    {
+        UE_LOG(LogTemp, Error, TEXT("Failed to create Opus decoder (%d Hz, %d channels): %hs"), InSampleRate, InNumChannels, opus_strerror(Error));
+        Decoder = nullptr;
+        return false;
+    }
+
+    SampleRate = InSampleRate;
+    NumChannels = InNumChannels;
+    return true;
+}
+
+void FMetaHumanOpusDecoder::Reset()
+{
+    if (Decoder)
+    {
+        opus_decoder_destroy(Decoder);
+        Decoder = nullptr;
+    }
+}
+
+int32 FMetaHumanOpusDecoder::DecodePacket(TConstArrayView<uint8> Packet, TArray<uint8>& OutPCM)
+{
+    SCOPE_CYCLE_COUNTER(STAT_MetaHumanOpusDecode);
+    check(Decoder);
+
+    // Decode straight into the end of the output, then trim to what was produced
+    const int32 StartSize = OutPCM.Num();
+    const int32 BytesPerFrame = sizeof(int16) * NumChannels;
+    OutPCM.AddUninitialized(MaxFrameSize * BytesPerFrame);
+    const int32 NumFrames = opus_decode(Decoder, Packet.GetData(), Packet.Num(), reinterpret_cast<opus_int16*>(OutPCM.GetData() + StartSize), MaxFrameSize, 0);
+    if (NumFrames < 0)
+    {
+        OutPCM.SetNum(StartSize, false);
+        UE_LOG(LogTemp, Error, TEXT("Failed to decode Opus packet: %hs"), opus_strerror(NumFrames));
+        return INDEX_NONE;
+    }
+
+    OutPCM.SetNum(StartSize + NumFrames * BytesPerFrame, false);
+    return NumFrames;
+}
+
+void FMetaHumanOpusDecoder::ConcealLoss(int32 NumFrames, TArray<uint8>& OutPCM)
+{
+    SCOPE_CYCLE_COUNTER(STAT_MetaHumanOpusDecode);
+    check(Decoder);
+
+    // Concealment works in whole 2.5 ms steps, at most 120 ms per call
+    const int32 BytesPerFrame = sizeof(int16) * NumChannels;
+    const int32 StepFrames = SampleRate / 400;
+    const int32 MaxConcealFrames = SampleRate * 120 / 1000;
+    int32 RemainingFrames = NumFrames;
+    while (RemainingFrames >= StepFrames)
+    {
+        int32 ConcealFrames = FMath::Min(RemainingFrames, MaxConcealFrames);
+        ConcealFrames -= ConcealFrames % StepFrames;
+
+        const int32 StartSize = OutPCM.Num();
+        OutPCM.AddUninitialized(ConcealFrames * BytesPerFrame);
+        const int32 DecodedFrames = opus_decode(Decoder, nullptr, 0, reinterpret_cast<opus_int16*>(OutPCM.GetData() + StartSize), ConcealFrames, 0);
+        if (DecodedFrames != ConcealFrames)
+        {
+            OutPCM.SetNum(StartSize, false);
+            UE_LOG(LogTemp, Warning, TEXT("Opus packet loss concealment failed: %hs"), DecodedFrames < 0 ? opus_strerror(DecodedFrames) : "short output");
+            break;
+        }
+        RemainingFrames -= ConcealFrames;
+    }
+
+    // Whatever is left, including less than one step, is silence
+    OutPCM.AddZeroed(RemainingFrames * BytesPerFrame);
+}
+
+FMetaHumanOpusEncoder::~FMetaHumanOpusEncoder()
+{
+    if (Encoder)
+    {
+        opus_encoder_destroy(Encoder);
+    }
+}
+
+bool FMetaHumanOpusEncoder::Initialize(int32 InSampleRate, int32 InNumChannels, int32 Bitrate)
+{
+    if (Encoder)
+    {
+        opus_encoder_destroy(Encoder);
+        Encoder = nullptr;
+    }
+
+    int Error = OPUS_OK;
+    Encoder = opus_encoder_create(InSampleRate, InNumChannels, OPUS_APPLICATION_VOIP, &Error);
+    if (Error != OPUS_OK || !Encoder)
+    {
+        UE_LOG(LogTemp, Error, TEXT("Failed to create Opus encoder (%d Hz, %d channels): %hs"), InSampleRate, InNumChannels, opus_strerror(Error));
+        Encoder = nullptr;
+        return false;
+    }
+
+    opus_encoder_ctl(Encoder, OPUS_SET_BITRATE(Bitrate));
+    opus_encoder_ctl(Encoder, OPUS_SET_SIGNAL(OPUS_SIGNAL_VOICE));
+    SampleRate = InSampleRate;
+    NumChannels = InNumChannels;
+    return true;
+}
+
+bool FMetaHumanOpusEncoder::EncodeFrame(TConstArrayView<int16> PCM, TArray<uint8>& OutPayload)
+{
+    using namespace MetaHumanOpus;
+
+    check(Encoder);
+    check(PCM.Num() == GetFrameSize() * NumChannels);
+
+    uint8 Packet[MaxPacketSize];
+    const int32 PacketSize = opus_encode(Encoder, PCM.GetData(), GetFrameSize(), Packet, MaxPacketSize);
+    if (PacketSize < 0)
+    {
+        UE_LOG(LogTemp, Error, TEXT("Failed to encode Opus frame: %hs"), opus_strerror(PacketSize));
+        return false;
+    }
+
+    FMetaHumanOpusPackets::Append(TConstArrayView<uint8>(Packet, PacketSize), OutPayload);
+    return true;
+}
+
+int32 FMetaHumanOpusEncoder::GetLookahead() const
+{
+    opus_int32 Lookahead = 0;
+    if (Encoder)
+    {
+        opus_encoder_ctl(Encoder, OPUS_GET_LOOKAHEAD(&Lookahead));
+    }
+    return Lookahead;
+}
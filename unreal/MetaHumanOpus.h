@@ -0,0 +1,214 @@
+/**
+ * MetaHumanOpus.h
+ *
+ * This header file defines the Opus codec support used for streamed audio:
+ * FMetaHumanOpusDecoder and FMetaHumanOpusEncoder, thin stateful wrappers over libopus, and
+ * FMetaHumanOpusPackets, the framing of Opus packets inside a stream chunk.
+ *
+ * Libraries/Modules used:
+ * - CoreMinimal.h: Core Unreal Engine functionality
+ * - libOpus: Opus encoding and decoding (engine third-party module)
+ *
+ * A chunk of an Opus stream carries one or more packets, each preceded by its size:
+ * - uint16 PacketSize       Size of the packet in bytes (little-endian)
+ * - uint8  Packet[PacketSize]
+ * Senders use 20 ms packets. Packets must be decoded in stream order, so the receiver
+ * decodes them as the jitter buffer releases them rather than on the ingest workers.
+ *
+ * The console command MetaHuman.OpusLoopback encodes and decodes a generated signal
+ * locally and logs the codec latency and throughput, without any external service.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MetaHumanOpus.generated.h"
+
+// Forward declarations
+struct OpusDecoder;
+struct OpusEncoder;
+
+/**
+ * Codec of streamed audio
+ *
+ * UENUM: Unreal Engine macro for defining an enum that can be used in Blueprint
+ */
+UENUM(BlueprintType)
+enum class EMetaHumanAudioCodec : uint8
+{
+    // 16-bit interleaved PCM
+    PCM,
+
+    // Length-prefixed Opus packets
+    Opus
+};
+
+/**
+ * Framing of Opus packets inside a stream chunk
+ */
+class METAHUMANSTREAMING_API FMetaHumanOpusPackets
+{
+public:
+    /**
+     * Split a chunk's audio into its packets
+     *
+     * @param Payload - Length-prefixed packets
+     * @param OutPackets - Receives views of the packets within Payload
+     * @return bool - False if a packet runs past the end of the payload
+     */
+    static bool Split(TConstArrayView<uint8> Payload, TArray<TConstArrayView<uint8>>& OutPackets);
+
+    /**
+     * Append a packet to a chunk's audio
+     *
+     * @param Packet - The Opus packet
+     * @param OutPayload - Chunk audio the length-prefixed packet is appended to
+     */
+    static void Append(TConstArrayView<uint8> Packet, TArray<uint8>& OutPayload);
+
+    /**
+     * Get the number of frames (samples per channel) a packet decodes to
+     *
+     * @param Packet - The Opus packet
+     * @param SampleRate - Sample rate the packet will be decoded at
+     * @return int32 - Number of frames, or INDEX_NONE if the packet is invalid
+     */
+    static int32 GetNumFrames(TConstArrayView<uint8> Packet, int32 SampleRate);
+};
+
+/**
+ * Stateful decoder of a single Opus stream
+ */
+class METAHUMANSTREAMING_API FMetaHumanOpusDecoder
+{
+public:
+    // Largest frame an Opus packet can hold (120 ms at 48 kHz)
+    static constexpr int32 MaxFrameSize = 5760;
+
+    FMetaHumanOpusDecoder() = default;
+    ~FMetaHumanOpusDecoder();
+
+    FMetaHumanOpusDecoder(const FMetaHumanOpusDecoder&) = delete;
+    FMetaHumanOpusDecoder& operator=(const FMetaHumanOpusDecoder&) = delete;
+
+    /**
+     * Create the decoder state for a stream
+     *
+     * @param InSampleRate - Output sample rate: 8000, 12000, 16000, 24000 or 48000
+     * @param InNumChannels - Number of channels (1 or 2)
+     * @return bool - True if the decoder was created
+     */
+    bool Initialize(int32 InSampleRate, int32 InNumChannels);
+
+    /**
+     * Release the decoder state
+     */
+    void Reset();
+
+    /**
+     * Decode one packet and append its PCM
+     *
+     * @param Packet - The Opus packet
+     * @param OutPCM - Receives the decoded 16-bit interleaved PCM, appended
+     * @return int32 - Number of frames decoded, or INDEX_NONE if the packet is invalid
+     */
+    int32 DecodePacket(TConstArrayView<uint8> Packet, TArray<uint8>& OutPCM);
+
+    /**
+     * Conceal lost audio and append its PCM
+     *
+     * Call this in stream order in place of the lost packets; the decoder extrapolates the
+     * audio from its state, which it carries on smoothly into the next packet. Audio that
+     * cannot be concealed is filled with silence.
+     *
+     * @param NumFrames - Number of frames (samples per channel) that were lost
+     * @param OutPCM - Receives NumFrames frames of 16-bit interleaved PCM, appended
+     */
+    void ConcealLoss(int32 NumFrames, TArray<uint8>& OutPCM);
+
+    /**
+     * Check whether the decoder has been initialized
+     *
+     * @return bool - True if packets can be decoded
+     */
+    bool IsInitialized() const { return Decoder != nullptr; }
+
+    /**
+     * Get the output sample rate
+     *
+     * @return int32 - Sample rate in Hz
+     */
+    int32 GetSampleRate() const { return SampleRate; }
+
+    /**
+     * Get the number of channels of the stream
+     *
+     * @return int32 - Number of channels
+     */
+    int32 GetNumChannels() const { return NumChannels; }
+
+private:
+    // libopus decoder state
+    OpusDecoder* Decoder = nullptr;
+
+    // Output format
+    int32 SampleRate = 0;
+    int32 NumChannels = 0;
+};
+
+/**
+ * Stateful encoder of a single Opus stream, for senders written in C++ and local testing
+ */
+class METAHUMANSTREAMING_API FMetaHumanOpusEncoder
+{
+public:
+    // Packet duration senders use
+    static constexpr int32 FrameMilliseconds = 20;
+
+    FMetaHumanOpusEncoder() = default;
+    ~FMetaHumanOpusEncoder();
+
+    FMetaHumanOpusEncoder(const FMetaHumanOpusEncoder&) = delete;
+    FMetaHumanOpusEncoder& operator=(const FMetaHumanOpusEncoder&) = delete;
+
+    /**
+     * Create the encoder state for a voice stream
+     *
+     * @param InSampleRate - Input sample rate: 8000, 12000, 16000, 24000 or 48000
+     * @param InNumChannels - Number of channels (1 or 2)
+     * @param Bitrate - Target bitrate in bits per second
+     * @return bool - True if the encoder was created
+     */
+    bool Initialize(int32 InSampleRate, int32 InNumChannels, int32 Bitrate);
+
+    /**
+     * Encode one 20 ms frame and append it as a length-prefixed packet
+     *
+     * @param PCM - GetFrameSize() frames of 16-bit interleaved PCM
+     * @param OutPayload - Chunk audio the packet is appended to
+     * @return bool - True if the frame was encoded
+     */
+    bool EncodeFrame(TConstArrayView<int16> PCM, TArray<uint8>& OutPayload);
+
+    /**
+     * Get the number of frames (samples per channel) in one packet
+     *
+     * @return int32 - Frames per packet
+     */
+    int32 GetFrameSize() const { return SampleRate * FrameMilliseconds / 1000; }
+
+    /**
+     * Get the encoder's look-ahead, which adds to the latency of every packet
+     *
+     * @return int32 - Look-ahead in frames
+     */
+    int32 GetLookahead() const;
+
+private:
+    // libopus encoder state
+    OpusEncoder* Encoder = nullptr;
+
+    // Input format
+    int32 SampleRate = 0;
+    int32 NumChannels = 0;
+};
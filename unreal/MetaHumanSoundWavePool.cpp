@@ -0,0 +1,134 @@
+/**
+ * MetaHumanSoundWavePool.cpp
+ *
+ * Implementation of FMetaHumanSoundWavePool and of the MetaHuman.SoundWavePoolSoak
+ * console command.
+ */
+
+#include "MetaHumanSoundWavePool.h"
+#include "MetaHumanAudioClock.h"
+#include "MetaHumanStreamingStats.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformMemory.h"
+#include "UObject/UObjectIterator.h"
+#include "UObject/Package.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Sound Wave Pool Hits"), STAT_MetaHumanSoundWavePoolHits, STATGROUP_MetaHumanStreaming);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Sound Wave Pool Misses"), STAT_MetaHumanSoundWavePoolMisses, STATGROUP_MetaHumanStreaming);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pooled Sound Waves"), STAT_MetaHumanPooledSoundWaves, STATGROUP_MetaHumanStreaming);
+
+namespace MetaHumanSoundWavePool
+{
+    /**
+     * Count the clocked sound wave objects alive
+     */
+    int32 CountSoundWaves()
+    {
+        int32 NumSoundWaves = 0;
+        for (TObjectIterator<UMetaHumanClockedSoundWave> It; It; ++It)
+        {
+            NumSoundWaves++;
+        }
+        return NumSoundWaves;
+    }
+
+    /**
+     * Cycle utterances through a pool and log whether objects and memory stay flat
+     */
+    void RunSoak(const TArray<FString>& Args)
+    {
+        const int32 NumUtterances = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 5000;
+        const int32 PoolSize = Args.Num() > 1 ? FMath::Max(FCString::Atoi(*Args[1]), 1) : 4;
+        const int32 SampleRate = 44100;
+
+        // One second of silence per utterance; the content does not matter, only the buffers
+        TArray<uint8> PCM;
+        PCM.SetNumZeroed(SampleRate * sizeof(int16));
+
+        FMetaHumanSoundWavePool Pool;
+        const int32 StartSoundWaves = CountSoundWaves();
+        const uint64 StartMemory = FPlatformMemory::GetStats().UsedPhysical;
+
+        // Each utterance plays for a second of simulated time, so released waves cool down in between
+        double Now = FPlatformTime::Seconds();
+        uint64 CheckpointMemory = StartMemory;
+        for (int32 Utterance = 0; Utterance < NumUtterances; Utterance++)
+        {
+            UMetaHumanClockedSoundWave* SoundWave = Pool.Acquire(GetTransientPackage(), SampleRate, 1, PoolSize, Now);
+            SoundWave->QueueAudio(PCM.GetData(), PCM.Num());
+            Now += 1.0;
+            Pool.Release(SoundWave, Now);
+
+            if (Utterance == NumUtterances / 10)
+            {
+                CheckpointMemory = FPlatformMemory::GetStats().UsedPhysical;
+            }
+        }
+
+        const uint64 EndMemory = FPlatformMemory::GetStats().UsedPhysical;
+        UE_LOG(LogTemp, Display, TEXT("Sound wave pool soak: %d utterances, pool of %d, %llu hits, %llu misses, %d pooled waves"),
+            NumUtterances, PoolSize, Pool.GetHits(), Pool.GetMisses(), Pool.GetNumPooled());
+        UE_LOG(LogTemp, Display, TEXT("Sound wave pool soak: %d new sound wave objects, memory %+.2f MB overall and %+.2f MB after the first 10%%"),
+            CountSoundWaves() - StartSoundWaves, ((int64)EndMemory - (int64)StartMemory) / (1024.0 * 1024.0),
+            ((int64)EndMemory - (int64)CheckpointMemory) / (1024.0 * 1024.0));
+    }
+
+    FAutoConsoleCommand SoakCommand(
+        TEXT("MetaHuman.SoundWavePoolSoak"),
+        TEXT("Cycle utterances through a sound wave pool and log pool hits and misses, sound wave objects and memory. Args: [Utterances=5000] [PoolSize=4]"),
+        FConsoleCommandWithArgsDelegate::CreateStatic(&RunSoak));
+}
+
+UMetaHumanClockedSoundWave* FMetaHumanSoundWavePool::Acquire(UObject* Outer, int32 SampleRate, int32 NumChannels, int32 MaxPooled, double Now)
+{
+    check(Waves.Num() == ReleaseTimes.Num());
+
+    // Reuse a wave that has rested long enough for the renderer to let go of it
+    UMetaHumanClockedSoundWave* SoundWave = nullptr;
+    for (int32 WaveIndex = 0; WaveIndex < Waves.Num(); WaveIndex++)
+    {
+        if (Waves[WaveIndex] && ReleaseTimes[WaveIndex] >= 0.0 && Now - ReleaseTimes[WaveIndex] >= ReuseDelaySeconds)
+        {
+            SoundWave = Waves[WaveIndex];
+            ReleaseTimes[WaveIndex] = -1.0;
+            SoundWave->ResetAudio();
+            Hits++;
+            INC_DWORD_STAT(STAT_MetaHumanSoundWavePoolHits);
+            break;
+        }
+    }
+
+    // Otherwise create one, and keep it if the pool still has room
+    if (!SoundWave)
+    {
+        SoundWave = NewObject<UMetaHumanClockedSoundWave>(Outer);
+        Misses++;
+        INC_DWORD_STAT(STAT_MetaHumanSoundWavePoolMisses);
+        if (Waves.Num() < MaxPooled)
+        {
+            Waves.Add(SoundWave);
+            ReleaseTimes.Add(-1.0);
+            INC_DWORD_STAT(STAT_MetaHumanPooledSoundWaves);
+        }
+    }
+
+    SoundWave->SetFormat(SampleRate, NumChannels);
+    SoundWave->Duration = 0.0f;
+    SoundWave->SoundGroup = SOUNDGROUP_Voice;
+    SoundWave->bLooping = false;
+    return SoundWave;
+}
+
+void FMetaHumanSoundWavePool::Release(USoundWave* SoundWave, double Now)
+{
+    if (!SoundWave)
+    {
+        return;
+    }
+
+    const int32 WaveIndex = Waves.IndexOfByKey(SoundWave);
+    if (WaveIndex != INDEX_NONE && ReleaseTimes[WaveIndex] < 0.0)
+    {
+        ReleaseTimes[WaveIndex] = Now;
+    }
+}
@@ -0,0 +1,102 @@
+/**
+ * MetaHumanSoundWavePool.h
+ *
+ * This header file defines FMetaHumanSoundWavePool, a fixed-size set of clocked procedural
+ * sound waves that a receiver recycles across utterances instead of creating a new sound
+ * wave object for each one.
+ *
+ * Libraries/Modules used:
+ * - CoreMinimal.h: Core Unreal Engine functionality
+ * - MetaHumanAudioClock.h: The clocked procedural sound wave
+ *
+ * A released wave is only handed out again after ReuseDelaySeconds, because the audio
+ * renderer can still pull from a stopped sound for a few buffers. When every pooled wave
+ * is busy, or cooling down, a one-off wave is created and left to garbage collection.
+ *
+ * The console command MetaHuman.SoundWavePoolSoak runs thousands of acquire, queue and
+ * release cycles and logs the pool hits and misses, the number of sound wave objects and
+ * the change in memory, which should all stay flat.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MetaHumanSoundWavePool.generated.h"
+
+// Forward declarations
+class USoundWave;
+class UMetaHumanClockedSoundWave;
+
+/**
+ * Fixed-size pool of procedural sound waves
+ *
+ * USTRUCT: Unreal Engine macro for defining a struct that can be used in Blueprint
+ * GENERATED_BODY: Unreal Engine macro for generating boilerplate code
+ */
+USTRUCT()
+struct METAHUMANSTREAMING_API FMetaHumanSoundWavePool
+{
+    GENERATED_BODY()
+
+    // Seconds a released wave rests before it is reused
+    static constexpr double ReuseDelaySeconds = 0.25;
+
+    /**
+     * Get a sound wave for an utterance
+     *
+     * The wave's queued audio is cleared and its format and clock are reset. A wave that
+     * is not reused from the pool counts as a miss; it joins the pool while the pool has
+     * fewer than MaxPooled waves.
+     *
+     * @param Outer - Outer of newly created waves
+     * @param SampleRate - Sample rate of the 16-bit PCM that will be queued
+     * @param NumChannels - Number of interleaved channels
+     * @param MaxPooled - Size of the pool
+     * @param Now - FPlatformTime::Seconds()
+     * @return UMetaHumanClockedSoundWave* - A wave with no queued audio
+     */
+    UMetaHumanClockedSoundWave* Acquire(UObject* Outer, int32 SampleRate, int32 NumChannels, int32 MaxPooled, double Now);
+
+    /**
+     * Hand a sound wave back once its sound has been stopped
+     *
+     * Waves that are not part of the pool, and waves already released, are ignored.
+     *
+     * @param SoundWave - The wave to release, or null
+     * @param Now - FPlatformTime::Seconds()
+     */
+    void Release(USoundWave* SoundWave, double Now);
+
+    /**
+     * Get the number of waves owned by the pool
+     *
+     * @return int32 - Pooled waves, in use or free
+     */
+    int32 GetNumPooled() const { return Waves.Num(); }
+
+    /**
+     * Get the number of acquisitions served by a pooled wave
+     *
+     * @return uint64 - Pool hits
+     */
+    uint64 GetHits() const { return Hits; }
+
+    /**
+     * Get the number of acquisitions that had to create a wave
+     *
+     * @return uint64 - Pool misses
+     */
+    uint64 GetMisses() const { return Misses; }
+
+private:
+    // Pooled waves, kept alive by the owner's reference to this struct
+    UPROPERTY()
+    TArray<UMetaHumanClockedSoundWave*> Waves;
+
+    // Time each pooled wave was released, or a negative value while it is in use
+    TArray<double> ReleaseTimes;
+
+    // Acquisitions served from the pool, and ones that created a wave
+    uint64 Hits = 0;
+    uint64 Misses = 0;
+};
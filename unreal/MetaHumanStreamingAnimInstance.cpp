@@ -0,0 +1,285 @@
+/**
+ * MetaHumanStreamingAnimInstance.cpp
+ *
+ * Implementation of UMetaHumanStreamingAnimInstance and its proxy, which output the pose of
+ * a streaming receiver as animation curves on the animation worker threads.
+ */
+
+#include "MetaHumanStreamingAnimInstance.h"
+#include "MetaHumanStreamingReceiver.h"
+#include "MetaHumanStreamingStats.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/SkeletalMesh.h"
+#include "Animation/MorphTarget.h"
+#include "Animation/Skeleton.h"
+#include "EngineUtils.h"
+
+DECLARE_CYCLE_STAT(TEXT("Copy Curve Pose"), STAT_MetaHumanCopyCurvePose, STATGROUP_MetaHumanStreaming);
+DECLARE_CYCLE_STAT(TEXT("Evaluate Streaming Curves"), STAT_MetaHumanEvaluateCurves, STATGROUP_MetaHumanStreaming);
+
+namespace MetaHumanStreamingAnimInstance
+{
+    // Output paths compared by the benchmark
+    enum class EOutputPath : uint8
+    {
+        PerName,
+        Bulk,
+        Curves
+    };
+
+    /**
+     * Apply synthetic poses to a number of characters through each output path and log the game thread time
+     *
+     * Idle receivers with a mesh stand in for the characters; when there are fewer of them
+     * than characters, they are reused in turn. Each character's pose has its own phase, so
+     * a reused receiver still changes every channel on every application. The poses drive
+     * the first morph targets of each mesh, once for every requested channel count, or all
+     * of them when no count is given; a count is capped at the mesh's morph targets. The bulk
+     * path is reported as unavailable when any receiver cannot take bulk writes. The curve
+     * path's worker thread cost shows up under Evaluate Streaming Curves in
+     * "stat MetaHumanStreaming" once the meshes animate.
+     */
+    void RunOutputBenchmark(const TArray<FString>& Args, UWorld* World)
+    {
+        const int32 NumCharacters = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 10;
+        const int32 NumFrames = Args.Num() > 1 ? FMath::Max(FCString::Atoi(*Args[1]), 1) : 600;
+
+        // Channel counts to sweep, e.g. "52,150,250"; 0 drives every morph target
+        TArray<int32> ChannelCounts;
+        if (Args.Num() > 2)
+        {
+            TArray<FString> CountArgs;
+            Args[2].ParseIntoArray(CountArgs, TEXT(","));
+            for (const FString& CountArg : CountArgs)
+            {
+                ChannelCounts.Add(FMath::Max(FCString::Atoi(*CountArg), 0));
+            }
+        }
+        if (ChannelCounts.Num() == 0)
+        {
+            ChannelCounts.Add(0);
+        }
+
+        // Each receiver is driven through the morph targets of its mesh
+        TArray<UMetaHumanStreamingReceiver*> Receivers;
+        TArray<TArray<FString>> MorphTargetTables;
+        int32 MaxMorphTargets = 0;
+        for (TActorIterator<UMetaHumanStreamingReceiver> It(World); It; ++It)
+        {
+            USkeletalMeshComponent* Mesh = It->GetMetaHumanMesh();
+            USkeletalMesh* SkeletalMesh = Mesh ? Mesh->GetSkeletalMeshAsset() : nullptr;
+            if (!SkeletalMesh || SkeletalMesh->GetMorphTargets().Num() == 0 || It->IsPlaybackActive())
+            {
+                continue;
+            }
+
+            TArray<FString>& MorphTargetNames = MorphTargetTables.AddDefaulted_GetRef();
+            for (const UMorphTarget* MorphTarget : SkeletalMesh->GetMorphTargets())
+            {
+                MorphTargetNames.Add(MorphTarget->GetName());
+            }
+            MaxMorphTargets = FMath::Max(MaxMorphTargets, MorphTargetNames.Num());
+            Receivers.Add(*It);
+        }
+
+        if (Receivers.Num() == 0)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("Blendshape output benchmark needs an idle receiver whose mesh has morph targets"));
+            return;
+        }
+
+        const EOutputPath Paths[] = { EOutputPath::PerName, EOutputPath::Bulk, EOutputPath::Curves };
+        const TCHAR* PathNames[] = { TEXT("per name"), TEXT("bulk"), TEXT("curves") };
+        TArray<float> Weights;
+
+        for (const int32 ChannelCount : ChannelCounts)
+        {
+            // The first ChannelCount morph targets of each mesh form its channel table
+            TArray<TArray<FString>> ChannelTables;
+            int32 MaxChannels = 0;
+            for (const TArray<FString>& MorphTargetNames : MorphTargetTables)
+            {
+                const int32 NumChannels = ChannelCount > 0 ? FMath::Min(ChannelCount, MorphTargetNames.Num()) : MorphTargetNames.Num();
+                ChannelTables.Emplace(MorphTargetNames.GetData(), NumChannels);
+                MaxChannels = FMath::Max(MaxChannels, NumChannels);
+            }
+            if (ChannelCount > MaxMorphTargets)
+            {
+                UE_LOG(LogTemp, Warning, TEXT("Blendshape output benchmark: %d channels requested, but the meshes have at most %d morph targets"), ChannelCount, MaxMorphTargets);
+            }
+
+            UE_LOG(LogTemp, Display, TEXT("Blendshape output benchmark: %d characters on %d receivers, up to %d channels, %d frames"),
+                NumCharacters, Receivers.Num(), MaxChannels, NumFrames);
+
+            Weights.SetNumUninitialized(NumCharacters * MaxChannels);
+            for (int32 PathIndex = 0; PathIndex < UE_ARRAY_COUNT(Paths); PathIndex++)
+            {
+                const EOutputPath Path = Paths[PathIndex];
+
+                // Switch every receiver to the path, remembering its own settings
+                TArray<bool> SavedBulkWrites;
+                TArray<bool> SavedCurves;
+                bool bPathAvailable = true;
+                for (int32 ReceiverIndex = 0; ReceiverIndex < Receivers.Num(); ReceiverIndex++)
+                {
+                    UMetaHumanStreamingReceiver* Receiver = Receivers[ReceiverIndex];
+                    SavedBulkWrites.Add(Receiver->bUseBulkMorphTargetWrites);
+                    SavedCurves.Add(Receiver->bOutputAnimationCurves);
+                    Receiver->bUseBulkMorphTargetWrites = Path == EOutputPath::Bulk;
+                    Receiver->SetOutputAnimationCurves(Path == EOutputPath::Curves);
+                    Receiver->BindPoseChannels(ChannelTables[ReceiverIndex]);
+
+                    // A receiver that falls back to per-name writes would be timed under the wrong path
+                    bPathAvailable &= Path != EOutputPath::Bulk || Receiver->IsUsingBulkMorphTargetWrites();
+                }
+
+                // Every channel moves every frame and differs between characters, so no path can skip unchanged weights
+                double AppliedSeconds = 0.0;
+                for (int32 Frame = 0; Frame < NumFrames && bPathAvailable; Frame++)
+                {
+                    for (int32 Character = 0; Character < NumCharacters; Character++)
+                    {
+                        for (int32 ChannelIndex = 0; ChannelIndex < MaxChannels; ChannelIndex++)
+                        {
+                            Weights[Character * MaxChannels + ChannelIndex] = 0.5f + 0.5f * FMath::Sin(Frame * 0.1f + ChannelIndex + Character * 0.7f);
+                        }
+                    }
+
+                    const double StartTime = FPlatformTime::Seconds();
+                    for (int32 Character = 0; Character < NumCharacters; Character++)
+                    {
+                        const int32 ReceiverIndex = Character % Receivers.Num();
+                        Receivers[ReceiverIndex]->ApplyPose(TArrayView<const float>(Weights.GetData() + Character * MaxChannels, ChannelTables[ReceiverIndex].Num()));
+                    }
+                    AppliedSeconds += FPlatformTime::Seconds() - StartTime;
+                }
+
+                // Leave the meshes neutral and the receivers as they were
+                for (int32 ReceiverIndex = 0; ReceiverIndex < Receivers.Num(); ReceiverIndex++)
+                {
+                    UMetaHumanStreamingReceiver* Receiver = Receivers[ReceiverIndex];
+                    Receiver->ClearPose();
+                    Receiver->bUseBulkMorphTargetWrites = SavedBulkWrites[ReceiverIndex];
+                    Receiver->SetOutputAnimationCurves(SavedCurves[ReceiverIndex]);
+                }
+
+                if (!bPathAvailable)
+                {
+                    UE_LOG(LogTemp, Display, TEXT("  %-8s unavailable: the engine version or a mesh's anim instance rules out bulk writes"), PathNames[PathIndex]);
+                    continue;
+                }
+                UE_LOG(LogTemp, Display, TEXT("  %-8s %8.4f ms game thread per frame, %7.2f us per character"),
+                    PathNames[PathIndex], AppliedSeconds * 1000.0 / NumFrames, AppliedSeconds * 1.0e6 / ((double)NumFrames * NumCharacters));
+            }
+        }
+
+        UE_LOG(LogTemp, Display, TEXT("  The curve path writes its curves on the anim worker threads; see Evaluate Streaming Curves in stat MetaHumanStreaming"));
+    }
+
+    FAutoConsoleCommandWithWorldAndArgs OutputBenchmarkCommand(
+        TEXT("MetaHuman.BlendshapeOutputBenchmark"),
+        TEXT("Apply synthetic poses to characters through the per-name, bulk and curve output paths and log the game thread time of each. Args: [Characters=10] [Frames=600] [Channels=all, or a list such as 52,150,250]"),
+        FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&RunOutputBenchmark));
+}
+
+void FMetaHumanStreamingAnimInstanceProxy::PreUpdate(UAnimInstance* InAnimInstance, float DeltaSeconds)
+{
+    FAnimInstanceProxy::PreUpdate(InAnimInstance, DeltaSeconds);
+
+    SCOPE_CYCLE_COUNTER(STAT_MetaHumanCopyCurvePose);
+
+    const UMetaHumanStreamingAnimInstance* AnimInstance = CastChecked<UMetaHumanStreamingAnimInstance>(InAnimInstance);
+    const UMetaHumanStreamingReceiver* Receiver = AnimInstance->StreamingReceiver.Get();
+    if (!Receiver || Receiver->GetCurvePose().Alpha <= 0.0f)
+    {
+        Alpha = 0.0f;
+        return;
+    }
+    const FMetaHumanCurvePose& Pose = Receiver->GetCurvePose();
+
+#if METAHUMAN_SMART_NAME_CURVES
+    // Resolve the channel names once per channel table, not once per frame
+    const USkeleton* Skeleton = GetSkeleton();
+    if (!Skeleton)
+    {
+        Alpha = 0.0f;
+        return;
+    }
+    if (Pose.CurveTableSerial != CurveTableSerial || Skeleton != CurveSkeleton || CurveUIDs.Num() != Pose.CurveNames.Num())
+    {
+        CurveUIDs.Reset(Pose.CurveNames.Num());
+        for (const FName& CurveName : Pose.CurveNames)
+        {
+            CurveUIDs.Add(Skeleton->GetUIDByName(USkeleton::AnimCurveMappingName, CurveName));
+        }
+        CurveTableSerial = Pose.CurveTableSerial;
+        CurveSkeleton = Skeleton;
+    }
+    const int32 NumCurves = CurveUIDs.Num();
+#else
+    // Copy the channel names once per channel table, not once per frame
+    if (Pose.CurveTableSerial != CurveTableSerial || CurveNames.Num() != Pose.CurveNames.Num())
+    {
+        CurveNames = Pose.CurveNames;
+        CurveTableSerial = Pose.CurveTableSerial;
+    }
+    const int32 NumCurves = CurveNames.Num();
+#endif
+
+    // The worker threads read this copy; the receiver may change its pose while they run
+    Weights.SetNumUninitialized(Pose.Weights.Num(), false);
+    FMemory::Memcpy(Weights.GetData(), Pose.Weights.GetData(), Pose.Weights.Num() * sizeof(float));
+    Alpha = Weights.Num() == NumCurves ? Pose.Alpha : 0.0f;
+}
+
+bool FMetaHumanStreamingAnimInstanceProxy::Evaluate(FPoseContext& Output)
+{
+    // Evaluate the anim graph first, so the streamed curves layer over its facial animation
+    EvaluateAnimationNode(Output);
+
+    if (Alpha <= 0.0f)
+    {
+        return true;
+    }
+
+    SCOPE_CYCLE_COUNTER(STAT_MetaHumanEvaluateCurves);
+
+#if METAHUMAN_SMART_NAME_CURVES
+    // Curves the mesh does not require are ignored by the curve itself
+    for (int32 ChannelIndex = 0; ChannelIndex < CurveUIDs.Num(); ChannelIndex++)
+    {
+        const SmartName::UID_Type CurveUID = CurveUIDs[ChannelIndex];
+        if (CurveUID == SmartName::MaxUID)
+        {
+            continue;
+        }
+
+        const float GraphWeight = Output.Curve.Get(CurveUID);
+        Output.Curve.Set(CurveUID, FMath::Lerp(GraphWeight, Weights[ChannelIndex], Alpha));
+    }
+#else
+    // Curves are keyed by name; the mesh's curve filter drops the ones it does not use
+    for (int32 ChannelIndex = 0; ChannelIndex < CurveNames.Num(); ChannelIndex++)
+    {
+        const FName CurveName = CurveNames[ChannelIndex];
+        if (CurveName.IsNone())
+        {
+            continue;
+        }
+
+        const float GraphWeight = Output.Curve.Get(CurveName);
+        Output.Curve.Set(CurveName, FMath::Lerp(GraphWeight, Weights[ChannelIndex], Alpha));
+    }
+#endif
+    return true;
+}
+
+void UMetaHumanStreamingAnimInstance::SetStreamingReceiver(UMetaHumanStreamingReceiver* InReceiver)
+{
+    StreamingReceiver = InReceiver;
+}
+
+FAnimInstanceProxy* UMetaHumanStreamingAnimInstance::CreateAnimInstanceProxy()
+{
+    return new FMetaHumanStreamingAnimInstanceProxy(this);
+}
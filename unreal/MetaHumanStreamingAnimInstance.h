@@ -0,0 +1,141 @@
+/**
+ * MetaHumanStreamingAnimInstance.h
+ *
+ * This header file defines UMetaHumanStreamingAnimInstance, an anim instance that outputs
+ * the pose of a UMetaHumanStreamingReceiver as animation curves, and the anim instance
+ * proxy that does the work on the animation worker threads.
+ *
+ * Libraries/Modules used:
+ * - CoreMinimal.h: Core Unreal Engine functionality
+ * - Animation/AnimInstance.h: Anim instance base class
+ * - Animation/AnimInstanceProxy.h: Anim instance proxy, evaluated on worker threads
+ * - Misc/EngineVersionComparison.h: Engine version checks for the curve API
+ *
+ * A receiver with bOutputAnimationCurves publishes each pose instead of writing it to the
+ * mesh's morph targets. The proxy copies that pose once on the game thread before the
+ * animation update, then evaluates the anim graph on a worker thread and writes every
+ * channel into the pose's curves, which drive the morph targets of the same names. The
+ * streamed curves are layered over whatever facial animation the graph produces, so an
+ * Animation Blueprint reparented to this class keeps its own curves where nothing is
+ * streamed and while the receiver fades to neutral.
+ *
+ * From UE 5.3 curves are addressed by name; before that, by skeleton curve ids
+ * (METAHUMAN_SMART_NAME_CURVES), which the proxy resolves when the channel table changes.
+ *
+ * The console command MetaHuman.BlendshapeOutputBenchmark applies synthetic poses to a
+ * number of characters through the per-name, bulk and curve paths and logs the game
+ * thread time of each.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Animation/AnimInstance.h"
+#include "Animation/AnimInstanceProxy.h"
+#include "Misc/EngineVersionComparison.h"
+#include "MetaHumanStreamingAnimInstance.generated.h"
+
+// Whether pose curves are addressed by skeleton smart name ids (before UE 5.3) rather than by name
+#define METAHUMAN_SMART_NAME_CURVES UE_VERSION_OLDER_THAN(5, 3, 0)
+
+// Forward declarations
+class UMetaHumanStreamingReceiver;
+
+/**
+ * Anim instance proxy that writes the streamed pose into the evaluated curves
+ */
+struct METAHUMANSTREAMING_API FMetaHumanStreamingAnimInstanceProxy : public FAnimInstanceProxy
+{
+    FMetaHumanStreamingAnimInstanceProxy() = default;
+
+    FMetaHumanStreamingAnimInstanceProxy(UAnimInstance* InAnimInstance)
+        : FAnimInstanceProxy(InAnimInstance)
+    {
+    }
+
+protected:
+    /**
+     * Copy the receiver's pose, on the game thread before the animation update
+     *
+     * Curve names are copied, or resolved to skeleton curve ids before UE 5.3, only when
+     * the receiver's channel table changes.
+     *
+     * @param InAnimInstance - The owning anim instance
+     * @param DeltaSeconds - Time elapsed since the last update
+     */
+    virtual void PreUpdate(UAnimInstance* InAnimInstance, float DeltaSeconds) override;
+
+    /**
+     * Evaluate the anim graph, then write the streamed pose into its curves
+     *
+     * @param Output - The evaluated pose
+     * @return bool - Always true; the anim graph has been evaluated
+     */
+    virtual bool Evaluate(FPoseContext& Output) override;
+
+private:
+#if METAHUMAN_SMART_NAME_CURVES
+    // Skeleton curve id of each channel, or SmartName::MaxUID if the skeleton has no such curve
+    TArray<SmartName::UID_Type> CurveUIDs;
+
+    // Curve table the ids were resolved for, and the skeleton they were resolved on
+    uint32 CurveTableSerial = 0;
+    const USkeleton* CurveSkeleton = nullptr;
+#else
+    // Curve driven by each channel
+    TArray<FName> CurveNames;
+
+    // Curve table the names were copied from
+    uint32 CurveTableSerial = 0;
+#endif
+
+    // Weight of each channel, and how much the pose overrides the anim graph's curves
+    TArray<float> Weights;
+    float Alpha = 0.0f;
+};
+
+/**
+ * Anim instance that outputs a streaming receiver's pose as animation curves
+ *
+ * Use it as the anim class of the MetaHuman's face mesh, or as the parent class of its
+ * Animation Blueprint. UMetaHumanStreamingReceiver::SetMetaHumanMesh connects the receiver.
+ *
+ * UCLASS: Unreal Engine macro for defining a class that can be used in Blueprint
+ * GENERATED_BODY: Unreal Engine macro for generating boilerplate code
+ */
+UCLASS(Transient, Blueprintable)
+class METAHUMANSTREAMING_API UMetaHumanStreamingAnimInstance : public UAnimInstance
+{
+    GENERATED_BODY()
+
+    friend struct FMetaHumanStreamingAnimInstanceProxy;
+
+public:
+    /**
+     * Set the receiver whose pose is output
+     *
+     * @param InReceiver - The receiver, or null to output no streamed curves
+     */
+    UFUNCTION(BlueprintCallable, Category = "MetaHuman|Streaming")
+    void SetStreamingReceiver(UMetaHumanStreamingReceiver* InReceiver);
+
+    /**
+     * Get the receiver whose pose is output
+     *
+     * @return UMetaHumanStreamingReceiver* - The receiver, or null if none is set
+     */
+    UFUNCTION(BlueprintPure, Category = "MetaHuman|Streaming")
+    UMetaHumanStreamingReceiver* GetStreamingReceiver() const { return StreamingReceiver.Get(); }
+
+protected:
+    /**
+     * Create the proxy that evaluates the animation on worker threads
+     *
+     * @return FAnimInstanceProxy* - A new FMetaHumanStreamingAnimInstanceProxy
+     */
+    virtual FAnimInstanceProxy* CreateAnimInstanceProxy() override;
+
+private:
+    // Receiver whose pose is output
+    TWeakObjectPtr<UMetaHumanStreamingReceiver> StreamingReceiver;
+};
@@ -8,6 +8,7 @@
 #include "MetaHumanStreamingGameMode.h"
 #include "MetaHumanStreamingReceiver.h"
 #include "PixelStreamingCustomHandler.h"
+#include "MetaHumanStreamingSubsystem.h"
 #include "MetaHumanCharacter.h"
 #include "Kismet/GameplayStatics.h"
 #include "Engine/World.h"
@@ -40,19 +41,51 @@ void AMetaHumanStreamingGameMode::EndPlay(const EEndPlayReason::Type EndPlayReas
 {
     Super::EndPlay(EndPlayReason);
     
-    // Clean up resources if needed
+    // Stop routing messages to the characters' receivers
+    if (UMetaHumanStreamingSubsystem* StreamingSubsystem = GetWorld()->GetSubsystem<UMetaHumanStreamingSubsystem>())
+    {
+        for (const FString& CharacterId : CharacterIds)
+        {
+            StreamingSubsystem->UnregisterCharacter(CharacterId);
+        }
+    }
+}
+
+UMetaHumanStreamingReceiver* AMetaHumanStreamingGameMode::GetMetaHumanReceiverFor(const FString& CharacterId) const
+{
+    if (CharacterId.IsEmpty())
+    {
+        return MetaHumanReceiver;
+    }
+
+    const int32 CharacterIndex = CharacterIds.IndexOfByKey(CharacterId);
+    return CharacterIndex != INDEX_NONE ? MetaHumanReceivers[CharacterIndex] : nullptr;
 }
 
 void AMetaHumanStreamingGameMode::InitializeMetaHumanCharacter()
 {
-    // Find the MetaHuman character in the world
+    // Find the MetaHuman characters in the world
     TArray<AActor*> FoundActors;
     UGameplayStatics::GetAllActorsOfClass(GetWorld(), AMetaHumanCharacter::StaticClass(), FoundActors);
     
-    if (FoundActors.Num() > 0)
+    for (AActor* FoundActor : FoundActors)
     {
-        MetaHumanCharacter = Cast<AMetaHumanCharacter>(FoundActors[0]);
-        UE_LOG(LogTemp, Log, TEXT("Found MetaHuman character: %s"), *MetaHumanCharacter->GetName());
+        AMetaHumanCharacter* Character = Cast<AMetaHumanCharacter>(FoundActor);
+        if (!Character)
+        {
+            continue;
+        }
+
+        // Messages address a character by its first tag, or by its index when it has none
+        const FString CharacterId = Character->Tags.Num() > 0 ? Character->Tags[0].ToString() : LexToString(MetaHumanCharacters.Num() + 1);
+        MetaHumanCharacters.Add(Character);
+        CharacterIds.Add(CharacterId);
+        UE_LOG(LogTemp, Log, TEXT("Found MetaHuman character: %s (id %s)"), *Character->GetName(), *CharacterId);
+    }
+
+    if (MetaHumanCharacters.Num() > 0)
+    {
+        MetaHumanCharacter = MetaHumanCharacters[0];
     }
     else
     {
@@ -62,8 +95,12 @@ void AMetaHumanStreamingGameMode::InitializeMetaHumanCharacter()
 
 void AMetaHumanStreamingGameMode::InitializePixelStreaming()
 {
-    // Create the MetaHuman streaming receiver
-    MetaHumanReceiver = NewObject<UMetaHumanStreamingReceiver>(this);
+    // Spawn a MetaHuman streaming receiver per character; spawning registers its tick and audio component
+    for (int32 CharacterIndex = 0; CharacterIndex < MetaHumanCharacters.Num(); CharacterIndex++)
+    {
+        MetaHumanReceivers.Add(GetWorld()->SpawnActor<UMetaHumanStreamingReceiver>());
+    }
+    MetaHumanReceiver = MetaHumanReceivers.Num() > 0 ? MetaHumanReceivers[0] : nullptr;
     
     // Create the Pixel Streaming custom handler
     PixelStreamingHandler = NewObject<UPixelStreamingCustomHandler>(this);
@@ -73,24 +110,34 @@ void AMetaHumanStreamingGameMode::InitializePixelStreaming()
 
 void AMetaHumanStreamingGameMode::ConnectComponents()
 {
-    if (MetaHumanReceiver && MetaHumanCharacter)
+    UMetaHumanStreamingSubsystem* StreamingSubsystem = GetWorld()->GetSubsystem<UMetaHumanStreamingSubsystem>();
+
+    for (int32 CharacterIndex = 0; CharacterIndex < MetaHumanReceivers.Num(); CharacterIndex++)
     {
+        if (!MetaHumanReceivers[CharacterIndex])
+        {
+            UE_LOG(LogTemp, Error, TEXT("Failed to spawn a receiver for MetaHuman character %s"), *CharacterIds[CharacterIndex]);
+            continue;
+        }
+
         // Set the MetaHuman mesh for the receiver
-        MetaHumanReceiver->SetMetaHumanMesh(MetaHumanCharacter->GetMesh());
+        MetaHumanReceivers[CharacterIndex]->SetMetaHumanMesh(MetaHumanCharacters[CharacterIndex]->GetMesh());
+
+        // Route the character's messages to its receiver
+        if (StreamingSubsystem)
+        {
+            StreamingSubsystem->RegisterCharacter(CharacterIds[CharacterIndex], MetaHumanReceivers[CharacterIndex]);
+        }
     }
     
-    if (PixelStreamingHandler && MetaHumanReceiver)
-    {
-        // Set the MetaHuman receiver for the Pixel Streaming handler
-        PixelStreamingHandler->SetMetaHumanReceiver(MetaHumanReceiver);
-    }
+    // The Pixel Streaming handler has no receiver set, so it forwards messages to the subsystem for routing
     
     // Initialize WebSocket connection for real-time communication
-    if (MetaHumanReceiver)
+    if (StreamingSubsystem && MetaHumanReceiver)
     {
         // Get the WebSocket URL from environment variables or configuration
         FString WebSocketURL = TEXT("ws://localhost:8000/ws");
-        MetaHumanReceiver->InitializeWebSocketConnection(WebSocketURL);
+        StreamingSubsystem->InitializeWebSocketConnection(WebSocketURL);
     }
     
     UE_LOG(LogTemp, Log, TEXT("Components connected"));
@@ -9,9 +9,12 @@
  * - GameFramework/GameModeBase.h: Base class for game modes in Unreal Engine
  * 
  * The class handles:
- * - Initializing the MetaHuman character
+ * - Initializing every MetaHuman character in the world, each with its own receiver
  * - Setting up the Pixel Streaming environment
  * - Connecting the various components of the system
+ *
+ * Characters are registered with UMetaHumanStreamingSubsystem under their first actor tag,
+ * or their 1-based index in the world when untagged, and messages are routed by that id.
  */
 
 #pragma once
@@ -70,7 +73,7 @@ public:
     /**
      * Get the MetaHuman streaming receiver
      * 
-     * This function returns the MetaHuman streaming receiver.
+     * This function returns the receiver of the default character.
      * 
      * @return UMetaHumanStreamingReceiver* - The MetaHuman streaming receiver
      */
@@ -90,31 +93,47 @@ public:
     /**
      * Get the MetaHuman character
      * 
-     * This function returns the MetaHuman character.
+     * This function returns the default MetaHuman character.
      * 
      * @return AMetaHumanCharacter* - The MetaHuman character
      */
     UFUNCTION(BlueprintCallable, Category = "MetaHuman|Streaming")
     AMetaHumanCharacter* GetMetaHumanCharacter() const { return MetaHumanCharacter; }
 
+    /**
+     * Get the receiver of a MetaHuman character
+     * 
+     * @param CharacterId - Id the character was registered with, or empty for the default character
+     * @return UMetaHumanStreamingReceiver* - The character's receiver, or null if there is none
+     */
+    UFUNCTION(BlueprintCallable, Category = "MetaHuman|Streaming")
+    UMetaHumanStreamingReceiver* GetMetaHumanReceiverFor(const FString& CharacterId) const;
+
 private:
-    // The MetaHuman streaming receiver
+    // The MetaHuman streaming receiver of the default character
     UPROPERTY()
     UMetaHumanStreamingReceiver* MetaHumanReceiver;
 
+    // The MetaHuman characters, their ids and their receivers, in the same order
+    UPROPERTY()
+    TArray<AMetaHumanCharacter*> MetaHumanCharacters;
+    TArray<FString> CharacterIds;
+    UPROPERTY()
+    TArray<UMetaHumanStreamingReceiver*> MetaHumanReceivers;
+
     // The Pixel Streaming custom handler
     UPROPERTY()
     UPixelStreamingCustomHandler* PixelStreamingHandler;
 
-    // The MetaHuman character
+    // The default MetaHuman character
     UPROPERTY()
     AMetaHumanCharacter* MetaHumanCharacter;
 
     /**
      * Initialize the MetaHuman character
      * 
-     * This function initializes the MetaHuman character.
-     * It finds the MetaHuman character in the world and stores a reference to it.
+     * This function initializes the MetaHuman characters.
+     * It finds every MetaHuman character in the world and assigns each an id.
      */
     void InitializeMetaHumanCharacter();
 
@@ -122,7 +141,7 @@ private:
      * Initialize the Pixel Streaming environment
      * 
      * This function initializes the Pixel Streaming environment.
-     * It creates the MetaHuman streaming receiver and the Pixel Streaming custom handler.
+     * It creates a MetaHuman streaming receiver per character and the Pixel Streaming custom handler.
      */
     void InitializePixelStreaming();
 
@@ -130,8 +149,9 @@ private:
      * Connect the various components of the system
      * 
      * This function connects the various components of the system.
-     * It sets the MetaHuman mesh for the receiver, sets the MetaHuman receiver for the
-     * Pixel Streaming handler, and initializes the WebSocket connection for real-time communication.
+     * It sets each character's mesh for its receiver, registers the characters with the
+     * streaming subsystem, and initializes the WebSocket connection for real-time
+     * communication, which the subsystem shares between the characters.
      */
     void ConnectComponents();
 };
@@ -7,22 +7,151 @@
  */
 
 #include "MetaHumanStreamingReceiver.h"
+#include "MetaHumanBlendshapeCodec.h"
+#include "MetaHumanIngestPipeline.h"
+#include "MetaHumanAudioClock.h"
+#include "MetaHumanStreamingSubsystem.h"
+#include "MetaHumanStreamingAnimInstance.h"
 #include "Components/SkeletalMeshComponent.h"
+#include "Engine/SkeletalMesh.h"
+#include "Animation/MorphTarget.h"
+#include "MetaHumanStreamingStats.h"
 #include "HttpModule.h"
 #include "Interfaces/IHttpResponse.h"
 #include "Dom/JsonObject.h"
-#include "Serialization/JsonReader.h"
-#include "Serialization/JsonSerializer.h"
 #include "Sound/SoundWave.h"
+#include "Sound/SoundWaveProcedural.h"
 #include "AudioDevice.h"
 #include "Engine/Engine.h"
 #include "Misc/Base64.h"
+#include "Misc/EngineVersionComparison.h"
+
+// Bulk writes go straight into USkeletalMeshComponent's morph target arrays, whose layout is only known before 5.3
+#define METAHUMAN_BULK_MORPH_TARGET_WRITES UE_VERSION_OLDER_THAN(5, 3, 0)
+
+DECLARE_CYCLE_STAT(TEXT("Apply Blendshapes (per name)"), STAT_MetaHumanApplyBlendshapes, STATGROUP_MetaHumanStreaming);
+DECLARE_CYCLE_STAT(TEXT("Apply Blendshapes (bulk)"), STAT_MetaHumanApplyWeightRow, STATGROUP_MetaHumanStreaming);
+DECLARE_CYCLE_STAT(TEXT("Publish Curve Pose"), STAT_MetaHumanPublishCurvePose, STATGROUP_MetaHumanStreaming);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Bound Blendshape Channels"), STAT_MetaHumanBoundChannels, STATGROUP_MetaHumanStreaming);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Stream Jitter (ms)"), STAT_MetaHumanStreamJitter, STATGROUP_MetaHumanStreaming);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Stream Target Delay (ms)"), STAT_MetaHumanStreamTargetDelay, STATGROUP_MetaHumanStreaming);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Stream Underruns"), STAT_MetaHumanStreamUnderruns, STATGROUP_MetaHumanStreaming);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Stream Late Drops"), STAT_MetaHumanStreamLateDrops, STATGROUP_MetaHumanStreaming);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Ingest Queue Wait (ms)"), STAT_MetaHumanIngestQueue, STATGROUP_MetaHumanStreaming);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Ingest Parse (ms)"), STAT_MetaHumanIngestParse, STATGROUP_MetaHumanStreaming);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Ingest Audio Decode (ms)"), STAT_MetaHumanIngestAudioDecode, STATGROUP_MetaHumanStreaming);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Ingest Blendshape Decode (ms)"), STAT_MetaHumanIngestBlendshapeDecode, STATGROUP_MetaHumanStreaming);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Ingest Commit (ms)"), STAT_MetaHumanIngestCommit, STATGROUP_MetaHumanStreaming);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("A/V Offset (ms)"), STAT_MetaHumanAVOffset, STATGROUP_MetaHumanStreaming);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Tick Time Drift (ms)"), STAT_MetaHumanTickTimeDrift, STATGROUP_MetaHumanStreaming);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Skipped Morph Target Updates/s"), STAT_MetaHumanSkippedUpdates, STATGROUP_MetaHumanStreaming);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Queued Utterances"), STAT_MetaHumanQueuedUtterances, STATGROUP_MetaHumanStreaming);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Interrupt To Silence (ms)"), STAT_MetaHumanInterruptToSilence, STATGROUP_MetaHumanStreaming);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Active Receivers"), STAT_MetaHumanActiveReceivers, STATGROUP_MetaHumanStreaming);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Idle Receivers"), STAT_MetaHumanIdleReceivers, STATGROUP_MetaHumanStreaming);
+
+namespace MetaHumanStreamingReceiver
+{
+    // Mixer buffers a source's samples sit in before the device buffers, when estimating output latency
+    constexpr int32 SourceBufferCount = 2;
+
+    // Last applied weight of a channel that has not been applied yet; differs from any real weight
+    constexpr float UnappliedWeight = MAX_flt;
+
+    // Longest an interrupted sound keeps playing past its fade when the renderer stops pulling from it
+    constexpr double MaxInterruptFadeWaitSeconds = 0.5;
+
+    // Receivers in play, and how many of them are updating playback (game thread only)
+    int32 NumReceivers = 0;
+    int32 NumAwakeReceivers = 0;
+
+    // Utterances queued across all receivers (game thread only)
+    int32 NumQueuedUtterances = 0;
+
+    /**
+     * Publish the receiver counts to the Active Receivers and Idle Receivers stats
+     */
+    void ReportReceiverCounts()
+    {
+        SET_DWORD_STAT(STAT_MetaHumanActiveReceivers, NumAwakeReceivers);
+        SET_DWORD_STAT(STAT_MetaHumanIdleReceivers, NumReceivers - NumAwakeReceivers);
+    }
+
+    /**
+     * Trim 16-bit interleaved PCM to whole frames, so audio appended after it stays channel aligned
+     */
+    TConstArrayView<uint8> GetWholeFrames(TConstArrayView<uint8> PCMData, int32 NumChannels)
+    {
+        const int32 BytesPerFrame = sizeof(int16) * FMath::Max(NumChannels, 1);
+        return PCMData.Left(PCMData.Num() - PCMData.Num() % BytesPerFrame);
+    }
+
+    /**
+     * Get the duration of 16-bit interleaved PCM
+     */
+    double GetPCMDuration(int32 NumBytes, int32 SampleRate, int32 NumChannels)
+    {
+        const int32 BytesPerFrame = sizeof(int16) * FMath::Max(NumChannels, 1);
+        return SampleRate > 0 ? (double)(NumBytes / BytesPerFrame) / SampleRate : 0.0;
+    }
+
+    /**
+     * Find the channels whose weight moved by more than a threshold since it was last applied
+     *
+     * Four channels are compared per vector instruction. The last applied weight of each
+     * changed channel is updated; channels below the threshold keep their old value, so slow
+     * drift still gets applied once it adds up.
+     *
+     * @param Weights - New weights, one per channel
+     * @param LastApplied - Last applied weights, one per channel
+     * @param Threshold - Smallest change that is applied
+     * @param OutChanged - Receives the indices of the changed channels
+     */
+    void GatherChangedChannels(TArrayView<const float> Weights, TArrayView<float> LastApplied, float Threshold, TArray<int32>& OutChanged)
+    {
+        check(Weights.Num() == LastApplied.Num());
+        OutChanged.Reset();
+
+        const int32 NumChannels = Weights.Num();
+        const float* NewData = Weights.GetData();
+        float* LastData = LastApplied.GetData();
+        const VectorRegister4Float ThresholdVector = VectorSetFloat1(Threshold);
+
+        int32 ChannelIndex = 0;
+        for (; ChannelIndex + 4 <= NumChannels; ChannelIndex += 4)
+        {
+            const VectorRegister4Float Delta = VectorAbs(VectorSubtract(VectorLoad(NewData + ChannelIndex), VectorLoad(LastData + ChannelIndex)));
+            uint32 ChangedMask = VectorMaskBits(VectorCompareGT(Delta, ThresholdVector));
+            while (ChangedMask)
+            {
+                const int32 Changed = ChannelIndex + (int32)FMath::CountTrailingZeros(ChangedMask);
+                LastData[Changed] = NewData[Changed];
+                OutChanged.Add(Changed);
+                ChangedMask &= ChangedMask - 1;
+            }
+        }
+        for (; ChannelIndex < NumChannels; ChannelIndex++)
+        {
+            if (FMath::Abs(NewData[ChannelIndex] - LastData[ChannelIndex]) > Threshold)
+            {
+                LastData[ChannelIndex] = NewData[ChannelIndex];
+                OutChanged.Add(ChannelIndex);
+            }
+        }
+    }
+}
 
 // Sets default values
 UMetaHumanStreamingReceiver::UMetaHumanStreamingReceiver()
 {
-    // Set this actor to call Tick() every frame
+    // Tick only while there is something to play; committing an utterance or stream turns the tick on
     PrimaryActorTick.bCanEverTick = true;
+    PrimaryActorTick.bStartWithTickEnabled = false;
+    PlaybackTickGroup = TG_PrePhysics;
+    PlaybackTickInterval = 0.0f;
+    bPlaybackAwake = false;
+    bCountedInPlaybackStats = false;
+    ReportedQueuedUtterances = 0;
 
     // Create audio component
     AudioComponent = CreateDefaultSubobject<UAudioComponent>(TEXT("AudioComponent"));
@@ -33,13 +162,67 @@ UMetaHumanStreamingReceiver::UMetaHumanStreamingReceiver()
     bIsAnimating = false;
     CurrentFrame = 0;
     AnimationTime = 0.0f;
+    AccumulatedTickTime = 0.0;
+    CurrentUtteranceStart = 0.0;
+    QueuedAudioEnd = 0.0;
+    PlayingSampleRate = 0;
+    PlayingNumChannels = 0;
+    MaxQueuedUtterances = 4;
+    InterruptFadeMilliseconds = 20.0f;
+    FadingSoundWave = nullptr;
+    InterruptTime = 0.0;
+    FadingSoundWaveDeadline = 0.0;
+    LastInterruptToSilenceSeconds = -1.0f;
+    UtteranceBlendMilliseconds = 60.0f;
     FrameRate = 60.0f; // Default to 60 FPS
+    bUseBulkMorphTargetWrites = true;
+    bOutputAnimationCurves = false;
+    NeutralFadeStartCurveAlpha = 0.0f;
+    MorphTargetUpdateThreshold = 0.001f;
+    NeutralFadeMilliseconds = 0.0f;
+    bIsFadingToNeutral = false;
+    NeutralFadeTime = 0.0f;
+    NeutralFadeDuration = 0.0f;
+    SkippedUpdatesInWindow = 0;
+    SkippedUpdatesWindowStart = 0.0;
+    BlendshapeInterpolation = EBlendshapeInterpolation::Linear;
+
+    // Initialize audio clock variables
+    bSyncToAudioClock = true;
+    AudioOutputLatencySeconds = -1.0f;
+    OutputLatency = 0.0;
+
+    // Initialize streaming variables
+    SoundWavePoolSize = 4;
+    StreamingPrerollSeconds = 0.2f;
+    StreamingMaxDelaySeconds = 0.5f;
+    StreamingSoundWave = nullptr;
+    bIsStreaming = false;
+    bStreamEnded = false;
+    NextStreamSequence = 0;
+    StreamingSampleRate = 0;
+    StreamingNumChannels = 0;
+    StreamingCodec = EMetaHumanAudioCodec::PCM;
+    StreamedAudioSeconds = 0.0;
+
+    // Initialize ingest variables
 }
 
 // Called when the game starts or when spawned
 void UMetaHumanStreamingReceiver::BeginPlay()
 {
+    using namespace MetaHumanStreamingReceiver;
+
+    PrimaryActorTick.TickGroup = PlaybackTickGroup;
+    PrimaryActorTick.TickInterval = PlaybackTickInterval;
     Super::BeginPlay();
+
+    // Tick only if playback was already woken, and the receiver is not updated by a subsystem
+    SetActorTickEnabled(bPlaybackAwake && !StreamingSubsystem.IsValid());
+    NumReceivers++;
+    NumAwakeReceivers += bPlaybackAwake ? 1 : 0;
+    bCountedInPlaybackStats = true;
+    ReportReceiverCounts();
     
     // Initialize WebSockets module
     FWebSocketsModule& WebSocketsModule = FModuleManager::LoadModuleChecked<FWebSocketsModule>("WebSockets");
@@ -48,309 +231,1511 @@ void UMetaHumanStreamingReceiver::BeginPlay()
 // Called when the game ends
 void UMetaHumanStreamingReceiver::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
+    using namespace MetaHumanStreamingReceiver;
+
     Super::EndPlay(EndPlayReason);
-    
-    // Close WebSocket connection if it exists
-    if (WebSocket.IsValid() && WebSocket->IsConnected())
+
+    // Leave the subsystem's routes and update pass before it can touch this receiver again
+    if (UMetaHumanStreamingSubsystem* Subsystem = StreamingSubsystem.Get())
     {
-        WebSocket->Close();
-        WebSocket = nullptr;
+        Subsystem->UnregisterReceiver(this);
     }
+
+    // Take the queue out of the Queued Utterances stat
+    UtteranceQueue.Reset();
+    ReportQueuedUtterances();
+
+    if (bCountedInPlaybackStats)
+    {
+        NumReceivers--;
+        NumAwakeReceivers -= bPlaybackAwake ? 1 : 0;
+        bCountedInPlaybackStats = false;
+        ReportReceiverCounts();
+    }
+    
+    // Close WebSocket connection if it exists
+    WebSocketConnection.Close();
 }
 
 // Called every frame
 void UMetaHumanStreamingReceiver::Tick(float DeltaTime)
 {
     Super::Tick(DeltaTime);
+    UpdatePlayback(DeltaTime);
 
-    // Update animation if currently playing
-    if (bIsAnimating)
+    // Nothing left to play or fade; tick again once an utterance or stream is committed
+    if (!IsPlaybackActive())
     {
-        UpdateAnimation(DeltaTime);
+        SetPlaybackAwake(false);
     }
 }
 
-bool UMetaHumanStreamingReceiver::InitializeWebSocketConnection(const FString& ServerURL)
+void UMetaHumanStreamingReceiver::UpdatePlayback(float DeltaTime)
 {
-    // Create WebSocket
-    WebSocket = FWebSocketsModule::Get().CreateWebSocket(ServerURL);
+    if (BeginPlaybackUpdate(DeltaTime))
+    {
+        SamplePlayback();
+    }
+    EndPlaybackUpdate(DeltaTime);
+}
 
-    // Bind event handlers
-    WebSocket->OnConnected().AddUObject(this, &UMetaHumanStreamingReceiver::OnWebSocketConnected);
-    WebSocket->OnConnectionError().AddUObject(this, &UMetaHumanStreamingReceiver::OnWebSocketConnectionError);
-    WebSocket->OnClosed().AddUObject(this, &UMetaHumanStreamingReceiver::OnWebSocketClosed);
-    WebSocket->OnMessage().AddUObject(this, &UMetaHumanStreamingReceiver::OnWebSocketMessage);
+bool UMetaHumanStreamingReceiver::BeginPlaybackUpdate(float DeltaTime)
+{
+    PoseEvaluation.bHasPose = false;
+    PoseEvaluation.Apply = EMetaHumanPoseApply::None;
 
-    // Connect to server
-    WebSocket->Connect();
+    // Release streamed chunks whose playout time has come
+    if (bIsStreaming)
+    {
+        PumpStreamJitterBuffer();
+    }
+    // Start a queued utterance that is not waiting behind anything
+    else if (!bIsAnimating && UtteranceQueue.Num() > 0)
+    {
+        PlayNextQueuedUtterance();
+    }
 
-    return true;
+    // Advance animation if currently playing
+    PoseEvaluation.bWasAnimating = bIsAnimating;
+    if (bIsAnimating)
+    {
+        PoseEvaluation.bHasPose = AdvanceAnimation(DeltaTime);
+    }
+    return PoseEvaluation.bHasPose;
 }
 
-bool UMetaHumanStreamingReceiver::InitializeHTTPEndpoint(const FString& EndpointURL)
+void UMetaHumanStreamingReceiver::SamplePlayback()
 {
-    // Nothing to initialize for HTTP endpoint, just store the URL
-    // In a real implementation, you might set up a polling mechanism or server-sent events
-    
-    UE_LOG(LogTemp, Log, TEXT("HTTP endpoint initialized: %s"), *EndpointURL);
-    return true;
+    if (PoseEvaluation.bHasPose)
+    {
+        SampleAnimation();
+    }
 }
 
-void UMetaHumanStreamingReceiver::SetMetaHumanMesh(USkeletalMeshComponent* InSkeletalMeshComponent)
+void UMetaHumanStreamingReceiver::EndPlaybackUpdate(float DeltaTime)
 {
-    MetaHumanMeshComponent = InSkeletalMeshComponent;
+    // Apply the animation if it was playing
+    if (PoseEvaluation.bHasPose)
+    {
+        ApplyAnimation();
+    }
+    // Otherwise finish returning the face to neutral
+    else if (!PoseEvaluation.bWasAnimating && bIsFadingToNeutral)
+    {
+        UpdateNeutralFade(DeltaTime);
+    }
+    PoseEvaluation.bHasPose = false;
+
+    // Stop an interrupted sound once its fade out has been heard
+    if (FadingSoundWave)
+    {
+        UpdateInterruptFade();
+    }
 }
 
-void UMetaHumanStreamingReceiver::ProcessReceivedData(const FString& AudioBase64, const FString& BlendshapeData)
+bool UMetaHumanStreamingReceiver::IsPlaybackActive() const
 {
-    // Stop any current animation
-    StopAnimation();
+    return bIsAnimating || bIsStreaming || bIsFadingToNeutral || FadingSoundWave || UtteranceQueue.Num() > 0;
+}
 
-    // Decode audio data
-    USoundWave* SoundWave = DecodeAudioData(AudioBase64);
-    if (!SoundWave)
+void UMetaHumanStreamingReceiver::SetStreamingSubsystem(UMetaHumanStreamingSubsystem* InSubsystem)
+{
+    // The mesh waits for the pre-mesh update of the new subsystem instead of the old one
+    UMetaHumanStreamingSubsystem* OldSubsystem = StreamingSubsystem.Get();
+    if (OldSubsystem && MetaHumanMeshComponent)
     {
-        UE_LOG(LogTemp, Error, TEXT("Failed to decode audio data"));
-        return;
+        MetaHumanMeshComponent->PrimaryComponentTick.RemovePrerequisite(OldSubsystem, OldSubsystem->GetPreMeshUpdateTickFunction());
     }
+    StreamingSubsystem = InSubsystem;
+    UpdateMeshTickDependency();
 
-    // Parse blendshape data
-    TArray<FBlendshapeFrame> BlendshapeFrames = ParseBlendshapeData(BlendshapeData);
-    if (BlendshapeFrames.Num() == 0)
+    // Hand awake playback over between the receiver's tick and the subsystem's pass
+    SetActorTickEnabled(!InSubsystem && bPlaybackAwake);
+    if (InSubsystem && bPlaybackAwake)
+    {
+        InSubsystem->ActivateReceiver(this);
+    }
+    WakePlayback();
+}
+
+void UMetaHumanStreamingReceiver::SetPlaybackAwake(bool bAwake)
+{
+    using namespace MetaHumanStreamingReceiver;
+
+    if (bAwake == bPlaybackAwake)
     {
-        UE_LOG(LogTemp, Error, TEXT("Failed to parse blendshape data"));
         return;
     }
+    bPlaybackAwake = bAwake;
 
-    // Set up current animation data
-    CurrentAnimationData.AudioData = SoundWave;
-    CurrentAnimationData.BlendshapeFrames = BlendshapeFrames;
-    CurrentAnimationData.Duration = SoundWave->Duration;
+    if (bCountedInPlaybackStats)
+    {
+        NumAwakeReceivers += bAwake ? 1 : -1;
+        ReportReceiverCounts();
+    }
 
-    // Start the animation
-    StartAnimation();
+    // A subsystem drops idle receivers from its pass itself
+    if (UMetaHumanStreamingSubsystem* Subsystem = StreamingSubsystem.Get())
+    {
+        if (bAwake)
+        {
+            Subsystem->ActivateReceiver(this);
+        }
+    }
+    else
+    {
+        SetActorTickEnabled(bAwake);
+    }
 }
 
-USoundWave* UMetaHumanStreamingReceiver::DecodeAudioData(const FString& AudioBase64)
+void UMetaHumanStreamingReceiver::SetPlaybackTick(TEnumAsByte<ETickingGroup> TickGroup, float TickInterval)
 {
-    // Decode base64 string to binary data
-    TArray<uint8> DecodedAudio;
-    if (!FBase64::Decode(AudioBase64, DecodedAudio))
-    {
-        UE_LOG(LogTemp, Error, TEXT("Failed to decode base64 audio data"));
-        return nullptr;
-    }
+    PlaybackTickGroup = TickGroup;
+    PlaybackTickInterval = FMath::Max(TickInterval, 0.0f);
+    SetTickGroup(PlaybackTickGroup);
+    SetActorTickInterval(PlaybackTickInterval);
+}
 
-    // Create a new sound wave
-    USoundWave* SoundWave = NewObject<USoundWave>(this);
-    
-    // Set sound wave properties
-    // Note: This is a simplified implementation. In a real application,
-    // you would need to parse the audio format (e.g., WAV, MP3) and set
-    // properties accordingly.
-    SoundWave->SetSampleRate(44100); // Assuming 44.1kHz sample rate
-    SoundWave->NumChannels = 1;      // Assuming mono audio
-    
-    // Set the audio data
-    // Note: In a real implementation, you would need to handle different audio formats
-    // and possibly convert the data to the format expected by Unreal Engine.
-    SoundWave->RawData.Lock(LOCK_READ_WRITE);
-    void* LockedData = SoundWave->RawData.Realloc(DecodedAudio.Num());
-    FMemory::Memcpy(LockedData, DecodedAudio.GetData(), DecodedAudio.Num());
-    SoundWave->RawData.Unlock();
-    
-    // Set duration based on audio data
-    // Note: In a real implementation, you would calculate this based on the audio format
-    SoundWave->Duration = DecodedAudio.Num() / (44100.0f * 1 * 2); // Assuming 16-bit samples
-    
-    return SoundWave;
+void UMetaHumanStreamingReceiver::ReportQueuedUtterances()
+{
+    using namespace MetaHumanStreamingReceiver;
+
+    // The stat keeps its value between frames; each receiver adds the change in its own queue
+    NumQueuedUtterances += UtteranceQueue.Num() - ReportedQueuedUtterances;
+    ReportedQueuedUtterances = UtteranceQueue.Num();
+    SET_DWORD_STAT(STAT_MetaHumanQueuedUtterances, NumQueuedUtterances);
 }
 
-TArray<FBlendshapeFrame> UMetaHumanStreamingReceiver::ParseBlendshapeData(const FString& BlendshapeJSON)
+void UMetaHumanStreamingReceiver::WakePlayback()
 {
-    TArray<FBlendshapeFrame> BlendshapeFrames;
-    
-    // Parse JSON string
-    TSharedPtr<FJsonObject> JsonObject;
-    TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(BlendshapeJSON);
-    if (!FJsonSerializer::Deserialize(Reader, JsonObject) || !JsonObject.IsValid())
+    if (IsPlaybackActive())
     {
-        UE_LOG(LogTemp, Error, TEXT("Failed to parse blendshape JSON data"));
-        return BlendshapeFrames;
+        SetPlaybackAwake(true);
     }
+}
+
+bool UMetaHumanStreamingReceiver::InitializeWebSocketConnection(const FString& ServerURL)
+{
+    // Parse and decode every message off the game thread; the connection lives and dies with the receiver
+    return WebSocketConnection.Connect(ServerURL,
+        [this](const FString& Message) { IngestMessageAsync(Message); },
+        [this](TArray<uint8>&& Message) { IngestBinaryMessageAsync(MoveTemp(Message)); });
+}
+
+bool UMetaHumanStreamingReceiver::InitializeHTTPEndpoint(const FString& EndpointURL)
+{
+    // Nothing to initialize for HTTP endpoint, just store the URL
+    // In a real implementation, you might set up a polling mechanism or server-sent events
     
-    // Extract blendshape frames from JSON
-    TArray<TSharedPtr<FJsonValue>> FramesArray = JsonObject->GetArrayField(TEXT("frames"));
-    for (int32 i = 0; i < FramesArray.Num(); i++)
+    UE_LOG(LogTemp, Log, TEXT("HTTP endpoint initialized: %s"), *EndpointURL);
+    return true;
+}
+
+void UMetaHumanStreamingReceiver::SetMetaHumanMesh(USkeletalMeshComponent* InSkeletalMeshComponent)
+{
+    // Leave the previous mesh neutral; the touched morph targets belong to it
+    bIsFadingToNeutral = false;
+    ClearTouchedMorphTargets();
+    TouchedMorphTargets.Reset();
+    TouchedMorphTargetMask.Reset();
+
+    if (MetaHumanMeshComponent)
     {
-        TSharedPtr<FJsonObject> FrameObject = FramesArray[i]->AsObject();
-        
-        FBlendshapeFrame Frame;
-        Frame.FrameNumber = FrameObject->GetIntegerField(TEXT("frame"));
-        
-        // Extract blendshape values
-        TSharedPtr<FJsonObject> BlendshapesObject = FrameObject->GetObjectField(TEXT("blendshapes"));
-        for (auto& Pair : BlendshapesObject->Values)
+        RemoveTickPrerequisiteComponent(MetaHumanMeshComponent);
+        MetaHumanMeshComponent->RemoveTickPrerequisiteActor(this);
+        if (UMetaHumanStreamingSubsystem* Subsystem = StreamingSubsystem.Get())
         {
-            Frame.BlendshapeValues.Add(Pair.Key, Pair.Value->AsNumber());
+            MetaHumanMeshComponent->PrimaryComponentTick.RemovePrerequisite(Subsystem, Subsystem->GetPreMeshUpdateTickFunction());
+        }
+
+        UMetaHumanStreamingAnimInstance* AnimInstance = Cast<UMetaHumanStreamingAnimInstance>(MetaHumanMeshComponent->GetAnimInstance());
+        if (AnimInstance && AnimInstance->GetStreamingReceiver() == this)
+        {
+            AnimInstance->SetStreamingReceiver(nullptr);
         }
-        
-        BlendshapeFrames.Add(Frame);
     }
-    
-    return BlendshapeFrames;
+
+    MetaHumanMeshComponent = InSkeletalMeshComponent;
+    UpdateMeshTickDependency();
+
+    // Hand the curve pose to the mesh's anim instance, if it can output it
+    if (UMetaHumanStreamingAnimInstance* AnimInstance = MetaHumanMeshComponent ? Cast<UMetaHumanStreamingAnimInstance>(MetaHumanMeshComponent->GetAnimInstance()) : nullptr)
+    {
+        AnimInstance->SetStreamingReceiver(this);
+    }
+
+    // Resolve the channels of the current animation against the new mesh
+    BindChannelsToMesh(CurrentAnimationData.BlendshapeTimeline.ChannelNames);
 }
 
-void UMetaHumanStreamingReceiver::ApplyBlendshapesToMesh(const TMap<FString, float>& BlendshapeValues)
+void UMetaHumanStreamingReceiver::SetOutputAnimationCurves(bool bOutputCurves)
 {
-    if (!MetaHumanMeshComponent)
+    if (bOutputCurves == bOutputAnimationCurves)
     {
-        UE_LOG(LogTemp, Error, TEXT("MetaHuman mesh component not set"));
         return;
     }
-    
-    // Apply each blendshape value to the mesh
-    for (auto& Pair : BlendshapeValues)
-    {
-        // In a real implementation, you would map the blendshape names to the
-        // corresponding morph target names in the MetaHuman mesh
-        FString MorphTargetName = Pair.Key;
-        float Value = Pair.Value;
-        
-        // Set morph target value
-        MetaHumanMeshComponent->SetMorphTarget(*MorphTargetName, Value);
-    }
+
+    // Leave the mesh neutral on the old path; the new one takes over from the next pose
+    bIsFadingToNeutral = false;
+    ClearTouchedMorphTargets();
+    bOutputAnimationCurves = bOutputCurves;
+    UpdateMeshTickDependency();
 }
 
-void UMetaHumanStreamingReceiver::StartAnimation()
+void UMetaHumanStreamingReceiver::UpdateMeshTickDependency()
 {
-    if (!CurrentAnimationData.AudioData || CurrentAnimationData.BlendshapeFrames.Num() == 0)
+    if (!MetaHumanMeshComponent)
     {
-        UE_LOG(LogTemp, Error, TEXT("Cannot start animation: Invalid animation data"));
         return;
     }
-    
-    // Set up audio component
-    AudioComponent->SetSound(CurrentAnimationData.AudioData);
-    
-    // Reset animation state
-    CurrentFrame = 0;
-    AnimationTime = 0.0f;
-    bIsAnimating = true;
-    
-    // Start audio playback
-    AudioComponent->Play();
-    
-    UE_LOG(LogTemp, Log, TEXT("Started animation with %d blendshape frames"), CurrentAnimationData.BlendshapeFrames.Num());
-}
 
-void UMetaHumanStreamingReceiver::StopAnimation()
-{
-    if (bIsAnimating)
+    UMetaHumanStreamingSubsystem* Subsystem = StreamingSubsystem.Get();
+    if (bOutputAnimationCurves)
     {
-        // Stop audio playback
-        AudioComponent->Stop();
-        
-        // Reset animation state
-        bIsAnimating = false;
-        CurrentFrame = 0;
-        AnimationTime = 0.0f;
-        
-        // Reset all blendshapes to zero
-        if (MetaHumanMeshComponent)
+        // Publish before the mesh's anim instance copies the pose, from the receiver's tick or the subsystem's pre-mesh update
+        RemoveTickPrerequisiteComponent(MetaHumanMeshComponent);
+        MetaHumanMeshComponent->AddTickPrerequisiteActor(this);
+        if (Subsystem)
         {
-            TArray<FName> MorphTargetNames;
-            MetaHumanMeshComponent->GetAllMorphTargetNames(MorphTargetNames);
-            
-            for (const FName& MorphTargetName : MorphTargetNames)
-            {
-                MetaHumanMeshComponent->SetMorphTarget(MorphTargetName, 0.0f);
-            }
+            MetaHumanMeshComponent->PrimaryComponentTick.AddPrerequisite(Subsystem, Subsystem->GetPreMeshUpdateTickFunction());
+        }
+
+        if (!Cast<UMetaHumanStreamingAnimInstance>(MetaHumanMeshComponent->GetAnimInstance()))
+        {
+            UE_LOG(LogTemp, Warning, TEXT("Anim instance of %s is not a UMetaHumanStreamingAnimInstance; streamed curves will not be shown"),
+                *MetaHumanMeshComponent->GetName());
+        }
+    }
+    else if (IsUsingBulkMorphTargetWrites())
+    {
+        // Tick after the mesh so bulk weight writes land after its morph targets are refreshed
+        MetaHumanMeshComponent->RemoveTickPrerequisiteActor(this);
+        AddTickPrerequisiteComponent(MetaHumanMeshComponent);
+        if (Subsystem)
+        {
+            MetaHumanMeshComponent->PrimaryComponentTick.RemovePrerequisite(Subsystem, Subsystem->GetPreMeshUpdateTickFunction());
+        }
+    }
+    else
+    {
+        // Per-name writes made before the mesh ticks are shown this frame; after it, only on the next
+        RemoveTickPrerequisiteComponent(MetaHumanMeshComponent);
+        MetaHumanMeshComponent->AddTickPrerequisiteActor(this);
+        if (Subsystem)
+        {
+            MetaHumanMeshComponent->PrimaryComponentTick.AddPrerequisite(Subsystem, Subsystem->GetPreMeshUpdateTickFunction());
+        }
+
+        if (bUseBulkMorphTargetWrites)
+        {
+            UE_LOG(LogTemp, Log, TEXT("Bulk morph target writes are unsafe for %s; applying blendshapes per name. Set bOutputAnimationCurves to move the work off the game thread"),
+                *MetaHumanMeshComponent->GetName());
         }
-        
-        UE_LOG(LogTemp, Log, TEXT("Stopped animation"));
     }
 }
 
-void UMetaHumanStreamingReceiver::UpdateAnimation(float DeltaTime)
+void UMetaHumanStreamingReceiver::BindPoseChannels(const TArray<FString>& ChannelNames)
 {
-    // Update animation time
-    AnimationTime += DeltaTime;
-    
-    // Check if animation has finished
-    if (AnimationTime >= CurrentAnimationData.Duration)
+    if (!IsPlaybackActive())
     {
-        StopAnimation();
-        return;
+        BindChannelsToMesh(ChannelNames);
     }
-    
-    // Calculate current frame based on time and frame rate
-    int32 TargetFrame = FMath::FloorToInt(AnimationTime * FrameRate);
-    
-    // Apply blendshapes for the current frame
-    if (TargetFrame != CurrentFrame && TargetFrame < CurrentAnimationData.BlendshapeFrames.Num())
+}
+
+void UMetaHumanStreamingReceiver::ApplyPose(TArrayView<const float> Weights)
+{
+    if (!IsPlaybackActive() && Weights.Num() == ChannelBindings.Num())
     {
-        CurrentFrame = TargetFrame;
-        ApplyBlendshapesToMesh(CurrentAnimationData.BlendshapeFrames[CurrentFrame].BlendshapeValues);
+        ApplyWeights(Weights);
     }
 }
 
-void UMetaHumanStreamingReceiver::OnWebSocketConnected()
+void UMetaHumanStreamingReceiver::ClearPose()
 {
-    UE_LOG(LogTemp, Log, TEXT("WebSocket connected"));
+    if (!IsPlaybackActive())
+    {
+        ClearTouchedMorphTargets();
+    }
 }
 
-void UMetaHumanStreamingReceiver::OnWebSocketConnectionError(const FString& Error)
+void UMetaHumanStreamingReceiver::ProcessReceivedData(const FString& AudioBase64, const FString& BlendshapeData)
 {
-    UE_LOG(LogTemp, Error, TEXT("WebSocket connection error: %s"), *Error);
+    // Decode audio data
+    FMetaHumanIngestResult Result;
+    if (!FMetaHumanIngestPipeline::DecodeAudioBase64(AudioBase64, Result.AudioData) ||
+        !FMetaHumanIngestPipeline::DecodeUtteranceAudio(Result))
+    {
+        UE_LOG(LogTemp, Error, TEXT("Failed to decode audio data"));
+        return;
+    }
+
+    // Parse blendshape data
+    if (!FMetaHumanIngestPipeline::ParseBlendshapeJson(BlendshapeData, FrameRate, Result.BlendshapeTimeline))
+    {
+        UE_LOG(LogTemp, Error, TEXT("Failed to parse blendshape data"));
+        return;
+    }
+
+    // Play it, or queue it behind the current utterance
+    EnqueueUtterance(MoveTemp(Result));
 }
 
-void UMetaHumanStreamingReceiver::OnWebSocketClosed(int32 StatusCode, const FString& Reason, bool bWasClean)
+void UMetaHumanStreamingReceiver::ProcessReceivedBinaryData(const FString& AudioBase64, const TArray<uint8>& BlendshapeBytes)
 {
-    UE_LOG(LogTemp, Log, TEXT("WebSocket closed: %d, %s, Clean: %s"), 
-        StatusCode, *Reason, bWasClean ? TEXT("true") : TEXT("false"));
+    // Decode audio data
+    FMetaHumanIngestResult Result;
+    if (!FMetaHumanIngestPipeline::DecodeAudioBase64(AudioBase64, Result.AudioData) ||
+        !FMetaHumanIngestPipeline::DecodeUtteranceAudio(Result))
+    {
+        UE_LOG(LogTemp, Error, TEXT("Failed to decode audio data"));
+        return;
+    }
+
+    // Decode binary blendshape data
+    if (!FMetaHumanBlendshapeCodec::Decode(BlendshapeBytes, Result.BlendshapeTimeline) || Result.BlendshapeTimeline.IsEmpty())
+    {
+        UE_LOG(LogTemp, Error, TEXT("Failed to decode binary blendshape data"));
+        return;
+    }
+
+    // Play it, or queue it behind the current utterance
+    EnqueueUtterance(MoveTemp(Result));
 }
 
-void UMetaHumanStreamingReceiver::OnWebSocketMessage(const FString& Message)
+bool UMetaHumanStreamingReceiver::ProcessReceivedMessage(const TSharedPtr<FJsonObject>& JsonObject)
 {
-    // Parse the message as JSON
-    TSharedPtr<FJsonObject> JsonObject;
-    TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Message);
-    if (!FJsonSerializer::Deserialize(Reader, JsonObject) || !JsonObject.IsValid())
+    // Decode synchronously and commit right away
+    FMetaHumanIngestResult Result;
+    if (!FMetaHumanIngestPipeline::DecodeMessageObject(JsonObject, FrameRate, Result))
     {
-        UE_LOG(LogTemp, Error, TEXT("Failed to parse WebSocket message as JSON"));
-        return;
+        return false;
     }
-    
-    // Extract audio and blendshape data
-    FString AudioBase64 = JsonObject->GetStringField(TEXT("audio_base64"));
-    FString BlendshapeData = JsonObject->GetObjectField(TEXT("blendshapes"))->ToJsonString();
-    
-    // Process the received data
-    ProcessReceivedData(AudioBase64, BlendshapeData);
+
+    return CommitIngestResult(Result);
 }
 
-void UMetaHumanStreamingReceiver::OnHTTPResponseReceived(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bSucceeded)
+void UMetaHumanStreamingReceiver::IngestMessageAsync(const FString& Message)
 {
-    if (!bSucceeded || !Response.IsValid())
+    // A receiver plays one character, so an interrupt stops it whichever character is named
+    FString CharacterId;
+    if (FMetaHumanIngestPipeline::IsInterruptMessage(Message, CharacterId))
     {
-        UE_LOG(LogTemp, Error, TEXT("HTTP request failed"));
+        Interrupt();
         return;
     }
-    
-    // Parse the response as JSON
-    TSharedPtr<FJsonObject> JsonObject;
-    TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Response->GetContentAsString());
-    if (!FJsonSerializer::Deserialize(Reader, JsonObject) || !JsonObject.IsValid())
+    IngestQueue.IngestMessageAsync(FString(), Message, FrameRate, MakeIngestCommitCallback());
+}
+
+void UMetaHumanStreamingReceiver::IngestBinaryMessageAsync(TArray<uint8>&& Message)
+{
+    FString CharacterId;
+    if (FMetaHumanIngestPipeline::IsInterruptMessage(Message, CharacterId))
     {
-        UE_LOG(LogTemp, Error, TEXT("Failed to parse HTTP response as JSON"));
+        Interrupt();
+        return;
+    }
+    IngestQueue.IngestBinaryMessageAsync(FString(), MoveTemp(Message), MakeIngestCommitCallback());
+}
+
+TFunction<void()> UMetaHumanStreamingReceiver::MakeIngestCommitCallback()
+{
+    TWeakObjectPtr<UMetaHumanStreamingReceiver> WeakThis(this);
+    return [WeakThis]()
+    {
+        if (UMetaHumanStreamingReceiver* Receiver = WeakThis.Get())
+        {
+            Receiver->IngestQueue.CommitCompleted([Receiver](FMetaHumanIngestResult& Result)
+            {
+                Receiver->CommitIngestResult(Result);
+            });
+        }
+    };
+}
+
+bool UMetaHumanStreamingReceiver::CommitIngestResult(FMetaHumanIngestResult& Result)
+{
+    const double StartTime = FPlatformTime::Seconds();
+
+    switch (Result.Type)
+    {
+    case EMetaHumanIngestMessageType::Utterance:
+        // Decoding is done; play the utterance or queue it behind the current one
+        if (!EnqueueUtterance(MoveTemp(Result)))
+        {
+            return false;
+        }
+        break;
+    case EMetaHumanIngestMessageType::StreamStart:
+        BeginStream(Result.SampleRate, Result.NumChannels, Result.FrameRate, Result.AudioCodec);
+        break;
+    case EMetaHumanIngestMessageType::StreamChunk:
+        // Hand the buffer holding the audio over to the chunk instead of copying the audio out of it
+        if (Result.BinaryAudioSize > 0)
+        {
+            InsertStreamChunk(Result.Sequence, Result.Timestamp, MoveTemp(Result.BinaryMessage), Result.BinaryAudioOffset, Result.BinaryAudioSize, MoveTemp(Result.BlendshapeTimeline));
+        }
+        else
+        {
+            const int32 AudioSize = Result.AudioData.Num();
+            InsertStreamChunk(Result.Sequence, Result.Timestamp, MoveTemp(Result.AudioData), 0, AudioSize, MoveTemp(Result.BlendshapeTimeline));
+        }
+        break;
+    case EMetaHumanIngestMessageType::StreamEnd:
+        EndStream();
+        break;
+    case EMetaHumanIngestMessageType::Interrupt:
+        Interrupt();
+        break;
+    }
+
+    // Report per-stage timings
+    FMetaHumanIngestTimings& Timings = Result.Timings;
+    Timings.CommitSeconds = FPlatformTime::Seconds() - StartTime;
+    SET_FLOAT_STAT(STAT_MetaHumanIngestQueue, Timings.QueueSeconds * 1000.0);
+    SET_FLOAT_STAT(STAT_MetaHumanIngestParse, Timings.ParseSeconds * 1000.0);
+    SET_FLOAT_STAT(STAT_MetaHumanIngestAudioDecode, Timings.AudioDecodeSeconds * 1000.0);
+    SET_FLOAT_STAT(STAT_MetaHumanIngestBlendshapeDecode, Timings.BlendshapeDecodeSeconds * 1000.0);
+    SET_FLOAT_STAT(STAT_MetaHumanIngestCommit, Timings.CommitSeconds * 1000.0);
+    UE_LOG(LogTemp, Verbose, TEXT("Ingest timings (ms): queue %.2f, parse %.2f, audio %.2f, blendshapes %.2f, commit %.2f"),
+        Timings.QueueSeconds * 1000.0, Timings.ParseSeconds * 1000.0, Timings.AudioDecodeSeconds * 1000.0,
+        Timings.BlendshapeDecodeSeconds * 1000.0, Timings.CommitSeconds * 1000.0);
+
+    return true;
+}
+
+void UMetaHumanStreamingReceiver::BeginStream(int32 SampleRate, int32 NumChannels, float InFrameRate, EMetaHumanAudioCodec Codec)
+{
+    // A stream supersedes utterances still waiting to play
+    UtteranceQueue.Reset();
+    ReportQueuedUtterances();
+
+    // Stop any current animation or stream
+    StopAnimation();
+
+    if (SampleRate <= 0 || NumChannels <= 0 || InFrameRate <= 0.0f)
+    {
+        UE_LOG(LogTemp, Error, TEXT("Invalid stream format: %d Hz, %d channels, %f fps"), SampleRate, NumChannels, InFrameRate);
+        return;
+    }
+
+    // Opus chunks are decoded straight to the stream's sample rate
+    if (Codec == EMetaHumanAudioCodec::Opus && !StreamOpusDecoder.Initialize(SampleRate, NumChannels))
+    {
+        return;
+    }
+
+    // Take the procedural sound wave the chunks are queued on from the pool
+    StreamingSoundWave = SoundWavePool.Acquire(this, SampleRate, NumChannels, SoundWavePoolSize, FPlatformTime::Seconds());
+    StreamingSoundWave->Duration = INDEFINITELY_LOOPING_DURATION;
+
+    // Start with an empty timeline that chunks are written into
+    CurrentAnimationData.AudioData = StreamingSoundWave;
+    CurrentAnimationData.BlendshapeTimeline.Reset(TArray<FString>(), InFrameRate);
+    CurrentAnimationData.Duration = 0.0f;
+
+    bIsStreaming = true;
+    bStreamEnded = false;
+    NextStreamSequence = 0;
+    StreamingSampleRate = SampleRate;
+    StreamingNumChannels = NumChannels;
+    StreamingCodec = Codec;
+    StreamedAudioSeconds = 0.0;
+    StreamJitterBuffer.Reset(StreamingPrerollSeconds, FMath::Max(StreamingMaxDelaySeconds, StreamingPrerollSeconds));
+    WakePlayback();
+
+    UE_LOG(LogTemp, Log, TEXT("Began stream: %d Hz, %d channels, %.1f fps, %s"), SampleRate, NumChannels, InFrameRate,
+        Codec == EMetaHumanAudioCodec::Opus ? TEXT("Opus") : TEXT("PCM"));
+}
+
+void UMetaHumanStreamingReceiver::AppendStreamChunk(int32 Sequence, float Timestamp, const TArray<uint8>& PCMData, const FBlendshapeTimeline& BlendshapeFrames)
+{
+    InsertStreamChunk(Sequence, Timestamp, TArray<uint8>(PCMData), 0, PCMData.Num(), FBlendshapeTimeline(BlendshapeFrames));
+}
+
+void UMetaHumanStreamingReceiver::InsertStreamChunk(int32 Sequence, double Timestamp, TArray<uint8>&& AudioBuffer, int32 AudioOffset, int32 AudioSize, FBlendshapeTimeline&& BlendshapeFrames)
+{
+    if (!bIsStreaming || bStreamEnded)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Ignoring stream chunk %d: no stream in progress"), Sequence);
+        return;
+    }
+
+    // Wrap the chunk for the jitter buffer; the audio stays in the buffer it arrived in
+    check(AudioOffset >= 0 && AudioSize >= 0 && AudioOffset + AudioSize <= AudioBuffer.Num());
+    FMetaHumanStreamChunk Chunk;
+    Chunk.Sequence = Sequence;
+    Chunk.Timestamp = Timestamp;
+    Chunk.AudioBuffer = MoveTemp(AudioBuffer);
+    Chunk.AudioOffset = AudioOffset;
+    Chunk.AudioSize = AudioSize;
+    const TConstArrayView<uint8> PCMData = Chunk.GetAudio();
+    if (StreamingCodec == EMetaHumanAudioCodec::Opus)
+    {
+        // The duration of Opus packets is in their headers; decoding waits for release
+        if (!FMetaHumanOpusPackets::Split(PCMData, StreamOpusPackets))
+        {
+            UE_LOG(LogTemp, Warning, TEXT("Dropped stream chunk %d with malformed Opus packets"), Sequence);
+            return;
+        }
+        int32 NumFrames = 0;
+        for (const TConstArrayView<uint8>& Packet : StreamOpusPackets)
+        {
+            NumFrames += FMath::Max(FMetaHumanOpusPackets::GetNumFrames(Packet, StreamingSampleRate), 0);
+        }
+        Chunk.Duration = NumFrames / (double)StreamingSampleRate;
+    }
+    else
+    {
+        Chunk.Duration = PCMData.Num() / (double)(StreamingSampleRate * StreamingNumChannels * sizeof(int16));
+    }
+    Chunk.BlendshapeFrames = MoveTemp(BlendshapeFrames);
+
+    NextStreamSequence = FMath::Max(NextStreamSequence, Sequence + 1);
+    if (!StreamJitterBuffer.Insert(MoveTemp(Chunk), FPlatformTime::Seconds()))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Dropped late stream chunk %d"), Sequence);
+        return;
+    }
+
+    PumpStreamJitterBuffer();
+}
+
+void UMetaHumanStreamingReceiver::PumpStreamJitterBuffer()
+{
+    const double BytesPerSecond = (double)StreamingSampleRate * StreamingNumChannels * sizeof(int16);
+    const double SinkBufferedSeconds = StreamingSoundWave ? StreamingSoundWave->GetAvailableAudioByteCount() / BytesPerSecond : 0.0;
+
+    TArray<FMetaHumanStreamChunk> ReleasedChunks;
+    StreamJitterBuffer.Pop(SinkBufferedSeconds, bStreamEnded, ReleasedChunks);
+    for (const FMetaHumanStreamChunk& Chunk : ReleasedChunks)
+    {
+        CommitStreamChunk(Chunk);
+    }
+
+    // Start playback on the first release; the jitter buffer has already waited for its target depth
+    if (!bIsAnimating && StreamedAudioSeconds > 0.0)
+    {
+        StartAnimation();
+    }
+
+    const FMetaHumanJitterBufferStats Stats = StreamJitterBuffer.GetStats();
+    SET_FLOAT_STAT(STAT_MetaHumanStreamJitter, Stats.JitterSeconds * 1000.0f);
+    SET_FLOAT_STAT(STAT_MetaHumanStreamTargetDelay, Stats.TargetDelaySeconds * 1000.0f);
+    SET_DWORD_STAT(STAT_MetaHumanStreamUnderruns, Stats.Underruns);
+    SET_DWORD_STAT(STAT_MetaHumanStreamLateDrops, Stats.LateDrops);
+}
+
+void UMetaHumanStreamingReceiver::CommitStreamChunk(const FMetaHumanStreamChunk& Chunk)
+{
+    using namespace MetaHumanStreamingReceiver;
+
+    // Chunks were given up before this one; bring the audio up to where it starts
+    if (Chunk.NumLostBefore > 0)
+    {
+        FillStreamGap(Chunk.Timestamp - StreamedAudioSeconds);
+    }
+
+    // Decode Opus packets in stream order; a bad packet's audio is concealed, so the clock stays in step
+    TConstArrayView<uint8> PCMData = Chunk.GetAudio();
+    if (StreamingCodec == EMetaHumanAudioCodec::Opus && PCMData.Num() > 0)
+    {
+        StreamDecodedPCM.Reset();
+        FMetaHumanOpusPackets::Split(PCMData, StreamOpusPackets);
+        for (const TConstArrayView<uint8>& Packet : StreamOpusPackets)
+        {
+            if (StreamOpusDecoder.DecodePacket(Packet, StreamDecodedPCM) == INDEX_NONE)
+            {
+                StreamOpusDecoder.ConcealLoss(FMath::Max(FMetaHumanOpusPackets::GetNumFrames(Packet, StreamingSampleRate), 0), StreamDecodedPCM);
+            }
+        }
+        PCMData = StreamDecodedPCM;
+    }
+
+    // Queue the audio segment; the clock advances by the audio actually queued
+    if (PCMData.Num() > 0)
+    {
+        StreamingSoundWave->QueueAudio(PCMData.GetData(), PCMData.Num());
+        StreamedAudioSeconds += GetPCMDuration(PCMData.Num(), StreamingSampleRate, StreamingNumChannels);
+        CurrentAnimationData.Duration = StreamedAudioSeconds;
+    }
+
+    // Write the blendshape frame range at its timestamp
+    FBlendshapeTimeline& Timeline = CurrentAnimationData.BlendshapeTimeline;
+    if (!Chunk.BlendshapeFrames.IsEmpty())
+    {
+        Timeline.WriteFrames(FMath::RoundToInt(Chunk.Timestamp * Timeline.FrameRate), Chunk.BlendshapeFrames);
+        if (bIsAnimating && BoundChannelNames != Timeline.ChannelNames)
+        {
+            BindChannelsToMesh(Timeline.ChannelNames);
+        }
+    }
+}
+
+void UMetaHumanStreamingReceiver::FillStreamGap(double GapSeconds)
+{
+    const int32 NumFrames = FMath::RoundToInt(GapSeconds * StreamingSampleRate);
+    if (NumFrames <= 0 || !StreamingSoundWave)
+    {
+        return;
+    }
+
+    // Conceal the lost audio of an Opus stream; otherwise fill it with silence
+    TArray<uint8> GapPCM;
+    const bool bConceal = StreamingCodec == EMetaHumanAudioCodec::Opus && StreamOpusDecoder.IsInitialized();
+    if (bConceal)
+    {
+        StreamOpusDecoder.ConcealLoss(NumFrames, GapPCM);
+    }
+    else
+    {
+        GapPCM.SetNumZeroed(NumFrames * StreamingNumChannels * sizeof(int16));
+    }
+    StreamingSoundWave->QueueAudio(GapPCM.GetData(), GapPCM.Num());
+    StreamedAudioSeconds += NumFrames / (double)StreamingSampleRate;
+    CurrentAnimationData.Duration = StreamedAudioSeconds;
+    UE_LOG(LogTemp, Warning, TEXT("%s %.1f ms of lost stream audio"), bConceal ? TEXT("Concealed") : TEXT("Filled with silence"), NumFrames * 1000.0 / StreamingSampleRate);
+}
+
+FMetaHumanJitterBufferStats UMetaHumanStreamingReceiver::GetStreamingStats() const
+{
+    return StreamJitterBuffer.GetStats();
+}
+
+void UMetaHumanStreamingReceiver::EndStream()
+{
+    if (!bIsStreaming)
+    {
+        return;
+    }
+
+    bStreamEnded = true;
+
+    // Drain the jitter buffer; short utterances may end before reaching the preroll
+    PumpStreamJitterBuffer();
+
+    const FMetaHumanJitterBufferStats Stats = StreamJitterBuffer.GetStats();
+    UE_LOG(LogTemp, Log, TEXT("Ended stream after %d chunks (%.2f seconds of audio, jitter %.1f ms, %d underruns, %d late drops, %d lost)"),
+        NextStreamSequence, StreamedAudioSeconds, Stats.JitterSeconds * 1000.0f, Stats.Underruns, Stats.LateDrops, Stats.LostChunks);
+}
+
+void UMetaHumanStreamingReceiver::CommitAnimationData(USoundWave* SoundWave, double Duration, FBlendshapeTimeline&& BlendshapeTimeline)
+{
+    // Set up current animation data
+    CurrentAnimationData.AudioData = SoundWave;
+    CurrentAnimationData.BlendshapeTimeline = MoveTemp(BlendshapeTimeline);
+    CurrentAnimationData.Duration = Duration;
+
+    // Start the animation
+    StartAnimation();
+}
+
+bool UMetaHumanStreamingReceiver::EnqueueUtterance(FMetaHumanIngestResult&& Result)
+{
+    using namespace MetaHumanStreamingReceiver;
+
+    // Play right away when nothing is playing, or cut the current utterance off when queueing is disabled
+    if (MaxQueuedUtterances <= 0 || (!bIsAnimating && !bIsStreaming && UtteranceQueue.Num() == 0))
+    {
+        UtteranceQueue.Reset();
+        return PlayUtterance(Result);
+    }
+
+    if (UtteranceQueue.Num() >= MaxQueuedUtterances)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Dropping utterance: %d utterances are already queued"), UtteranceQueue.Num());
+        return false;
+    }
+
+    if (Result.SampleRate <= 0 || Result.NumChannels <= 0 || Result.BlendshapeTimeline.IsEmpty())
+    {
+        UE_LOG(LogTemp, Error, TEXT("Cannot queue utterance: %d Hz, %d channels, %d blendshape frames"),
+            Result.SampleRate, Result.NumChannels, Result.BlendshapeTimeline.GetNumFrames());
+        return false;
+    }
+
+    // Keep the decoded message as is; its audio is only copied when it is queued on a sound wave
+    FMetaHumanQueuedUtterance& Queued = UtteranceQueue.AddDefaulted_GetRef();
+    Queued.Duration = GetPCMDuration(Result.GetAudio().Num(), Result.SampleRate, Result.NumChannels);
+    Queued.Result = MoveTemp(Result);
+    ReportQueuedUtterances();
+
+    // Append its audio to the playing sound wave now, so it follows on the next sample
+    ChainQueuedUtterances();
+    WakePlayback();
+    return true;
+}
+
+bool UMetaHumanStreamingReceiver::PlayUtterance(FMetaHumanIngestResult& Result)
+{
+    using namespace MetaHumanStreamingReceiver;
+
+    // Stop any current animation
+    StopAnimation();
+
+    // Only the sound wave has to be created on the game thread
+    const TConstArrayView<uint8> PCMData = GetWholeFrames(Result.GetAudio(), Result.NumChannels);
+    USoundWave* SoundWave = CreateSoundWave(PCMData, Result.SampleRate, Result.NumChannels);
+    if (!SoundWave)
+    {
+        UE_LOG(LogTemp, Error, TEXT("Failed to decode audio data"));
+        return false;
+    }
+
+    PlayingSampleRate = Result.SampleRate;
+    PlayingNumChannels = Result.NumChannels;
+    CommitAnimationData(SoundWave, GetPCMDuration(PCMData.Num(), Result.SampleRate, Result.NumChannels), MoveTemp(Result.BlendshapeTimeline));
+    if (!bIsAnimating)
+    {
+        // Hand the sound wave back
+        StopAnimation();
+        return false;
+    }
+
+    // Utterances that were waiting for a new sound wave can follow this one on it
+    ChainQueuedUtterances();
+    return true;
+}
+
+void UMetaHumanStreamingReceiver::PlayNextQueuedUtterance()
+{
+    while (UtteranceQueue.Num() > 0)
+    {
+        FMetaHumanQueuedUtterance Next = MoveTemp(UtteranceQueue[0]);
+        UtteranceQueue.RemoveAt(0);
+        ReportQueuedUtterances();
+
+        if (PlayUtterance(Next.Result))
+        {
+            return;
+        }
+    }
+}
+
+void UMetaHumanStreamingReceiver::ChainQueuedUtterances()
+{
+    using namespace MetaHumanStreamingReceiver;
+
+    UMetaHumanClockedSoundWave* SoundWave = Cast<UMetaHumanClockedSoundWave>(CurrentAnimationData.AudioData);
+    if (!bIsAnimating || bIsStreaming || !SoundWave)
+    {
+        return;
+    }
+
+    // Each utterance's audio starts on the sample after the previous one ends
+    for (FMetaHumanQueuedUtterance& Queued : UtteranceQueue)
+    {
+        if (Queued.StartTime >= 0.0)
+        {
+            continue;
+        }
+        if (Queued.Result.SampleRate != PlayingSampleRate || Queued.Result.NumChannels != PlayingNumChannels)
+        {
+            break;
+        }
+
+        const TConstArrayView<uint8> PCMData = GetWholeFrames(Queued.Result.GetAudio(), PlayingNumChannels);
+        SoundWave->QueueAudio(PCMData.GetData(), PCMData.Num());
+        Queued.StartTime = QueuedAudioEnd;
+        QueuedAudioEnd += Queued.Duration;
+    }
+}
+
+void UMetaHumanStreamingReceiver::AdvanceToQueuedUtterance()
+{
+    FMetaHumanQueuedUtterance Next = MoveTemp(UtteranceQueue[0]);
+    UtteranceQueue.RemoveAt(0);
+    ReportQueuedUtterances();
+
+    // Keep the pose the finished utterance ends on, for the next one to blend in from
+    FBlendshapeTimeline& Timeline = CurrentAnimationData.BlendshapeTimeline;
+    FBlendshapeTimeline& NextTimeline = Next.Result.BlendshapeTimeline;
+    if (UtteranceBlendMilliseconds > 0.0f && !Timeline.IsEmpty() && Timeline.ChannelNames == NextTimeline.ChannelNames)
+    {
+        CarriedWeights.SetNumUninitialized(Timeline.GetNumChannels());
+        Timeline.Sample(CurrentAnimationData.Duration, BlendshapeInterpolation, CarriedWeights);
+    }
+    else
+    {
+        CarriedWeights.Reset();
+    }
+
+    // A different channel table leaves morph targets the new utterance does not drive; clear them first
+    if (BoundChannelNames != NextTimeline.ChannelNames)
+    {
+        ClearTouchedMorphTargets();
+        BindChannelsToMesh(NextTimeline.ChannelNames);
+    }
+
+    CurrentUtteranceStart = Next.StartTime;
+    CurrentAnimationData.Duration = Next.Duration;
+    CurrentAnimationData.BlendshapeTimeline = MoveTemp(NextTimeline);
+    CurrentFrame = INDEX_NONE;
+
+    UE_LOG(LogTemp, Log, TEXT("Continued with queued utterance at %.3f seconds (%d blendshape frames, %.2f seconds)"),
+        CurrentUtteranceStart, CurrentAnimationData.BlendshapeTimeline.GetNumFrames(), CurrentAnimationData.Duration);
+}
+
+USoundWave* UMetaHumanStreamingReceiver::CreateSoundWave(TConstArrayView<uint8> PCMData, int32 SampleRate, int32 NumChannels)
+{
+    if (SampleRate <= 0 || NumChannels <= 0)
+    {
+        UE_LOG(LogTemp, Error, TEXT("Invalid audio format: %d Hz, %d channels"), SampleRate, NumChannels);
+        return nullptr;
+    }
+
+    // Play through a clocked procedural wave so lip-sync can follow the samples actually rendered;
+    // the pool hands back an empty one set to the decoded format
+    UMetaHumanClockedSoundWave* SoundWave = SoundWavePool.Acquire(this, SampleRate, NumChannels, SoundWavePoolSize, FPlatformTime::Seconds());
+    
+    // Queue the decoded PCM; the wave plays until it is stopped so queued utterances can follow
+    SoundWave->QueueAudio(PCMData.GetData(), PCMData.Num());
+    SoundWave->Duration = INDEFINITELY_LOOPING_DURATION;
+    
+    return SoundWave;
+}
+
+void UMetaHumanStreamingReceiver::BindChannelsToMesh(const TArray<FString>& ChannelNames)
+{
+    using namespace MetaHumanStreamingReceiver;
+
+    BoundChannelNames = ChannelNames;
+    ChannelBindings.Reset(ChannelNames.Num());
+    ChannelBindings.AddDefaulted(ChannelNames.Num());
+    LastAppliedWeights.Init(UnappliedWeight, ChannelNames.Num());
+
+    // Curves are named after the channels; they need no mesh to be published
+    CurvePose.CurveNames.Reset(ChannelNames.Num());
+    for (const FString& ChannelName : ChannelNames)
+    {
+        CurvePose.CurveNames.Add(FName(*ChannelName));
+    }
+    CurvePose.Weights.Reset();
+    CurvePose.CurveTableSerial++;
+
+    USkeletalMesh* SkeletalMesh = MetaHumanMeshComponent ? MetaHumanMeshComponent->GetSkeletalMeshAsset() : nullptr;
+    if (!SkeletalMesh)
+    {
+        return;
+    }
+
+    TouchedMorphTargetMask.SetNum(SkeletalMesh->GetMorphTargets().Num(), false);
+
+    // Resolve each channel name to a morph target once
+    TArray<FString> UnknownChannels;
+    for (int32 ChannelIndex = 0; ChannelIndex < ChannelNames.Num(); ChannelIndex++)
+    {
+        // In a real implementation, you would map the blendshape names to the
+        // corresponding morph target names in the MetaHuman mesh
+        FMorphTargetBinding& Binding = ChannelBindings[ChannelIndex];
+        Binding.MorphTargetName = CurvePose.CurveNames[ChannelIndex];
+        if (!SkeletalMesh->FindMorphTargetAndIndex(Binding.MorphTargetName, Binding.MorphTargetIndex))
+        {
+            Binding.MorphTargetIndex = INDEX_NONE;
+            UnknownChannels.Add(ChannelNames[ChannelIndex]);
+            continue;
+        }
+
+        // Every bound morph target is written by the animation, so it has to be reset afterwards
+        if (!TouchedMorphTargetMask[Binding.MorphTargetIndex])
+        {
+            TouchedMorphTargetMask[Binding.MorphTargetIndex] = true;
+            TouchedMorphTargets.Add(Binding);
+        }
+    }
+
+    if (UnknownChannels.Num() > 0)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("%d blendshape channels have no matching morph target and will be ignored: %s"),
+            UnknownChannels.Num(), *FString::Join(UnknownChannels, TEXT(", ")));
+    }
+}
+
+void UMetaHumanStreamingReceiver::ApplyBlendshapesToMesh(TArrayView<const float> Weights)
+{
+    if (!MetaHumanMeshComponent)
+    {
+        UE_LOG(LogTemp, Error, TEXT("MetaHuman mesh component not set"));
+        return;
+    }
+    
+    SCOPE_CYCLE_COUNTER(STAT_MetaHumanApplyBlendshapes);
+    check(Weights.Num() == ChannelBindings.Num());
+
+    // Only channels that moved by more than the threshold are submitted
+    MetaHumanStreamingReceiver::GatherChangedChannels(Weights, LastAppliedWeights, MorphTargetUpdateThreshold, ChangedChannels);
+    SkippedUpdatesInWindow += Weights.Num() - ChangedChannels.Num();
+
+    // Apply each changed blendshape value to its bound morph target
+    for (const int32 ChannelIndex : ChangedChannels)
+    {
+        const FMorphTargetBinding& Binding = ChannelBindings[ChannelIndex];
+        if (Binding.MorphTargetIndex == INDEX_NONE)
+        {
+            continue;
+        }
+        
+        // Set morph target value
+        MetaHumanMeshComponent->SetMorphTarget(Binding.MorphTargetName, Weights[ChannelIndex]);
+    }
+
+    // Publish the skipped updates once per second
+    const double Now = FPlatformTime::Seconds();
+    if (Now - SkippedUpdatesWindowStart >= 1.0)
+    {
+        SET_DWORD_STAT(STAT_MetaHumanSkippedUpdates, SkippedUpdatesWindowStart > 0.0 ? (uint32)(SkippedUpdatesInWindow / (Now - SkippedUpdatesWindowStart)) : 0);
+        SkippedUpdatesInWindow = 0;
+        SkippedUpdatesWindowStart = Now;
+    }
+}
+
+void UMetaHumanStreamingReceiver::ApplyWeightRowToMesh(TArrayView<const float> Weights)
+{
+    SCOPE_CYCLE_COUNTER(STAT_MetaHumanApplyWeightRow);
+
+    check(Weights.Num() == ChannelBindings.Num());
+    SET_DWORD_STAT(STAT_MetaHumanBoundChannels, ChannelBindings.Num());
+
+    WriteMorphTargetWeights(ChannelBindings, Weights);
+}
+
+void UMetaHumanStreamingReceiver::WriteMorphTargetWeights(TArrayView<const FMorphTargetBinding> Bindings, TArrayView<const float> Weights)
+{
+#if METAHUMAN_BULK_MORPH_TARGET_WRITES
+    USkeletalMesh* SkeletalMesh = MetaHumanMeshComponent ? MetaHumanMeshComponent->GetSkeletalMeshAsset() : nullptr;
+    if (!SkeletalMesh)
+    {
+        UE_LOG(LogTemp, Error, TEXT("MetaHuman mesh component not set"));
+        return;
+    }
+
+    check(Weights.Num() == Bindings.Num());
+
+    // Make sure the weight array covers every morph target of the mesh
+    const TArray<UMorphTarget*>& MorphTargets = SkeletalMesh->GetMorphTargets();
+    TArray<float>& MorphTargetWeights = MetaHumanMeshComponent->MorphTargetWeights;
+    TArray<FActiveMorphTarget>& ActiveMorphTargets = MetaHumanMeshComponent->ActiveMorphTargets;
+    if (MorphTargetWeights.Num() != MorphTargets.Num())
+    {
+        MorphTargetWeights.SetNumZeroed(MorphTargets.Num());
+    }
+
+    // Note which morph targets the mesh already considers active
+    TBitArray<> ActiveMask(false, MorphTargets.Num());
+    for (const FActiveMorphTarget& ActiveMorphTarget : ActiveMorphTargets)
+    {
+        if (ActiveMask.IsValidIndex(ActiveMorphTarget.WeightIndex))
+        {
+            ActiveMask[ActiveMorphTarget.WeightIndex] = true;
+        }
+    }
+
+    // Write the whole row through the bindings
+    for (int32 ChannelIndex = 0; ChannelIndex < Weights.Num(); ChannelIndex++)
+    {
+        const int32 MorphTargetIndex = Bindings[ChannelIndex].MorphTargetIndex;
+        if (MorphTargetIndex == INDEX_NONE)
+        {
+            continue;
+        }
+
+        MorphTargetWeights[MorphTargetIndex] = Weights[ChannelIndex];
+        if (!ActiveMask[MorphTargetIndex])
+        {
+            ActiveMask[MorphTargetIndex] = true;
+            ActiveMorphTargets.Add(FActiveMorphTarget(MorphTargets[MorphTargetIndex], MorphTargetIndex));
+        }
+    }
+
+    // Send the new weights to the renderer once for the whole row
+    MetaHumanMeshComponent->MarkRenderDynamicDataDirty();
+#else
+    // IsUsingBulkMorphTargetWrites never lets bulk writes through on this engine version
+    checkNoEntry();
+#endif
+}
+
+bool UMetaHumanStreamingReceiver::IsUsingBulkMorphTargetWrites() const
+{
+#if METAHUMAN_BULK_MORPH_TARGET_WRITES
+    // An anim instance rebuilds the morph target arrays while it evaluates, possibly on a worker thread
+    return bUseBulkMorphTargetWrites && !bOutputAnimationCurves && MetaHumanMeshComponent && !MetaHumanMeshComponent->GetAnimInstance();
+#else
+    return false;
+#endif
+}
+
+void UMetaHumanStreamingReceiver::ApplyWeights(TArrayView<const float> Weights)
+{
+    if (bOutputAnimationCurves)
+    {
+        PublishCurvePose(Weights);
+    }
+    else if (IsUsingBulkMorphTargetWrites())
+    {
+        ApplyWeightRowToMesh(Weights);
+    }
+    else
+    {
+        ApplyBlendshapesToMesh(Weights);
+    }
+}
+
+void UMetaHumanStreamingReceiver::PublishCurvePose(TArrayView<const float> Weights)
+{
+    SCOPE_CYCLE_COUNTER(STAT_MetaHumanPublishCurvePose);
+
+    // One copy of the row; the per-channel curve writes happen on the anim worker threads
+    check(Weights.Num() == CurvePose.CurveNames.Num());
+    CurvePose.Weights.SetNumUninitialized(Weights.Num(), false);
+    FMemory::Memcpy(CurvePose.Weights.GetData(), Weights.GetData(), Weights.Num() * sizeof(float));
+    CurvePose.Alpha = 1.0f;
+}
+
+void UMetaHumanStreamingReceiver::StartAnimation()
+{
+    if (!CurrentAnimationData.AudioData || (!bIsStreaming && CurrentAnimationData.BlendshapeTimeline.IsEmpty()))
+    {
+        UE_LOG(LogTemp, Error, TEXT("Cannot start animation: Invalid animation data"));
+        return;
+    }
+    
+    // Bind the channels once per stream; consecutive utterances usually share a channel table
+    if (BoundChannelNames != CurrentAnimationData.BlendshapeTimeline.ChannelNames)
+    {
+        BindChannelsToMesh(CurrentAnimationData.BlendshapeTimeline.ChannelNames);
+    }
+    
+    // A fade still in progress would fight the new animation; finish it at once
+    if (bIsFadingToNeutral)
+    {
+        bIsFadingToNeutral = false;
+        ClearTouchedMorphTargets();
+    }
+    FinishInterruptFade();
+
+    // Set up audio component
+    AudioComponent->SetSound(CurrentAnimationData.AudioData);
+    
+    // Reset animation state
+    CurrentFrame = 0;
+    AnimationTime = 0.0f;
+    AccumulatedTickTime = 0.0;
+    CurrentUtteranceStart = 0.0;
+    QueuedAudioEnd = CurrentAnimationData.Duration;
+    CarriedWeights.Reset();
+    OutputLatency = GetAudioOutputLatency();
+    bIsAnimating = true;
+    
+    // Start audio playback
+    AudioComponent->Play();
+    WakePlayback();
+    
+    UE_LOG(LogTemp, Log, TEXT("Started animation with %d blendshape frames (%d channels, %llu bytes)"),
+        CurrentAnimationData.BlendshapeTimeline.GetNumFrames(),
+        CurrentAnimationData.BlendshapeTimeline.GetNumChannels(),
+        (uint64)CurrentAnimationData.BlendshapeTimeline.GetAllocatedSize());
+}
+
+void UMetaHumanStreamingReceiver::StopAnimation(bool bInterrupted)
+{
+    // Drop any stream in progress, including one still waiting for preroll
+    if (bIsStreaming)
+    {
+        bIsStreaming = false;
+        bStreamEnded = false;
+        StreamedAudioSeconds = 0.0;
+        StreamingSoundWave = nullptr;
+        StreamOpusDecoder.Reset();
+    }
+
+    if (bIsAnimating)
+    {
+        // Stop audio playback, unless an interrupt is fading it out on the render thread
+        if (!bInterrupted || !FadingSoundWave)
+        {
+            AudioComponent->Stop();
+        }
+        
+        // Reset animation state
+        bIsAnimating = false;
+        CurrentFrame = 0;
+        AnimationTime = 0.0f;
+        
+        // Return the blendshapes to neutral, over NeutralFadeMilliseconds (or InterruptFadeMilliseconds) if set
+        const float FadeMilliseconds = bInterrupted ? InterruptFadeMilliseconds : NeutralFadeMilliseconds;
+        if (FadeMilliseconds > 0.0f)
+        {
+            BeginNeutralFade(FadeMilliseconds);
+        }
+        else
+        {
+            ClearTouchedMorphTargets();
+        }
+        
+        UE_LOG(LogTemp, Log, TEXT("Stopped animation"));
+    }
+
+    // Hand the sound wave back; the pool waits for the renderer to let go of it before reusing it
+    SoundWavePool.Release(CurrentAnimationData.AudioData, FPlatformTime::Seconds());
+    CurrentAnimationData.AudioData = nullptr;
+
+    // Queued utterances chained onto that sound wave have to be queued again on the next one
+    for (FMetaHumanQueuedUtterance& Queued : UtteranceQueue)
+    {
+        Queued.StartTime = -1.0;
+    }
+    CurrentUtteranceStart = 0.0;
+    QueuedAudioEnd = 0.0;
+}
+
+void UMetaHumanStreamingReceiver::Interrupt()
+{
+    // Drop queued utterances, and messages still being decoded once they complete
+    UtteranceQueue.Reset();
+    ReportQueuedUtterances();
+    IngestQueue.Interrupt(FString());
+
+    if (!bIsAnimating && !bIsStreaming)
+    {
+        UE_LOG(LogTemp, Log, TEXT("Interrupt received with nothing playing"));
+        return;
+    }
+
+    InterruptTime = FPlatformTime::Seconds();
+
+    // Fade the audio out on the render thread and let it play until the fade has been heard
+    UMetaHumanClockedSoundWave* ClockedSoundWave = Cast<UMetaHumanClockedSoundWave>(CurrentAnimationData.AudioData);
+    if (bIsAnimating && ClockedSoundWave && InterruptFadeMilliseconds > 0.0f)
+    {
+        FinishInterruptFade();
+        const int32 SampleRate = bIsStreaming ? StreamingSampleRate : PlayingSampleRate;
+        ClockedSoundWave->BeginFadeOut(FMath::CeilToInt(InterruptFadeMilliseconds * SampleRate / 1000.0f));
+        FadingSoundWave = ClockedSoundWave;
+        FadingSoundWaveDeadline = InterruptTime + InterruptFadeMilliseconds / 1000.0 + OutputLatency + MaxInterruptFadeWaitSeconds;
+        CurrentAnimationData.AudioData = nullptr;
+    }
+    else if (bIsAnimating)
+    {
+        // Stopping cuts the audio at once; it goes quiet after the output latency
+        LastInterruptToSilenceSeconds = (float)OutputLatency;
+        SET_FLOAT_STAT(STAT_MetaHumanInterruptToSilence, LastInterruptToSilenceSeconds * 1000.0f);
+    }
+
+    StopAnimation(true);
+    WakePlayback();
+    UE_LOG(LogTemp, Log, TEXT("Interrupted playback"));
+}
+
+void UMetaHumanStreamingReceiver::UpdateInterruptFade()
+{
+    const double Now = FPlatformTime::Seconds();
+    double FadeCompleteTime = 0.0;
+    const bool bFadeComplete = FadingSoundWave->GetFadeOutCompleteTime(FadeCompleteTime);
+    if (bFadeComplete && Now < FadeCompleteTime + OutputLatency)
+    {
+        return;
+    }
+    if (!bFadeComplete && Now < FadingSoundWaveDeadline)
+    {
+        return;
+    }
+
+    // Report the time from the interrupt until the last faded sample was heard
+    if (bFadeComplete)
+    {
+        LastInterruptToSilenceSeconds = (float)(FadeCompleteTime + OutputLatency - InterruptTime);
+        SET_FLOAT_STAT(STAT_MetaHumanInterruptToSilence, LastInterruptToSilenceSeconds * 1000.0f);
+        UE_LOG(LogTemp, Log, TEXT("Interrupt silenced audio after %.1f ms"), LastInterruptToSilenceSeconds * 1000.0f);
+    }
+    else
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Interrupt fade did not finish rendering; stopping the sound"));
+    }
+
+    FinishInterruptFade();
+}
+
+void UMetaHumanStreamingReceiver::FinishInterruptFade()
+{
+    if (!FadingSoundWave)
+    {
+        return;
+    }
+
+    // The component may have moved on to another sound in the meantime
+    if (AudioComponent && AudioComponent->Sound == FadingSoundWave)
+    {
+        AudioComponent->Stop();
+    }
+    SoundWavePool.Release(FadingSoundWave, FPlatformTime::Seconds());
+    FadingSoundWave = nullptr;
+}
+
+void UMetaHumanStreamingReceiver::ClearTouchedMorphTargets()
+{
+    // The mesh is neutral afterwards, whichever path wrote to it
+    for (float& Weight : LastAppliedWeights)
+    {
+        Weight = 0.0f;
+    }
+    CurvePose.Alpha = 0.0f;
+
+    // Curves never touch the morph targets themselves
+    if (!MetaHumanMeshComponent || bOutputAnimationCurves)
+    {
+        return;
+    }
+
+    // Bulk writes are dropped when the mesh refreshes its morph targets; per-name curves persist,
+    // so zero them, which also removes them from the mesh
+    for (const FMorphTargetBinding& Touched : TouchedMorphTargets)
+    {
+        MetaHumanMeshComponent->SetMorphTarget(Touched.MorphTargetName, 0.0f);
+    }
+}
+
+void UMetaHumanStreamingReceiver::BeginNeutralFade(float FadeMilliseconds)
+{
+    const bool bHasPose = bOutputAnimationCurves ? CurvePose.Alpha > 0.0f : MetaHumanMeshComponent && TouchedMorphTargets.Num() > 0;
+    if (!bHasPose)
+    {
+        ClearTouchedMorphTargets();
+        return;
+    }
+
+    if (bOutputAnimationCurves)
+    {
+        // Fade the pose's hold on the curves, so they return to the anim graph
+        NeutralFadeStartCurveAlpha = CurvePose.Alpha;
+    }
+    else
+    {
+        // Fade from the weights the mesh shows now
+        NeutralFadeStartWeights.SetNumUninitialized(TouchedMorphTargets.Num());
+        for (int32 TouchedIndex = 0; TouchedIndex < TouchedMorphTargets.Num(); TouchedIndex++)
+        {
+            NeutralFadeStartWeights[TouchedIndex] = MetaHumanMeshComponent->GetMorphTarget(TouchedMorphTargets[TouchedIndex].MorphTargetName);
+        }
+#if METAHUMAN_BULK_MORPH_TARGET_WRITES
+        if (IsUsingBulkMorphTargetWrites())
+        {
+            const TArray<float>& MorphTargetWeights = MetaHumanMeshComponent->MorphTargetWeights;
+            for (int32 TouchedIndex = 0; TouchedIndex < TouchedMorphTargets.Num(); TouchedIndex++)
+            {
+                const int32 MorphTargetIndex = TouchedMorphTargets[TouchedIndex].MorphTargetIndex;
+                NeutralFadeStartWeights[TouchedIndex] = MorphTargetWeights.IsValidIndex(MorphTargetIndex) ? MorphTargetWeights[MorphTargetIndex] : 0.0f;
+            }
+        }
+#endif
+    }
+
+    NeutralFadeTime = 0.0f;
+    NeutralFadeDuration = FadeMilliseconds;
+    bIsFadingToNeutral = true;
+    WakePlayback();
+}
+
+void UMetaHumanStreamingReceiver::UpdateNeutralFade(float DeltaTime)
+{
+    NeutralFadeTime += DeltaTime;
+    const float Alpha = 1.0f - FMath::Clamp(NeutralFadeTime * 1000.0f / FMath::Max(NeutralFadeDuration, UE_KINDA_SMALL_NUMBER), 0.0f, 1.0f);
+    if (Alpha <= 0.0f || (!MetaHumanMeshComponent && !bOutputAnimationCurves))
+    {
+        bIsFadingToNeutral = false;
+        ClearTouchedMorphTargets();
+        return;
+    }
+
+    if (bOutputAnimationCurves)
+    {
+        CurvePose.Alpha = NeutralFadeStartCurveAlpha * Alpha;
+        return;
+    }
+
+    // Scale every touched morph target toward zero in one pass
+    FadeWeights.SetNumUninitialized(NeutralFadeStartWeights.Num());
+    for (int32 TouchedIndex = 0; TouchedIndex < NeutralFadeStartWeights.Num(); TouchedIndex++)
+    {
+        FadeWeights[TouchedIndex] = NeutralFadeStartWeights[TouchedIndex] * Alpha;
+    }
+
+    if (IsUsingBulkMorphTargetWrites())
+    {
+        WriteMorphTargetWeights(TouchedMorphTargets, FadeWeights);
+    }
+    else
+    {
+        for (int32 TouchedIndex = 0; TouchedIndex < TouchedMorphTargets.Num(); TouchedIndex++)
+        {
+            MetaHumanMeshComponent->SetMorphTarget(TouchedMorphTargets[TouchedIndex].MorphTargetName, FadeWeights[TouchedIndex]);
+        }
+    }
+}
+
+bool UMetaHumanStreamingReceiver::AdvanceAnimation(float DeltaTime)
+{
+    // Follow the audio clock once the audio reports a position; tick time drifts from it
+    AccumulatedTickTime += DeltaTime;
+    double AudioTime = 0.0;
+    const bool bHasAudioTime = GetAudioClockTime(AudioTime);
+    if (bSyncToAudioClock && bHasAudioTime)
+    {
+        AnimationTime = (float)AudioTime;
+    }
+    else
+    {
+        AnimationTime += DeltaTime;
+    }
+    
+    // Move on to queued utterances whose audio follows on the same sound wave
+    while (!bIsStreaming && AnimationTime >= CurrentUtteranceStart + CurrentAnimationData.Duration &&
+        UtteranceQueue.Num() > 0 && UtteranceQueue[0].StartTime >= 0.0)
+    {
+        AdvanceToQueuedUtterance();
+    }
+    
+    // Check if animation has finished
+    if (AnimationTime >= CurrentUtteranceStart + CurrentAnimationData.Duration)
+    {
+        // A stream that is still open or buffered has run out of data; hold until more arrives
+        if (bIsStreaming && (!bStreamEnded || !StreamJitterBuffer.IsEmpty()))
+        {
+            AnimationTime = CurrentUtteranceStart + CurrentAnimationData.Duration;
+        }
+        else
+        {
+            // Utterances that could not follow on this sound wave start on a new one
+            StopAnimation();
+            PlayNextQueuedUtterance();
+            return false;
+        }
+    }
+    
+    // Record the time into the current utterance for the sample phase
+    const FBlendshapeTimeline& Timeline = CurrentAnimationData.BlendshapeTimeline;
+    if (Timeline.IsEmpty())
+    {
+        return false;
+    }
+    PoseEvaluation.UtteranceTime = AnimationTime - CurrentUtteranceStart;
+    PoseEvaluation.TargetFrame = FMath::FloorToInt(PoseEvaluation.UtteranceTime * Timeline.FrameRate);
+    PoseEvaluation.bHasAudioTime = bHasAudioTime;
+    PoseEvaluation.AudioTime = AudioTime;
+    
+    // A queued utterance blends in from the pose the previous one ended on
+    PoseEvaluation.bBlendingIn = CarriedWeights.Num() == Timeline.GetNumChannels() && PoseEvaluation.UtteranceTime * 1000.0 < UtteranceBlendMilliseconds;
+    return true;
+}
+
+void UMetaHumanStreamingReceiver::SampleAnimation()
+{
+    // Calculate current frame based on the time into the current utterance and its frame rate
+    const FBlendshapeTimeline& Timeline = CurrentAnimationData.BlendshapeTimeline;
+    const double UtteranceTime = PoseEvaluation.UtteranceTime;
+    const int32 TargetFrame = PoseEvaluation.TargetFrame;
+    PoseEvaluation.ShownTime = UtteranceTime;
+    
+    // Interpolated or blended weights change every tick, so evaluate and apply them every tick
+    if (BlendshapeInterpolation != EBlendshapeInterpolation::Step || PoseEvaluation.bBlendingIn)
+    {
+        CurrentFrame = FMath::Clamp(TargetFrame, 0, Timeline.GetNumFrames() - 1);
+        SampledWeights.SetNumUninitialized(Timeline.GetNumChannels(), false);
+        Timeline.Sample(UtteranceTime, BlendshapeInterpolation, SampledWeights);
+        if (PoseEvaluation.bBlendingIn)
+        {
+            const float Alpha = (float)(UtteranceTime * 1000.0 / UtteranceBlendMilliseconds);
+            for (int32 ChannelIndex = 0; ChannelIndex < SampledWeights.Num(); ChannelIndex++)
+            {
+                SampledWeights[ChannelIndex] = FMath::Lerp(CarriedWeights[ChannelIndex], SampledWeights[ChannelIndex], Alpha);
+            }
+        }
+        else if (BlendshapeInterpolation == EBlendshapeInterpolation::Step)
+        {
+            PoseEvaluation.ShownTime = CurrentFrame / Timeline.FrameRate;
+        }
+        PoseEvaluation.Apply = EMetaHumanPoseApply::SampledWeights;
+    }
+    // Bulk writes are refreshed away by the mesh each tick, so re-apply the current row every tick
+    else if (IsUsingBulkMorphTargetWrites())
+    {
+        CurrentFrame = FMath::Clamp(TargetFrame, 0, Timeline.GetNumFrames() - 1);
+        PoseEvaluation.ShownTime = CurrentFrame / Timeline.FrameRate;
+        PoseEvaluation.Apply = EMetaHumanPoseApply::TimelineRow;
+    }
+    // Apply blendshapes for the current frame
+    else
+    {
+        if (TargetFrame != CurrentFrame && TargetFrame < Timeline.GetNumFrames())
+        {
+            CurrentFrame = TargetFrame;
+            PoseEvaluation.Apply = EMetaHumanPoseApply::TimelineRow;
+        }
+        PoseEvaluation.ShownTime = FMath::Max(CurrentFrame, 0) / Timeline.FrameRate;
+    }
+}
+
+void UMetaHumanStreamingReceiver::ApplyAnimation()
+{
+    switch (PoseEvaluation.Apply)
+    {
+    case EMetaHumanPoseApply::SampledWeights:
+        ApplyWeights(SampledWeights);
+        break;
+    case EMetaHumanPoseApply::TimelineRow:
+        ApplyWeights(CurrentAnimationData.BlendshapeTimeline.GetRow(CurrentFrame));
+        break;
+    default:
+        break;
+    }
+
+    // Report how far the shown pose is from the audio, and how far tick time has drifted from it
+    if (PoseEvaluation.bHasAudioTime)
+    {
+        SET_FLOAT_STAT(STAT_MetaHumanAVOffset, (CurrentUtteranceStart + PoseEvaluation.ShownTime - PoseEvaluation.AudioTime) * 1000.0);
+        SET_FLOAT_STAT(STAT_MetaHumanTickTimeDrift, (AccumulatedTickTime - PoseEvaluation.AudioTime) * 1000.0);
+    }
+}
+
+bool UMetaHumanStreamingReceiver::GetAudioClockTime(double& OutSeconds) const
+{
+    // Every sound the receiver plays counts its rendered samples on the audio render thread
+    const UMetaHumanClockedSoundWave* ClockedSoundWave = Cast<UMetaHumanClockedSoundWave>(CurrentAnimationData.AudioData);
+    if (!ClockedSoundWave)
+    {
+        return false;
+    }
+
+    return ClockedSoundWave->GetClock().GetPlaybackTime(FPlatformTime::Seconds(), OutputLatency, OutSeconds);
+}
+
+double UMetaHumanStreamingReceiver::GetAudioOutputLatency() const
+{
+    using namespace MetaHumanStreamingReceiver;
+
+    if (AudioOutputLatencySeconds >= 0.0f)
+    {
+        return AudioOutputLatencySeconds;
+    }
+
+    // Samples are pulled a few mixer buffers ahead of the device, which queues its own buffers
+    UWorld* World = GetWorld();
+    FAudioDevice* AudioDevice = World ? World->GetAudioDeviceRaw() : nullptr;
+    if (!AudioDevice || AudioDevice->GetSampleRate() <= 0.0f)
+    {
+        return 0.0;
+    }
+    const int32 BufferedFrames = AudioDevice->GetBufferLength() * (AudioDevice->GetNumBuffers() + SourceBufferCount);
+    return BufferedFrames / (double)AudioDevice->GetSampleRate();
+}
+
+void UMetaHumanStreamingReceiver::OnHTTPResponseReceived(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bSucceeded)
+{
+    if (!bSucceeded || !Response.IsValid())
+    {
+        UE_LOG(LogTemp, Error, TEXT("HTTP request failed"));
         return;
     }
     
-    // Extract audio and blendshape data
-    FString AudioBase64 = JsonObject->GetStringField(TEXT("audio_base64"));
-    FString BlendshapeData = JsonObject->GetObjectField(TEXT("blendshapes"))->ToJsonString();
-    
-    // Process the received data
-    ProcessReceivedData(AudioBase64, BlendshapeData);
+    // Parse and decode off the game thread
+    IngestMessageAsync(Response->GetContentAsString());
 }
@@ -12,13 +12,22 @@
  * - Components/AudioComponent.h: Component for playing audio
  * - Interfaces/IHttpRequest.h: HTTP request functionality
  * - WebSocketsModule.h: WebSocket functionality
- * - IWebSocket.h: WebSocket interface
+ * - MetaHumanWebSocketConnection.h: WebSocket connection to the backend
  * 
  * The class handles:
  * - Receiving data via HTTP or WebSocket
  * - Decoding audio data
  * - Applying blendshapes to the MetaHuman
  * - Synchronizing audio playback with facial animation
+ * - Queueing utterances that arrive while one is playing, and playing them back to back
+ * - Interrupting playback when the user talks over the character
+ *
+ * The receiver only ticks while it has something to play or fade: its tick is turned off
+ * when playback goes idle and back on when an utterance or stream is committed.
+ *
+ * With bOutputAnimationCurves, poses are not written to the mesh's morph targets. The
+ * receiver publishes each pose as an FMetaHumanCurvePose instead, and the mesh's
+ * UMetaHumanStreamingAnimInstance outputs it as animation curves on the anim worker threads.
  */
 
 #pragma once
@@ -29,17 +38,27 @@
 #include "Components/AudioComponent.h"
 #include "Interfaces/IHttpRequest.h"
 #include "WebSocketsModule.h"
-#include "IWebSocket.h"
+#include "MetaHumanBlendshapeTimeline.h"
+#include "MetaHumanJitterBuffer.h"
+#include "MetaHumanIngestPipeline.h"
+#include "MetaHumanOpus.h"
+#include "MetaHumanWebSocketConnection.h"
+#include "MetaHumanSoundWavePool.h"
 #include "MetaHumanStreamingReceiver.generated.h"
 
 // Forward declarations
 class USkeletalMeshComponent;
+class UMetaHumanClockedSoundWave;
+class UMetaHumanStreamingSubsystem;
+class UMetaHumanStreamingAnimInstance;
+class FJsonObject;
 
 /**
  * Structure to hold blendshape data for a single frame
  * 
  * This struct represents the facial animation data for a single frame of animation.
  * It contains the frame number and a map of blendshape names to values.
+ * Playback uses FBlendshapeTimeline; this struct is kept for Blueprint-facing data.
  * 
  * USTRUCT: Unreal Engine macro for defining a struct that can be used in Blueprint
  * GENERATED_BODY: Unreal Engine macro for generating boilerplate code
@@ -76,15 +95,108 @@ struct FMetaHumanAnimationData
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Animation")
     USoundWave* AudioData;
 
-    // Blendshape frames for the animation
+    // Blendshape timeline for the animation (frames x channels)
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Animation")
-    TArray<FBlendshapeFrame> BlendshapeFrames;
+    FBlendshapeTimeline BlendshapeTimeline;
 
     // Duration of the animation in seconds
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Animation")
     float Duration;
 };
 
+/**
+ * Resolved morph target for one blendshape channel
+ * 
+ * This struct caches the result of looking up a blendshape channel on the MetaHuman mesh,
+ * so per-frame application does not repeat string conversion or name lookups.
+ */
+struct FMorphTargetBinding
+{
+    // Name of the morph target on the mesh
+    FName MorphTargetName;
+
+    // Index of the morph target in the mesh's morph target array, or INDEX_NONE if the channel is unknown
+    int32 MorphTargetIndex = INDEX_NONE;
+};
+
+/**
+ * Decoded utterance waiting behind the one that is playing
+ */
+struct FMetaHumanQueuedUtterance
+{
+    // Decoded message; its audio stays where it was decoded until it is played
+    FMetaHumanIngestResult Result;
+
+    // Time on the playing sound wave where the utterance's audio starts, or a negative value until it has been queued there
+    double StartTime = -1.0;
+
+    // Seconds of audio in the utterance
+    double Duration = 0.0;
+};
+
+/**
+ * What the apply phase of a playback update writes to the mesh
+ */
+enum class EMetaHumanPoseApply : uint8
+{
+    // Nothing changed since the last update
+    None,
+
+    // The row sampled into SampledWeights
+    SampledWeights,
+
+    // The timeline row of the current frame
+    TimelineRow
+};
+
+/**
+ * Pose evaluation of one playback update, carried from the advance phase through the
+ * sample phase to the apply phase
+ */
+struct FMetaHumanPoseEvaluation
+{
+    // Whether the advance phase left a pose to sample and apply
+    bool bHasPose = false;
+
+    // Whether the animation was playing when the update began
+    bool bWasAnimating = false;
+
+    // Whether the pose blends in from the previous utterance's last pose
+    bool bBlendingIn = false;
+
+    // Time into the current utterance, and the frame it falls on
+    double UtteranceTime = 0.0;
+    int32 TargetFrame = 0;
+
+    // Audio clock position, if the audio reports one
+    bool bHasAudioTime = false;
+    double AudioTime = 0.0;
+
+    // Time into the utterance of the pose actually shown
+    double ShownTime = 0.0;
+
+    // What the apply phase writes
+    EMetaHumanPoseApply Apply = EMetaHumanPoseApply::None;
+};
+
+/**
+ * Pose published for UMetaHumanStreamingAnimInstance to output as animation curves
+ */
+struct FMetaHumanCurvePose
+{
+    // Curve driven by each channel
+    TArray<FName> CurveNames;
+
+    // Weight of each channel
+    TArray<float> Weights;
+
+    // How much the pose overrides the curves of the anim graph, from 0 (not at all) to 1
+    float Alpha = 0.0f;
+
+    // Incremented whenever CurveNames changes, so readers know to resolve the names again
+    uint32 CurveTableSerial = 0;
+};
+
 /**
  * Actor class that receives and processes streaming data for MetaHuman animation
  * 
@@ -164,17 +276,27 @@ public:
      * 
      * This function sets the skeletal mesh component to animate.
      * The skeletal mesh component should be the MetaHuman character's mesh.
+     * Channel bindings are rebuilt for the new mesh.
      * 
      * @param InSkeletalMeshComponent - The skeletal mesh component to animate
      */
     UFUNCTION(BlueprintCallable, Category = "MetaHuman|Streaming")
     void SetMetaHumanMesh(USkeletalMeshComponent* InSkeletalMeshComponent);
 
+    /**
+     * Get the MetaHuman skeletal mesh component being animated
+     *
+     * @return USkeletalMeshComponent* - The mesh, or null if none is set
+     */
+    UFUNCTION(BlueprintPure, Category = "MetaHuman|Streaming")
+    USkeletalMeshComponent* GetMetaHumanMesh() const { return MetaHumanMeshComponent; }
+
     /**
      * Process received data from the backend
      * 
      * This function processes the received audio and blendshape data.
-     * It decodes the audio data, parses the blendshape data, and starts the animation.
+     * It decodes the audio data, parses the blendshape data, and plays the utterance,
+     * or queues it behind the one that is playing.
      * 
      * @param AudioBase64 - Base64-encoded audio data
      * @param BlendshapeData - JSON string containing blendshape data
@@ -182,6 +304,353 @@ public:
     UFUNCTION(BlueprintCallable, Category = "MetaHuman|Streaming")
     void ProcessReceivedData(const FString& AudioBase64, const FString& BlendshapeData);
 
+    /**
+     * Process received data with binary-encoded blendshapes
+     * 
+     * This function processes audio together with blendshapes in the binary wire format
+     * produced by FMetaHumanBlendshapeCodec. The frame rate stored in the payload
+     * is used for playback. Like ProcessReceivedData, it queues the utterance if one is playing.
+     * 
+     * @param AudioBase64 - Base64-encoded audio data
+     * @param BlendshapeBytes - Binary blendshape payload
+     */
+    UFUNCTION(BlueprintCallable, Category = "MetaHuman|Streaming")
+    void ProcessReceivedBinaryData(const FString& AudioBase64, const TArray<uint8>& BlendshapeBytes);
+
+    /**
+     * Process a received message object
+     * 
+     * This function extracts the audio and blendshape data from a parsed message and
+     * commits it on the calling (game) thread. Messages with a "type" of
+     * "stream_start", "stream_chunk" or "stream_end" drive streaming playback.
+     * Blendshapes are read from "blendshapes_binary" (base64-encoded binary payload)
+     * when present, and from the "blendshapes" JSON object otherwise.
+     * 
+     * @param JsonObject - The parsed message
+     * @return bool - True if the message contained usable data
+     */
+    bool ProcessReceivedMessage(const TSharedPtr<FJsonObject>& JsonObject);
+
+    /**
+     * Ingest a message asynchronously
+     * 
+     * This function parses the message and decodes its audio and blendshapes on a worker
+     * task. Only committing the decoded result happens on the game thread. Results are
+     * committed in the order the messages were ingested, and the time spent in each
+     * stage is reported through the MetaHumanStreaming stat group.
+     * 
+     * @param Message - The JSON message text
+     */
+    UFUNCTION(BlueprintCallable, Category = "MetaHuman|Streaming")
+    void IngestMessageAsync(const FString& Message);
+
+    /**
+     * Decode a binary message on a worker task and commit it on the game thread
+     * 
+     * This function takes ownership of the message bytes (see MetaHumanBinaryMessage.h)
+     * and otherwise behaves like IngestMessageAsync. Binary and text messages share the
+     * same commit order.
+     * 
+     * @param Message - The complete binary message
+     */
+    void IngestBinaryMessageAsync(TArray<uint8>&& Message);
+
+    /**
+     * Commit a decoded message on the game thread
+     * 
+     * This function starts an utterance or drives the current stream from a decoded message.
+     * UMetaHumanStreamingSubsystem calls it for messages it decoded and routed to this receiver.
+     * 
+     * @param Result - The decoded message
+     * @return bool - True if the message was committed
+     */
+    bool CommitIngestResult(FMetaHumanIngestResult& Result);
+
+    /**
+     * Advance playback by one frame
+     * 
+     * This function releases streamed chunks, starts queued utterances, and updates the
+     * animation, the fade to neutral and any interrupt fade. Tick calls it; receivers
+     * registered with UMetaHumanStreamingSubsystem have their tick disabled and are
+     * updated by the subsystem's single pass over all characters instead.
+     * It runs BeginPlaybackUpdate, SamplePlayback and EndPlaybackUpdate in turn.
+     * 
+     * @param DeltaTime - Time elapsed since the last frame
+     */
+    void UpdatePlayback(float DeltaTime);
+
+    /**
+     * First phase of a playback update (game thread)
+     * 
+     * This function releases streamed chunks, starts queued utterances, and advances the
+     * animation time, moving on to or stopping at the end of utterances.
+     * 
+     * @param DeltaTime - Time elapsed since the last frame
+     * @return bool - True if there is a pose for SamplePlayback to evaluate
+     */
+    bool BeginPlaybackUpdate(float DeltaTime);
+
+    /**
+     * Second phase of a playback update (any thread)
+     * 
+     * This function evaluates the timeline at the time BeginPlaybackUpdate settled on. It
+     * touches only this receiver's own data and no UObject, so the subsystem can sample
+     * several receivers in parallel.
+     */
+    void SamplePlayback();
+
+    /**
+     * Last phase of a playback update (game thread)
+     * 
+     * This function writes the sampled pose to the mesh, and updates the fade to neutral
+     * and any interrupt fade.
+     * 
+     * @param DeltaTime - Time elapsed since the last frame
+     */
+    void EndPlaybackUpdate(float DeltaTime);
+
+    /**
+     * Check whether playback needs updating
+     * 
+     * @return bool - True while animating, streaming, fading, or holding queued utterances
+     */
+    bool IsPlaybackActive() const;
+
+    /**
+     * Set the subsystem that updates this receiver
+     * 
+     * The receiver's own tick stays off while a subsystem updates it; it asks the subsystem
+     * to update it again whenever playback becomes active. With bOutputAnimationCurves, the
+     * mesh ticks after the subsystem's pre-mesh update unless bulk morph target writes are in use.
+     * 
+     * @param InSubsystem - The subsystem, or null when the receiver ticks itself
+     */
+    void SetStreamingSubsystem(UMetaHumanStreamingSubsystem* InSubsystem);
+
+    /**
+     * Mark playback as awake or idle
+     * 
+     * This function turns the receiver's tick on or off (or adds it to its subsystem's update
+     * pass) and updates the Active Receivers and Idle Receivers stats. Waking is a no-op
+     * while playback is already awake.
+     * 
+     * @param bAwake - True while there is something to play or fade
+     */
+    void SetPlaybackAwake(bool bAwake);
+
+    /**
+     * Set when and how often the receiver ticks while playback is active
+     * 
+     * Receivers updated by UMetaHumanStreamingSubsystem follow the subsystem instead.
+     * 
+     * @param TickGroup - Tick group of the receiver's tick
+     * @param TickInterval - Seconds between ticks; 0 ticks every frame
+     */
+    UFUNCTION(BlueprintCallable, Category = "MetaHuman|Streaming")
+    void SetPlaybackTick(TEnumAsByte<ETickingGroup> TickGroup, float TickInterval);
+
+    /**
+     * Begin a streamed utterance
+     * 
+     * This function stops any current animation, drops queued utterances, and prepares a
+     * procedural sound wave and an empty timeline that chunks are appended to. Chunks pass through a jitter buffer;
+     * playback starts once its target depth (at least StreamingPrerollSeconds) of audio
+     * has been received or the stream ends.
+     * 
+     * @param SampleRate - Sample rate of the streamed audio
+     * @param NumChannels - Number of audio channels
+     * @param InFrameRate - Frame rate of the streamed blendshapes
+     * @param Codec - Codec of the chunks' audio; Opus chunks are decoded as they are released
+     */
+    UFUNCTION(BlueprintCallable, Category = "MetaHuman|Streaming")
+    void BeginStream(int32 SampleRate, int32 NumChannels, float InFrameRate, EMetaHumanAudioCodec Codec = EMetaHumanAudioCodec::PCM);
+
+    /**
+     * Append a chunk to the streamed utterance
+     * 
+     * This function inserts the chunk into the stream's jitter buffer. Chunks are released
+     * from the buffer in sequence order; on release the chunk's audio is queued on the
+     * procedural sound wave and its blendshape frames are written into the growing
+     * timeline at the frame matching Timestamp. Late or duplicate chunks are dropped.
+     * 
+     * @param Sequence - Sequence number of the chunk, starting at 0
+     * @param Timestamp - Stream time of the chunk's first audio sample and blendshape frame, in seconds
+     * @param PCMData - Audio of the chunk: 16-bit PCM, or length-prefixed Opus packets for an Opus stream
+     * @param BlendshapeFrames - Blendshape frames of the chunk
+     */
+    UFUNCTION(BlueprintCallable, Category = "MetaHuman|Streaming")
+    void AppendStreamChunk(int32 Sequence, float Timestamp, const TArray<uint8>& PCMData, const FBlendshapeTimeline& BlendshapeFrames);
+
+    /**
+     * End the streamed utterance
+     * 
+     * This function marks the stream as complete. Playback starts if it was still
+     * waiting for preroll, and the animation stops once all received audio has played.
+     */
+    UFUNCTION(BlueprintCallable, Category = "MetaHuman|Streaming")
+    void EndStream();
+
+    /**
+     * Get the state of the streaming jitter buffer
+     * 
+     * @return FMetaHumanJitterBufferStats - Jitter, target depth, underruns and late drops of the current stream
+     */
+    UFUNCTION(BlueprintPure, Category = "MetaHuman|Streaming")
+    FMetaHumanJitterBufferStats GetStreamingStats() const;
+
+    /**
+     * Interrupt playback, for barge-in
+     *
+     * This function fades the audio out on the audio render thread over
+     * InterruptFadeMilliseconds, starting with the next sample it renders, blends the
+     * blendshapes to neutral over the same time, ends any stream, and drops queued
+     * utterances as well as messages still being decoded. "interrupt" messages call it as
+     * soon as they arrive, without passing through the ingest queue. The time until the
+     * audio is silent is reported by GetLastInterruptToSilenceSeconds.
+     */
+    UFUNCTION(BlueprintCallable, Category = "MetaHuman|Streaming")
+    void Interrupt();
+
+    /**
+     * Get how long the last interrupt took to silence the audio
+     *
+     * @return float - Seconds from the interrupt until the end of the fade was heard, or a negative value if no interrupt has completed
+     */
+    UFUNCTION(BlueprintPure, Category = "MetaHuman|Streaming")
+    float GetLastInterruptToSilenceSeconds() const { return LastInterruptToSilenceSeconds; }
+
+    /**
+     * Get the number of utterances waiting behind the one that is playing
+     *
+     * @return int32 - Queued utterances
+     */
+    UFUNCTION(BlueprintPure, Category = "MetaHuman|Streaming")
+    int32 GetNumQueuedUtterances() const { return UtteranceQueue.Num(); }
+
+    /**
+     * Get the frame rate assumed for JSON blendshape payloads
+     *
+     * @return float - Frames per second
+     */
+    float GetFrameRate() const { return FrameRate; }
+
+    /**
+     * Get the pose published for the mesh's anim instance
+     *
+     * @return const FMetaHumanCurvePose& - The pose; only valid on the game thread
+     */
+    const FMetaHumanCurvePose& GetCurvePose() const { return CurvePose; }
+
+    /**
+     * Check whether poses are written to the mesh in bulk
+     *
+     * Bulk writes go straight into USkeletalMeshComponent's morph target arrays, which are
+     * engine internals. The path is only compiled for engine versions whose layout it knows
+     * (before 5.3), and is unsafe on a mesh with an anim instance, whose evaluation rebuilds
+     * those arrays on a worker thread. In either case blendshapes are applied per name;
+     * bOutputAnimationCurves is the supported way to move the work off the game thread.
+     *
+     * @return bool - True if bUseBulkMorphTargetWrites is set and the mesh can take bulk writes
+     */
+    UFUNCTION(BlueprintPure, Category = "MetaHuman|Streaming")
+    bool IsUsingBulkMorphTargetWrites() const;
+
+    /**
+     * Choose between writing poses to the mesh's morph targets and publishing them as curves
+     *
+     * With curves, the mesh ticks after the receiver so its anim instance reads the pose of
+     * the current frame. Receivers updated by UMetaHumanStreamingSubsystem publish from its
+     * pre-mesh update tick function, which the mesh ticks after in the same way.
+     *
+     * @param bOutputCurves - True to publish curves for UMetaHumanStreamingAnimInstance
+     */
+    UFUNCTION(BlueprintCallable, Category = "MetaHuman|Streaming")
+    void SetOutputAnimationCurves(bool bOutputCurves);
+
+    /**
+     * Bind a channel table for ApplyPose
+     *
+     * Does nothing while playback is active.
+     *
+     * @param ChannelNames - Channel table of the poses to apply
+     */
+    void BindPoseChannels(const TArray<FString>& ChannelNames);
+
+    /**
+     * Apply a pose through the receiver's output path outside of playback
+     *
+     * This function applies the weights as playback would. It is used to measure the
+     * output paths and does nothing while playback is active.
+     *
+     * @param Weights - Weight of each channel bound by BindPoseChannels
+     */
+    void ApplyPose(TArrayView<const float> Weights);
+
+    /**
+     * Return the mesh to neutral after ApplyPose
+     */
+    void ClearPose();
+
+    // Write whole weight rows into the mesh's active morph target arrays instead of calling SetMorphTarget per channel; see IsUsingBulkMorphTargetWrites
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "MetaHuman|Streaming")
+    bool bUseBulkMorphTargetWrites;
+
+    // Publish poses as animation curves for UMetaHumanStreamingAnimInstance instead of writing morph targets
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "MetaHuman|Streaming")
+    bool bOutputAnimationCurves;
+
+    // Smallest weight change submitted by the per-name apply path; smaller changes are skipped until they add up
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "MetaHuman|Streaming", meta = (ClampMin = "0.0"))
+    float MorphTargetUpdateThreshold;
+
+    // Milliseconds over which blendshapes fade to neutral when an animation stops; 0 resets them at once
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "MetaHuman|Streaming", meta = (ClampMin = "0.0"))
+    float NeutralFadeMilliseconds;
+
+    // How blendshapes are evaluated between received frames; interpolation keeps low frame rate data smooth at high render rates
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "MetaHuman|Streaming")
+    EBlendshapeInterpolation BlendshapeInterpolation;
+
+    // Milliseconds over which an interrupt fades the audio out and the blendshapes to neutral; 0 cuts both at once
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "MetaHuman|Streaming", meta = (ClampMin = "0.0"))
+    float InterruptFadeMilliseconds;
+
+    // Utterances that may wait behind the one that is playing; further ones are dropped. 0 makes each utterance cut off the previous one
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "MetaHuman|Streaming", meta = (ClampMin = "0"))
+    int32 MaxQueuedUtterances;
+
+    // Milliseconds over which a queued utterance blends in from the last pose of the one before it
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "MetaHuman|Streaming", meta = (ClampMin = "0.0"))
+    float UtteranceBlendMilliseconds;
+
+    // Number of sound waves recycled across utterances; more are created only while all of them are busy
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "MetaHuman|Streaming", meta = (ClampMin = "1"))
+    int32 SoundWavePoolSize;
+
+    // Seconds of streamed audio to buffer before streamed playback starts (lowest jitter buffer depth)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "MetaHuman|Streaming", meta = (ClampMin = "0.0"))
+    float StreamingPrerollSeconds;
+
+    // Highest depth the streaming jitter buffer may adapt to, in seconds
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "MetaHuman|Streaming", meta = (ClampMin = "0.0"))
+    float StreamingMaxDelaySeconds;
+
+    // Tick group the receiver ticks in while playback is active
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "MetaHuman|Streaming")
+    TEnumAsByte<ETickingGroup> PlaybackTickGroup;
+
+    // Seconds between the receiver's ticks while playback is active; 0 ticks every frame
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "MetaHuman|Streaming", meta = (ClampMin = "0.0"))
+    float PlaybackTickInterval;
+
+    // Derive animation time from the audio playback position instead of accumulating tick time
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "MetaHuman|Streaming")
+    bool bSyncToAudioClock;
+
+    // Seconds between the audio renderer pulling samples and them being heard; negative to estimate it from the audio device
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "MetaHuman|Streaming")
+    float AudioOutputLatencySeconds;
+
 private:
     // The skeletal mesh component of the MetaHuman to animate
     UPROPERTY()
@@ -191,8 +660,8 @@ private:
     UPROPERTY()
     UAudioComponent* AudioComponent;
 
-    // WebSocket instance for real-time communication
-    TSharedPtr<IWebSocket> WebSocket;
+    // WebSocket connection for real-time communication
+    FMetaHumanWebSocketConnection WebSocketConnection;
 
     // Current animation data being processed
     FMetaHumanAnimationData CurrentAnimationData;
@@ -200,52 +669,371 @@ private:
     // Flag indicating whether animation is currently playing
     bool bIsAnimating;
 
+    // Flag indicating whether playback is being updated, by the receiver's tick or its subsystem
+    bool bPlaybackAwake;
+
+    // Flag indicating whether the receiver is counted in the Active Receivers and Idle Receivers stats
+    bool bCountedInPlaybackStats;
+
     // Current frame being processed during animation
     int32 CurrentFrame;
 
-    // Time elapsed since animation started
+    // Time elapsed since animation started, on the clock of the playing sound wave
     float AnimationTime;
 
-    // Frame rate for blendshape animation (frames per second)
+    // Time on the playing sound wave where the current utterance starts
+    double CurrentUtteranceStart;
+
+    // Seconds of audio queued on the playing sound wave, including queued utterances chained onto it
+    double QueuedAudioEnd;
+
+    // Audio format of the playing utterance's sound wave
+    int32 PlayingSampleRate;
+    int32 PlayingNumChannels;
+
+    // Utterances waiting behind the current one, oldest first
+    TArray<FMetaHumanQueuedUtterance> UtteranceQueue;
+
+    // Length of UtteranceQueue last added to the Queued Utterances stat
+    int32 ReportedQueuedUtterances;
+
+    // Last pose of the previous utterance, which the current one blends in from
+    TArray<float> CarriedWeights;
+
+    // Tick time accumulated since animation started, to measure how far it drifts from the audio clock
+    double AccumulatedTickTime;
+
+    // Output latency applied to the audio clock of the current animation
+    double OutputLatency;
+
+    // Frame rate assumed for JSON blendshape payloads (frames per second)
+    UPROPERTY(EditAnywhere, Category = "MetaHuman|Streaming", meta = (ClampMin = "1.0"))
     float FrameRate;
 
+    // Scratch row for interpolated weights
+    TArray<float> SampledWeights;
+
+    // Pose evaluation of the current update
+    FMetaHumanPoseEvaluation PoseEvaluation;
+
+    // Pose published for the mesh's anim instance when bOutputAnimationCurves is set
+    FMetaHumanCurvePose CurvePose;
+
+    // Subsystem that updates this receiver, if it is registered with one
+    TWeakObjectPtr<UMetaHumanStreamingSubsystem> StreamingSubsystem;
+
+    // Morph target binding for each channel of BoundChannelNames
+    TArray<FMorphTargetBinding> ChannelBindings;
+
+    // Channel table the current bindings were resolved for
+    TArray<FString> BoundChannelNames;
+
+    // Weight last submitted for each channel of BoundChannelNames
+    TArray<float> LastAppliedWeights;
+
+    // Scratch list of channels that changed enough to be submitted
+    TArray<int32> ChangedChannels;
+
+    // Morph targets bound since the mesh was set, which are the only ones the receiver writes
+    TArray<FMorphTargetBinding> TouchedMorphTargets;
+
+    // Bit per morph target of the mesh, set for the entries of TouchedMorphTargets
+    TBitArray<> TouchedMorphTargetMask;
+
+    // Flag indicating whether the touched morph targets are fading to neutral
+    bool bIsFadingToNeutral;
+
+    // Seconds since the fade to neutral started
+    float NeutralFadeTime;
+
+    // Milliseconds the current fade to neutral lasts
+    float NeutralFadeDuration;
+
+    // Weight of each touched morph target when the fade started, and scratch for the faded weights
+    TArray<float> NeutralFadeStartWeights;
+    TArray<float> FadeWeights;
+
+    // Alpha of the curve pose when the fade started
+    float NeutralFadeStartCurveAlpha;
+
+    // Updates skipped since SkippedUpdatesWindowStart, for the per-second stat
+    int64 SkippedUpdatesInWindow;
+    double SkippedUpdatesWindowStart;
+
+    // Sound waves recycled across utterances and streams
+    UPROPERTY()
+    FMetaHumanSoundWavePool SoundWavePool;
+
+    // Sound wave an interrupt is fading out; it keeps playing until the fade has been heard
+    UPROPERTY()
+    UMetaHumanClockedSoundWave* FadingSoundWave;
+
+    // Time the last interrupt arrived, and the latest time its sound is stopped even if the fade never finished rendering
+    double InterruptTime;
+    double FadingSoundWaveDeadline;
+
+    // Seconds from the last interrupt until its audio was silent, or negative if none has completed
+    float LastInterruptToSilenceSeconds;
+
+    // Procedural sound wave fed by the current stream
+    UPROPERTY()
+    UMetaHumanClockedSoundWave* StreamingSoundWave;
+
+    // Flag indicating whether a streamed utterance is in progress
+    bool bIsStreaming;
+
+    // Flag indicating whether the sender has ended the current stream
+    bool bStreamEnded;
+
+    // One past the highest sequence number received for the current stream
+    int32 NextStreamSequence;
+
+    // Audio format of the current stream
+    int32 StreamingSampleRate;
+    int32 StreamingNumChannels;
+    EMetaHumanAudioCodec StreamingCodec;
+
+    // Decoder of an Opus stream; packets are decoded in sequence order as chunks are released
+    FMetaHumanOpusDecoder StreamOpusDecoder;
+
+    // Scratch buffers for the packets and PCM of a released Opus chunk
+    TArray<TConstArrayView<uint8>> StreamOpusPackets;
+    TArray<uint8> StreamDecodedPCM;
+
+    // Seconds of audio released to the sound wave for the current stream
+    double StreamedAudioSeconds;
+
+    // Playout buffer for chunks of the current stream
+    FMetaHumanJitterBuffer StreamJitterBuffer;
+
+    // Messages being decoded on worker tasks, all under one key
+    FMetaHumanIngestQueue IngestQueue;
+
     /**
-     * Decode base64-encoded audio data to a USoundWave
+     * Create a USoundWave from decoded PCM
      * 
-     * This function decodes base64-encoded audio data to a USoundWave object
-     * that can be played by the audio component.
+     * This function must run on the game thread. The sound wave comes from the pool and
+     * goes back to it when the animation stops. It plays until it is stopped, so the audio
+     * of queued utterances can be appended to it.
      * 
-     * @param AudioBase64 - Base64-encoded audio data
-     * @return USoundWave* - The decoded sound wave
+     * @param PCMData - 16-bit interleaved PCM
+     * @param SampleRate - Sample rate of the PCM
+     * @param NumChannels - Number of channels of the PCM
+     * @return USoundWave* - The sound wave, or null if the format is invalid
+     */
+    USoundWave* CreateSoundWave(TConstArrayView<uint8> PCMData, int32 SampleRate, int32 NumChannels);
+
+    /**
+     * Get the callback that commits decoded messages as soon as a worker hands one back
+     * 
+     * @return TFunction<void()> - Commits the ingest queue, unless the receiver is gone by then
+     */
+    TFunction<void()> MakeIngestCommitCallback();
+
+    /**
+     * Commit decoded audio and blendshapes as the current animation
+     * 
+     * This function stores the decoded data as the current animation data
+     * and starts the animation.
+     * 
+     * @param SoundWave - The decoded sound wave
+     * @param Duration - Seconds of audio queued on the sound wave
+     * @param BlendshapeTimeline - The decoded blendshape timeline
+     */
+    void CommitAnimationData(USoundWave* SoundWave, double Duration, FBlendshapeTimeline&& BlendshapeTimeline);
+
+    /**
+     * Play a decoded utterance, or queue it behind the one that is playing
+     * 
+     * A queued utterance with the same audio format as the playing one has its audio
+     * appended to the playing sound wave right away, so it starts on the sample after the
+     * previous utterance ends.
+     * 
+     * @param Result - The decoded utterance; its data is moved out
+     * @return bool - False if the utterance could not be played or queued
+     */
+    bool EnqueueUtterance(FMetaHumanIngestResult&& Result);
+
+    /**
+     * Stop the current animation and play a decoded utterance on a new sound wave
+     * 
+     * @param Result - The decoded utterance; its blendshapes are moved out
+     * @return bool - True if playback started
+     */
+    bool PlayUtterance(FMetaHumanIngestResult& Result);
+
+    /**
+     * Play the oldest queued utterance on a new sound wave, if there is one
+     */
+    void PlayNextQueuedUtterance();
+
+    /**
+     * Append the audio of queued utterances to the playing sound wave
+     * 
+     * Utterances are chained in order until one has a different audio format, which then
+     * waits for the sound wave to run out.
+     */
+    void ChainQueuedUtterances();
+
+    /**
+     * Make the oldest queued utterance current once the playing sound wave reaches it
+     * 
+     * The last pose of the finished utterance is kept in CarriedWeights for the new one
+     * to blend in from.
      */
-    USoundWave* DecodeAudioData(const FString& AudioBase64);
+    void AdvanceToQueuedUtterance();
 
     /**
-     * Parse blendshape data from JSON
+     * Bind blendshape channels to morph targets on the MetaHuman mesh
      * 
-     * This function parses blendshape data from a JSON string.
-     * The JSON string should contain an array of blendshape frames.
+     * This function resolves every channel name to a morph target once, so that
+     * per-frame application is index based. Channels without a matching morph target
+     * are reported here and skipped afterwards.
      * 
-     * @param BlendshapeJSON - JSON string containing blendshape data
-     * @return TArray<FBlendshapeFrame> - Array of blendshape frames
+     * @param ChannelNames - Channel table of the timeline to bind
      */
-    TArray<FBlendshapeFrame> ParseBlendshapeData(const FString& BlendshapeJSON);
+    void BindChannelsToMesh(const TArray<FString>& ChannelNames);
 
     /**
      * Apply blendshapes to the MetaHuman mesh
      * 
-     * This function applies blendshape values to the MetaHuman mesh.
-     * It sets the morph target values on the skeletal mesh component.
+     * This function applies one row of the current timeline to the MetaHuman mesh.
+     * It sets the morph target values on the skeletal mesh component through
+     * the channel bindings built by BindChannelsToMesh. Channels whose weight has not
+     * moved by more than MorphTargetUpdateThreshold since it was last set are skipped.
+     * 
+     * @param Weights - Weights of the row, one per timeline channel
+     */
+    void ApplyBlendshapesToMesh(TArrayView<const float> Weights);
+
+    /**
+     * Apply a weight row to the MetaHuman mesh in one bulk write
+     * 
+     * This function writes a whole row of weights into the mesh's morph target weight
+     * array through the channel bindings, registers the bound morph targets as active,
+     * and marks the render data dirty once. The mesh refreshes these arrays when its
+     * animation is evaluated, so the receiver ticks after the mesh and re-applies the
+     * current row every tick while animating.
+     * 
+     * @param Weights - Weights of the row, one per timeline channel
+     */
+    void ApplyWeightRowToMesh(TArrayView<const float> Weights);
+
+    /**
+     * Write weights into the mesh's active morph target arrays
+     * 
+     * This function does the bulk write of ApplyWeightRowToMesh for any set of bindings.
+     * 
+     * @param Bindings - Morph targets to write
+     * @param Weights - Weight of each binding
+     */
+    void WriteMorphTargetWeights(TArrayView<const FMorphTargetBinding> Bindings, TArrayView<const float> Weights);
+
+    /**
+     * Apply a weight row through the output path the receiver is set up for
+     *
+     * @param Weights - Weights of the row, one per timeline channel
+     */
+    void ApplyWeights(TArrayView<const float> Weights);
+
+    /**
+     * Publish a weight row as the curve pose
+     *
+     * This function only copies the row; the anim instance writes the curves on the anim
+     * worker threads.
+     *
+     * @param Weights - Weights of the row, one per timeline channel
+     */
+    void PublishCurvePose(TArrayView<const float> Weights);
+
+    /**
+     * Order the receiver's tick and the mesh's tick for the output path
+     *
+     * Bulk morph target writes must land after the mesh refreshes its morph targets, so the
+     * receiver ticks after the mesh. Per-name writes and curves must be in place before the
+     * mesh ticks to show this frame, so the mesh ticks after the receiver.
+     */
+    void UpdateMeshTickDependency();
+
+    /**
+     * Reset the touched morph targets to zero
+     * 
+     * This function zeroes only the morph targets the receiver has bound, in one pass,
+     * instead of every morph target on the mesh. The curve pose stops overriding the
+     * anim graph's curves.
+     */
+    void ClearTouchedMorphTargets();
+
+    /**
+     * Start fading the touched morph targets to neutral
+     * 
+     * This function records the weights the mesh currently shows; UpdateNeutralFade
+     * then scales them to zero over the given time. With bOutputAnimationCurves, the curve
+     * pose's alpha fades instead, handing the curves back to the anim graph.
+     * 
+     * @param FadeMilliseconds - Length of the fade
+     */
+    void BeginNeutralFade(float FadeMilliseconds);
+
+    /**
+     * Advance the fade to neutral
+     * 
+     * @param DeltaTime - Time elapsed since the last frame
+     */
+    void UpdateNeutralFade(float DeltaTime);
+
+    /**
+     * Release ready chunks from the jitter buffer
+     * 
+     * This function hands the chunks the jitter buffer releases to the sound wave and
+     * the timeline, and starts playback on the first release.
+     */
+    void PumpStreamJitterBuffer();
+
+    /**
+     * Commit a released stream chunk
+     * 
+     * This function queues the chunk's audio on the procedural sound wave, decoding Opus
+     * packets first, and writes its blendshape frames into the timeline at the frame
+     * matching the chunk's timestamp.
+     * 
+     * @param Chunk - The released chunk
+     */
+    void CommitStreamChunk(const FMetaHumanStreamChunk& Chunk);
+
+    /**
+     * Fill the audio of lost stream chunks
+     *
+     * Blendshape frames are placed by the sender's timestamps and the audio clock follows
+     * the rendered samples, so the audio of lost chunks is replaced rather than skipped;
+     * otherwise the lips would lead the audio by the lost time for the rest of the stream.
+     * Opus streams conceal the loss with the decoder; PCM streams fill it with silence.
+     *
+     * @param GapSeconds - Seconds of audio missing before the next chunk
+     */
+    void FillStreamGap(double GapSeconds);
+
+    /**
+     * Insert a chunk into the stream's jitter buffer
+     * 
+     * This function is the body of AppendStreamChunk; it takes the buffer holding the audio
+     * and the blendshape frames by value so decoded messages can hand over their data without copies.
      * 
-     * @param BlendshapeValues - Map of blendshape names to values
+     * @param Sequence - Sequence number of the chunk, starting at 0
+     * @param Timestamp - Stream time of the chunk's first audio sample and blendshape frame, in seconds
+     * @param AudioBuffer - Buffer holding the chunk's audio: 16-bit PCM, or length-prefixed Opus packets for an Opus stream
+     * @param AudioOffset - Offset of the audio within AudioBuffer
+     * @param AudioSize - Size of the audio in bytes
+     * @param BlendshapeFrames - Blendshape frames of the chunk
      */
-    void ApplyBlendshapesToMesh(const TMap<FString, float>& BlendshapeValues);
+    void InsertStreamChunk(int32 Sequence, double Timestamp, TArray<uint8>&& AudioBuffer, int32 AudioOffset, int32 AudioSize, FBlendshapeTimeline&& BlendshapeFrames);
 
     /**
      * Start playing the animation
      * 
      * This function starts playing the animation.
      * It sets up the audio component, resets the animation state, and starts audio playback.
+     * While streaming, the timeline may still be empty when playback starts.
      */
     void StartAnimation();
 
@@ -253,68 +1041,84 @@ private:
      * Stop the current animation
      * 
      * This function stops the current animation.
-     * It stops audio playback, resets the animation state, and resets all blendshapes to zero.
+     * It stops audio playback, returns the sound wave to the pool, resets the animation state,
+     * and resets all blendshapes to zero.
+     * 
+     * @param bInterrupted - Fade the blendshapes over InterruptFadeMilliseconds instead of NeutralFadeMilliseconds, and leave audio an interrupt is fading out playing
+     */
+    void StopAnimation(bool bInterrupted = false);
+
+    /**
+     * Stop the interrupted sound once its fade out has been heard
+     * 
+     * This function also reports the interrupt-to-silence latency.
+     */
+    void UpdateInterruptFade();
+
+    /**
+     * Stop the interrupted sound and return its sound wave to the pool
      */
-    void StopAnimation();
+    void FinishInterruptFade();
 
     /**
-     * Update the animation based on elapsed time
+     * Advance the animation based on elapsed time
      * 
-     * This function updates the animation based on elapsed time.
-     * It calculates the current frame based on time and frame rate,
-     * and applies blendshapes for the current frame.
+     * This function follows the audio clock (or elapsed time), moves on to queued utterances
+     * chained onto the sound wave, and stops the animation at its end. It records the time
+     * to evaluate in PoseEvaluation.
      * 
      * @param DeltaTime - Time elapsed since the last frame
+     * @return bool - True if there is a pose to evaluate
      */
-    void UpdateAnimation(float DeltaTime);
+    bool AdvanceAnimation(float DeltaTime);
 
     /**
-     * Handle WebSocket connection established
+     * Evaluate the pose recorded by AdvanceAnimation
      * 
-     * This function is called when the WebSocket connection is established.
-     * It logs a message indicating that the connection was successful.
+     * This function calculates the current frame from the time and frame rate, and samples
+     * the timeline at that time when BlendshapeInterpolation is not Step or the utterance
+     * is blending in.
      */
-    void OnWebSocketConnected();
+    void SampleAnimation();
 
     /**
-     * Handle WebSocket connection error
-     * 
-     * This function is called when there is an error with the WebSocket connection.
-     * It logs an error message with the error details.
-     * 
-     * @param Error - Error message
+     * Apply the pose evaluated by SampleAnimation to the mesh and report the A/V offset
+     */
+    void ApplyAnimation();
+
+    /**
+     * Add the change in the utterance queue's length to the Queued Utterances stat
      */
-    void OnWebSocketConnectionError(const FString& Error);
+    void ReportQueuedUtterances();
 
     /**
-     * Handle WebSocket connection closed
+     * Ask the subsystem to update this receiver again, if it is registered with one
+     */
+    void WakePlayback();
+
+    /**
+     * Get the playback position of the current audio
      * 
-     * This function is called when the WebSocket connection is closed.
-     * It logs a message with the status code, reason, and whether the closure was clean.
+     * The position comes from the render-thread clock of the current sound wave: the
+     * samples the audio renderer has pulled, when it pulled them, and the output latency.
      * 
-     * @param StatusCode - Status code for the closure
-     * @param Reason - Reason for the closure
-     * @param bWasClean - Whether the closure was clean
+     * @param OutSeconds - Receives the playback position in seconds
+     * @return bool - False if no audio has been rendered yet
      */
-    void OnWebSocketClosed(int32 StatusCode, const FString& Reason, bool bWasClean);
+    bool GetAudioClockTime(double& OutSeconds) const;
 
     /**
-     * Handle message received via WebSocket
-     * 
-     * This function is called when a message is received via WebSocket.
-     * It parses the message as JSON, extracts the audio and blendshape data,
-     * and processes the received data.
+     * Get the output latency to apply to the audio clock
      * 
-     * @param Message - The received message
+     * @return double - AudioOutputLatencySeconds, or an estimate from the audio device's buffering
      */
-    void OnWebSocketMessage(const FString& Message);
+    double GetAudioOutputLatency() const;
 
     /**
      * Handle HTTP response received
      * 
      * This function is called when an HTTP response is received.
-     * It parses the response as JSON, extracts the audio and blendshape data,
-     * and processes the received data.
+     * It hands the response body to the asynchronous ingest pipeline.
      * 
      * @param Request - The HTTP request
      * @param Response - The HTTP response
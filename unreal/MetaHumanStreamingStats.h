@@ -0,0 +1,18 @@
+/**
+ * MetaHumanStreamingStats.h
+ *
+ * This header file declares the stat group shared by the MetaHuman streaming classes.
+ *
+ * Libraries/Modules used:
+ * - CoreMinimal.h: Core Unreal Engine functionality
+ * - Stats/Stats.h: Unreal Engine stat system
+ *
+ * The stats can be viewed in game with the console command "stat MetaHumanStreaming".
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+
+DECLARE_STATS_GROUP(TEXT("MetaHumanStreaming"), STATGROUP_MetaHumanStreaming, STATCAT_Advanced);
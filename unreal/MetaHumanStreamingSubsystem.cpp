@@ -0,0 +1,328 @@
+/**
+ * MetaHumanStreamingSubsystem.cpp
+ *
+ * Implementation of UMetaHumanStreamingSubsystem, which routes backend messages to the
+ * receivers of several MetaHuman characters.
+ */
+
+#include "MetaHumanStreamingSubsystem.h"
+#include "MetaHumanStreamingReceiver.h"
+#include "MetaHumanIngestPipeline.h"
+#include "MetaHumanStreamingStats.h"
+#include "Async/ParallelFor.h"
+
+DECLARE_CYCLE_STAT(TEXT("Streaming Subsystem Tick"), STAT_MetaHumanSubsystemTick, STATGROUP_MetaHumanStreaming);
+DECLARE_CYCLE_STAT(TEXT("Character Update Pass"), STAT_MetaHumanCharacterUpdatePass, STATGROUP_MetaHumanStreaming);
+DECLARE_CYCLE_STAT(TEXT("Character Sampling"), STAT_MetaHumanCharacterSampling, STATGROUP_MetaHumanStreaming);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Active Characters"), STAT_MetaHumanActiveCharacters, STATGROUP_MetaHumanStreaming);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Routed Characters"), STAT_MetaHumanRoutedCharacters, STATGROUP_MetaHumanStreaming);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Unroutable Messages"), STAT_MetaHumanUnroutableMessages, STATGROUP_MetaHumanStreaming);
+
+namespace MetaHumanStreamingSubsystem
+{
+    // Frame rate assumed for JSON blendshapes when no character is registered yet
+    constexpr float DefaultFrameRate = 30.0f;
+}
+
+UMetaHumanStreamingSubsystem::UMetaHumanStreamingSubsystem()
+{
+    bParallelSampling = true;
+    MinParallelSamplingCharacters = 4;
+
+    // Most characters update before the meshes, which run their animation in TG_PrePhysics
+    PreMeshUpdateTickFunction.Subsystem = this;
+    PreMeshUpdateTickFunction.TickGroup = TG_PrePhysics;
+    PreMeshUpdateTickFunction.bCanEverTick = true;
+    PreMeshUpdateTickFunction.bStartWithTickEnabled = true;
+}
+
+void UMetaHumanStreamingSubsystem::Deinitialize()
+{
+    // Close WebSocket connection if it exists
+    WebSocketConnection.Close();
+
+    // Receivers that outlive the subsystem go back to ticking themselves
+    for (const FMetaHumanCharacterRoute& Route : Routes)
+    {
+        if (Route.Receiver)
+        {
+            Route.Receiver->SetStreamingSubsystem(nullptr);
+        }
+    }
+    Routes.Reset();
+    ActiveReceivers.Reset();
+    SET_DWORD_STAT(STAT_MetaHumanRoutedCharacters, 0);
+    SET_DWORD_STAT(STAT_MetaHumanActiveCharacters, 0);
+
+    if (PreMeshUpdateTickFunction.IsTickFunctionRegistered())
+    {
+        PreMeshUpdateTickFunction.UnRegisterTickFunction();
+    }
+
+    Super::Deinitialize();
+}
+
+void UMetaHumanStreamingSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+    Super::OnWorldBeginPlay(InWorld);
+
+    PreMeshUpdateTickFunction.RegisterTickFunction(InWorld.PersistentLevel);
+}
+
+void UMetaHumanStreamingSubsystem::Tick(float DeltaTime)
+{
+    SCOPE_CYCLE_COUNTER(STAT_MetaHumanSubsystemTick);
+
+    // Commit everything decoded since the last frame before any character advances
+    CommitCompletedIngests();
+
+    // The other characters were updated before their meshes ticked
+    UpdateCharacters(DeltaTime, true);
+}
+
+void UMetaHumanStreamingSubsystem::UpdateCharacters(float DeltaTime, bool bAfterMeshes)
+{
+    // Update every active character on the path in one pass; idle ones are not in the array
+    SCOPE_CYCLE_COUNTER(STAT_MetaHumanCharacterUpdatePass);
+
+    // Advance on the game thread: stream chunks, queued utterances, audio clock
+    SamplingReceivers.Reset();
+    for (UMetaHumanStreamingReceiver* Receiver : ActiveReceivers)
+    {
+        if (IsValid(Receiver) && Receiver->IsUsingBulkMorphTargetWrites() == bAfterMeshes && Receiver->BeginPlaybackUpdate(DeltaTime))
+        {
+            SamplingReceivers.Add(Receiver);
+        }
+    }
+
+    // Sample the timelines; each receiver only touches its own data
+    {
+        SCOPE_CYCLE_COUNTER(STAT_MetaHumanCharacterSampling);
+        if (bParallelSampling && SamplingReceivers.Num() >= FMath::Max(MinParallelSamplingCharacters, 2))
+        {
+            ParallelFor(SamplingReceivers.Num(), [this](int32 ReceiverIndex)
+            {
+                SamplingReceivers[ReceiverIndex]->SamplePlayback();
+            });
+        }
+        else
+        {
+            for (UMetaHumanStreamingReceiver* Receiver : SamplingReceivers)
+            {
+                Receiver->SamplePlayback();
+            }
+        }
+    }
+
+    // Apply the poses and fades on the game thread
+    for (UMetaHumanStreamingReceiver* Receiver : ActiveReceivers)
+    {
+        if (IsValid(Receiver) && Receiver->IsUsingBulkMorphTargetWrites() == bAfterMeshes)
+        {
+            Receiver->EndPlaybackUpdate(DeltaTime);
+        }
+    }
+
+    // Drop receivers that went idle; they add themselves back when playback resumes
+    for (int32 ReceiverIndex = ActiveReceivers.Num() - 1; ReceiverIndex >= 0; ReceiverIndex--)
+    {
+        UMetaHumanStreamingReceiver* Receiver = ActiveReceivers[ReceiverIndex];
+        if (!IsValid(Receiver) || !Receiver->IsPlaybackActive())
+        {
+            ActiveReceivers.RemoveAtSwap(ReceiverIndex, 1, false);
+            if (IsValid(Receiver))
+            {
+                Receiver->SetPlaybackAwake(false);
+            }
+        }
+    }
+    SET_DWORD_STAT(STAT_MetaHumanActiveCharacters, ActiveReceivers.Num());
+}
+
+void FMetaHumanPreMeshUpdateTickFunction::ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
+{
+    if (Subsystem && TickType != LEVELTICK_ViewportsOnly)
+    {
+        SCOPE_CYCLE_COUNTER(STAT_MetaHumanSubsystemTick);
+
+        // Commit what has been decoded so far, so a new utterance can start this frame
+        Subsystem->CommitCompletedIngests();
+        Subsystem->UpdateCharacters(DeltaTime, false);
+    }
+}
+
+FString FMetaHumanPreMeshUpdateTickFunction::DiagnosticMessage()
+{
+    return TEXT("FMetaHumanPreMeshUpdateTickFunction");
+}
+
+void UMetaHumanStreamingSubsystem::ActivateReceiver(UMetaHumanStreamingReceiver* Receiver)
+{
+    if (Receiver)
+    {
+        ActiveReceivers.AddUnique(Receiver);
+    }
+}
+
+TStatId UMetaHumanStreamingSubsystem::GetStatId() const
+{
+    return GET_STATID(STAT_MetaHumanSubsystemTick);
+}
+
+bool UMetaHumanStreamingSubsystem::RegisterCharacter(const FString& CharacterId, UMetaHumanStreamingReceiver* Receiver)
+{
+    if (!Receiver)
+    {
+        UE_LOG(LogTemp, Error, TEXT("Cannot register MetaHuman character %s without a receiver"), *CharacterId);
+        return false;
+    }
+    if (Routes.ContainsByPredicate([&CharacterId](const FMetaHumanCharacterRoute& Route) { return Route.CharacterId == CharacterId; }))
+    {
+        UE_LOG(LogTemp, Error, TEXT("MetaHuman character %s is already registered"), *CharacterId);
+        return false;
+    }
+
+    FMetaHumanCharacterRoute& Route = Routes.AddDefaulted_GetRef();
+    Route.CharacterId = CharacterId;
+    Route.Receiver = Receiver;
+
+    // Messages ingested for the id before it was registered are dropped
+    IngestQueue.Interrupt(CharacterId);
+
+    // The subsystem's pass updates the receiver from now on, whenever it has something to play
+    Receiver->SetStreamingSubsystem(this);
+    SET_DWORD_STAT(STAT_MetaHumanRoutedCharacters, Routes.Num());
+
+    UE_LOG(LogTemp, Log, TEXT("Registered MetaHuman character %s%s"), *CharacterId, Routes.Num() == 1 ? TEXT(" (default)") : TEXT(""));
+    return true;
+}
+
+void UMetaHumanStreamingSubsystem::UnregisterCharacter(const FString& CharacterId)
+{
+    const int32 RouteIndex = Routes.IndexOfByPredicate([&CharacterId](const FMetaHumanCharacterRoute& Route) { return Route.CharacterId == CharacterId; });
+    if (RouteIndex == INDEX_NONE)
+    {
+        return;
+    }
+
+    if (UMetaHumanStreamingReceiver* Receiver = Routes[RouteIndex].Receiver)
+    {
+        ActiveReceivers.RemoveSwap(Receiver);
+        Receiver->SetStreamingSubsystem(nullptr);
+    }
+
+    // Keep the order, so the default character stays first
+    Routes.RemoveAt(RouteIndex);
+    SET_DWORD_STAT(STAT_MetaHumanRoutedCharacters, Routes.Num());
+}
+
+void UMetaHumanStreamingSubsystem::UnregisterReceiver(UMetaHumanStreamingReceiver* Receiver)
+{
+    for (int32 RouteIndex = Routes.Num() - 1; RouteIndex >= 0; RouteIndex--)
+    {
+        if (Routes[RouteIndex].Receiver == Receiver)
+        {
+            UnregisterCharacter(Routes[RouteIndex].CharacterId);
+        }
+    }
+    ActiveReceivers.RemoveSwap(Receiver);
+}
+
+UMetaHumanStreamingReceiver* UMetaHumanStreamingSubsystem::FindReceiver(const FString& CharacterId) const
+{
+    if (CharacterId.IsEmpty())
+    {
+        return Routes.Num() > 0 ? Routes[0].Receiver : nullptr;
+    }
+
+    const FMetaHumanCharacterRoute* Route = Routes.FindByPredicate([&CharacterId](const FMetaHumanCharacterRoute& Candidate) { return Candidate.CharacterId == CharacterId; });
+    return Route ? Route->Receiver : nullptr;
+}
+
+FMetaHumanCharacterRoute* UMetaHumanStreamingSubsystem::FindRoute(const FString& CharacterId)
+{
+    if (CharacterId.IsEmpty())
+    {
+        return Routes.Num() > 0 ? &Routes[0] : nullptr;
+    }
+    return Routes.FindByPredicate([&CharacterId](const FMetaHumanCharacterRoute& Route) { return Route.CharacterId == CharacterId; });
+}
+
+bool UMetaHumanStreamingSubsystem::InitializeWebSocketConnection(const FString& ServerURL)
+{
+    // Parse and decode every message off the game thread; the connection lives and dies with the subsystem
+    return WebSocketConnection.Connect(ServerURL,
+        [this](const FString& Message) { IngestMessageAsync(Message); },
+        [this](TArray<uint8>&& Message) { IngestBinaryMessageAsync(MoveTemp(Message)); });
+}
+
+void UMetaHumanStreamingSubsystem::IngestMessageAsync(const FString& Message)
+{
+    using namespace MetaHumanStreamingSubsystem;
+
+    FString CharacterId;
+    if (FMetaHumanIngestPipeline::IsInterruptMessage(Message, CharacterId))
+    {
+        InterruptCharacter(CharacterId);
+        return;
+    }
+
+    // Blendshapes without their own frame_rate are read at the rate of the character they are for
+    CharacterId = FMetaHumanIngestPipeline::PeekCharacterId(Message);
+    const UMetaHumanStreamingReceiver* Receiver = FindReceiver(CharacterId);
+    const float FrameRate = Receiver ? Receiver->GetFrameRate() : DefaultFrameRate;
+    IngestQueue.IngestMessageAsync(GetIngestKey(CharacterId), Message, FrameRate);
+}
+
+void UMetaHumanStreamingSubsystem::IngestBinaryMessageAsync(TArray<uint8>&& Message)
+{
+    FString CharacterId;
+    if (FMetaHumanIngestPipeline::IsInterruptMessage(Message, CharacterId))
+    {
+        InterruptCharacter(CharacterId);
+        return;
+    }
+
+    const FString IngestKey = GetIngestKey(FMetaHumanIngestPipeline::PeekCharacterId(Message));
+    IngestQueue.IngestBinaryMessageAsync(IngestKey, MoveTemp(Message));
+}
+
+void UMetaHumanStreamingSubsystem::InterruptCharacter(const FString& CharacterId)
+{
+    FMetaHumanCharacterRoute* Route = FindRoute(CharacterId);
+    if (!Route || !Route->Receiver)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Interrupt for unknown MetaHuman character %s"), *CharacterId);
+        return;
+    }
+
+    IngestQueue.Interrupt(Route->CharacterId);
+    Route->Receiver->Interrupt();
+}
+
+FString UMetaHumanStreamingSubsystem::GetIngestKey(const FString& CharacterId)
+{
+    // The default character's messages share one commit order, whether they name it or not
+    const FMetaHumanCharacterRoute* Route = FindRoute(CharacterId);
+    return Route ? Route->CharacterId : CharacterId;
+}
+
+void UMetaHumanStreamingSubsystem::CommitCompletedIngests()
+{
+    IngestQueue.CommitCompleted([this](FMetaHumanIngestResult& Result)
+    {
+        CommitIngest(Result);
+    });
+}
+
+void UMetaHumanStreamingSubsystem::CommitIngest(FMetaHumanIngestResult& Result)
+{
+    FMetaHumanCharacterRoute* Route = FindRoute(Result.CharacterId);
+    if (!Route || !Route->Receiver)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Dropping message for unknown MetaHuman character %s"), *Result.CharacterId);
+        INC_DWORD_STAT(STAT_MetaHumanUnroutableMessages);
+        return;
+    }
+    Route->Receiver->CommitIngestResult(Result);
+}
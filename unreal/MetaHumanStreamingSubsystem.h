@@ -0,0 +1,341 @@
+/**
+ * MetaHumanStreamingSubsystem.h
+ *
+ * This header file defines UMetaHumanStreamingSubsystem, a world subsystem that routes
+ * messages from one backend connection to the receivers of several MetaHuman characters.
+ *
+ * Libraries/Modules used:
+ * - CoreMinimal.h: Core Unreal Engine functionality
+ * - Subsystems/WorldSubsystem.h: Tickable world subsystem base class
+ * - Engine/EngineBaseTypes.h: Tick functions
+ * - MetaHumanWebSocketConnection.h: WebSocket connection to the backend
+ * - MetaHumanIngestPipeline.h: Message decoding on worker tasks
+ *
+ * Messages name the character they are addressed to: "character" in JSON messages, or the
+ * numeric Character field of the binary header (see MetaHumanBinaryMessage.h). Messages
+ * without one go to the default character, the first one registered. Each character's
+ * playback state stays in its own UMetaHumanStreamingReceiver.
+ *
+ * The subsystem handles:
+ * - Keeping the registered characters and their receivers
+ * - Decoding the messages of all characters on the shared task graph worker pool
+ * - Committing decoded messages to their character's receiver in arrival order, without
+ *   one character's slow message holding back the others
+ * - Updating the playback of every active character in a single pass
+ *
+ * Only receivers with something to play or fade are kept in the contiguous array the
+ * update pass walks; a receiver adds itself back when playback becomes active, so idle
+ * characters cost nothing per frame. The pass advances every active receiver on the game
+ * thread, samples their timelines (in parallel with bParallelSampling), then writes the
+ * poses to the meshes on the game thread.
+ *
+ * Most characters are updated by a tick function in TG_PrePhysics that their meshes tick
+ * after, so per-name morph target writes and animation curves show in the current frame.
+ * Only characters using bulk morph target writes, which must land after their mesh has
+ * refreshed its morph targets, are updated in the subsystem's tick, after the meshes.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Engine/EngineBaseTypes.h"
+#include "MetaHumanWebSocketConnection.h"
+#include "MetaHumanIngestPipeline.h"
+#include "MetaHumanStreamingSubsystem.generated.h"
+
+// Forward declarations
+class UMetaHumanStreamingReceiver;
+class UMetaHumanStreamingSubsystem;
+
+/**
+ * A registered character and the receiver that plays its messages
+ *
+ * USTRUCT: Unreal Engine macro for defining a struct that can be used in Blueprint
+ * GENERATED_BODY: Unreal Engine macro for generating boilerplate code
+ */
+USTRUCT()
+struct FMetaHumanCharacterRoute
+{
+    GENERATED_BODY()
+
+    // Id messages address the character by
+    UPROPERTY()
+    FString CharacterId;
+
+    // Receiver holding the character's playback state
+    UPROPERTY()
+    UMetaHumanStreamingReceiver* Receiver = nullptr;
+};
+
+/**
+ * Tick function that updates the characters whose meshes tick after their receiver
+ *
+ * USTRUCT: Unreal Engine macro for defining a struct that can be used in Blueprint
+ * GENERATED_BODY: Unreal Engine macro for generating boilerplate code
+ */
+USTRUCT()
+struct FMetaHumanPreMeshUpdateTickFunction : public FTickFunction
+{
+    GENERATED_BODY()
+
+    // Subsystem whose characters are updated
+    UMetaHumanStreamingSubsystem* Subsystem = nullptr;
+
+    /**
+     * Update the characters of the subsystem that do not use bulk morph target writes
+     *
+     * @param DeltaTime - Time elapsed since the last frame
+     * @param TickType - Kind of tick for this frame
+     * @param CurrentThread - Thread the tick runs on
+     * @param MyCompletionGraphEvent - Completion event of the tick
+     */
+    virtual void ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent) override;
+
+    /**
+     * Describe the tick function for tick diagnostics
+     *
+     * @return FString - The description
+     */
+    virtual FString DiagnosticMessage() override;
+};
+
+template<>
+struct TStructOpsTypeTraits<FMetaHumanPreMeshUpdateTickFunction> : public TStructOpsTypeTraitsBase2<FMetaHumanPreMeshUpdateTickFunction>
+{
+    enum
+    {
+        WithCopy = false
+    };
+};
+
+/**
+ * World subsystem that routes backend messages to per-character receivers
+ *
+ * UCLASS: Unreal Engine macro for defining a class that can be used in Blueprint
+ * GENERATED_BODY: Unreal Engine macro for generating boilerplate code
+ */
+UCLASS()
+class METAHUMANSTREAMING_API UMetaHumanStreamingSubsystem : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+    friend struct FMetaHumanPreMeshUpdateTickFunction;
+
+public:
+    UMetaHumanStreamingSubsystem();
+
+    /**
+     * Deinitialize
+     *
+     * Closes the WebSocket connection, hands the registered receivers their tick back and
+     * unregisters the pre-mesh update tick function.
+     */
+    virtual void Deinitialize() override;
+
+    /**
+     * OnWorldBeginPlay
+     *
+     * Registers the pre-mesh update tick function with the world.
+     *
+     * @param InWorld - The world that began play
+     */
+    virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+    /**
+     * Tick
+     *
+     * Commits the messages decoded since the last frame, then updates the playback of every
+     * active character using bulk morph target writes. Tickable objects run after every tick
+     * group, so those characters' meshes have refreshed their morph targets by then. The
+     * other characters were updated before their meshes ticked.
+     *
+     * @param DeltaTime - Time elapsed since the last frame
+     */
+    virtual void Tick(float DeltaTime) override;
+
+    /**
+     * Get the stat the subsystem's tick is counted under
+     *
+     * @return TStatId - The stat id
+     */
+    virtual TStatId GetStatId() const override;
+
+    /**
+     * Register a character
+     *
+     * The receiver's own tick is disabled; the subsystem updates it from then on. The first
+     * character registered is the default character.
+     *
+     * @param CharacterId - Id messages address the character by; numeric ids can also be addressed by binary messages
+     * @param Receiver - Receiver bound to the character's mesh
+     * @return bool - False if the id is already registered or the receiver is null
+     */
+    UFUNCTION(BlueprintCallable, Category = "MetaHuman|Streaming")
+    bool RegisterCharacter(const FString& CharacterId, UMetaHumanStreamingReceiver* Receiver);
+
+    /**
+     * Unregister a character
+     *
+     * The receiver ticks itself again while its playback is active. Messages still being decoded for the character are dropped.
+     *
+     * @param CharacterId - Id the character was registered with
+     */
+    UFUNCTION(BlueprintCallable, Category = "MetaHuman|Streaming")
+    void UnregisterCharacter(const FString& CharacterId);
+
+    /**
+     * Unregister every character bound to a receiver and drop it from the update pass
+     *
+     * Called by the receiver when it ends play.
+     *
+     * @param Receiver - The receiver to forget
+     */
+    void UnregisterReceiver(UMetaHumanStreamingReceiver* Receiver);
+
+    /**
+     * Find the receiver of a character
+     *
+     * @param CharacterId - Id of the character, or empty for the default character
+     * @return UMetaHumanStreamingReceiver* - The receiver, or null if the character is not registered
+     */
+    UFUNCTION(BlueprintPure, Category = "MetaHuman|Streaming")
+    UMetaHumanStreamingReceiver* FindReceiver(const FString& CharacterId) const;
+
+    /**
+     * Get the number of registered characters
+     *
+     * @return int32 - Registered characters
+     */
+    UFUNCTION(BlueprintPure, Category = "MetaHuman|Streaming")
+    int32 GetNumCharacters() const { return Routes.Num(); }
+
+    /**
+     * Get the number of characters the update pass is walking
+     *
+     * @return int32 - Characters that are playing, streaming, fading or holding queued utterances
+     */
+    UFUNCTION(BlueprintPure, Category = "MetaHuman|Streaming")
+    int32 GetNumActiveCharacters() const { return ActiveReceivers.Num(); }
+
+    /**
+     * Include a registered receiver in the update pass until its playback is idle again
+     *
+     * Receivers call this when playback becomes active; calling it for a receiver already in the pass does nothing.
+     *
+     * @param Receiver - The receiver
+     */
+    void ActivateReceiver(UMetaHumanStreamingReceiver* Receiver);
+
+    /**
+     * Get the tick function that updates the characters that do not use bulk morph target writes
+     *
+     * Those receivers make their mesh tick after it, so the mesh shows the current pose.
+     *
+     * @return FTickFunction& - The pre-mesh update tick function
+     */
+    FTickFunction& GetPreMeshUpdateTickFunction() { return PreMeshUpdateTickFunction; }
+
+    // Sample the active characters' timelines on worker threads when there are at least MinParallelSamplingCharacters of them
+    UPROPERTY(BlueprintReadWrite, Category = "MetaHuman|Streaming")
+    bool bParallelSampling;
+
+    // Fewest active characters sampled in parallel; below this the task overhead outweighs the work
+    UPROPERTY(BlueprintReadWrite, Category = "MetaHuman|Streaming", meta = (ClampMin = "1"))
+    int32 MinParallelSamplingCharacters;
+
+    /**
+     * Initialize the WebSocket connection shared by all characters
+     *
+     * @param ServerURL - The URL of the WebSocket server
+     * @return bool - True if the connection was started
+     */
+    UFUNCTION(BlueprintCallable, Category = "MetaHuman|Streaming")
+    bool InitializeWebSocketConnection(const FString& ServerURL);
+
+    /**
+     * Ingest a message asynchronously and route it to the character it names
+     *
+     * The message is decoded on a worker task; the result is committed to the character's
+     * receiver on the next tick, after the earlier messages for the same character. JSON
+     * blendshapes without a frame_rate are read at that character's FrameRate.
+     *
+     * @param Message - The JSON message text
+     */
+    UFUNCTION(BlueprintCallable, Category = "MetaHuman|Streaming")
+    void IngestMessageAsync(const FString& Message);
+
+    /**
+     * Ingest a binary message asynchronously and route it to the character it names
+     *
+     * @param Message - The complete binary message
+     */
+    void IngestBinaryMessageAsync(TArray<uint8>&& Message);
+
+    /**
+     * Interrupt a character's playback
+     *
+     * Messages for the character that are still being decoded are dropped as well.
+     *
+     * @param CharacterId - Id of the character, or empty for the default character
+     */
+    UFUNCTION(BlueprintCallable, Category = "MetaHuman|Streaming")
+    void InterruptCharacter(const FString& CharacterId);
+
+private:
+    // Registered characters; the first is the default character
+    UPROPERTY()
+    TArray<FMetaHumanCharacterRoute> Routes;
+
+    // Receivers with active playback, walked by the update pass
+    UPROPERTY()
+    TArray<UMetaHumanStreamingReceiver*> ActiveReceivers;
+
+    // Scratch list of the active receivers that have a pose to sample this frame
+    TArray<UMetaHumanStreamingReceiver*> SamplingReceivers;
+
+    // Updates the characters that do not use bulk morph target writes before their meshes tick
+    FMetaHumanPreMeshUpdateTickFunction PreMeshUpdateTickFunction;
+
+    // Messages being decoded on worker tasks, keyed by the character they were peeked to address
+    FMetaHumanIngestQueue IngestQueue;
+
+    // WebSocket connection shared by all characters
+    FMetaHumanWebSocketConnection WebSocketConnection;
+
+    /**
+     * Find the route of a character
+     *
+     * @param CharacterId - Id of the character, or empty for the default character
+     * @return FMetaHumanCharacterRoute* - The route, or null if the character is not registered
+     */
+    FMetaHumanCharacterRoute* FindRoute(const FString& CharacterId);
+
+    /**
+     * Get the key a character's messages are ingested under
+     *
+     * @param CharacterId - Character the message addresses, as peeked before decoding
+     * @return FString - The registered id of the character, or the peeked id if it is not registered
+     */
+    FString GetIngestKey(const FString& CharacterId);
+
+    /**
+     * Update the playback of the active characters on one side of the mesh tick in a single pass
+     *
+     * @param DeltaTime - Time elapsed since the last frame
+     * @param bAfterMeshes - True to update the characters using bulk morph target writes, false for the others
+     */
+    void UpdateCharacters(float DeltaTime, bool bAfterMeshes);
+
+    /**
+     * Commit the decoded messages whose predecessors for the same character have all been committed
+     */
+    void CommitCompletedIngests();
+
+    /**
+     * Commit one decoded message to the receiver of the character it addresses
+     *
+     * @param Result - The decoded message
+     */
+    void CommitIngest(FMetaHumanIngestResult& Result);
+};
@@ -0,0 +1,139 @@
+/**
+ * MetaHumanWebSocketConnection.cpp
+ *
+ * Implementation of FMetaHumanWebSocketConnection, the WebSocket connection to the backend
+ * shared by the receiver and the streaming subsystem.
+ */
+
+#include "MetaHumanWebSocketConnection.h"
+#include "MetaHumanBinaryMessage.h"
+#include "WebSocketsModule.h"
+
+FMetaHumanWebSocketConnection::~FMetaHumanWebSocketConnection()
+{
+    Close();
+}
+
+bool FMetaHumanWebSocketConnection::Connect(const FString& ServerURL, TFunction<void(const FString&)>&& InOnTextMessage, TFunction<void(TArray<uint8>&&)>&& InOnBinaryMessage)
+{
+    Close();
+
+    FModuleManager::LoadModuleChecked<FWebSocketsModule>("WebSockets");
+
+    // Create WebSocket
+    WebSocket = FWebSocketsModule::Get().CreateWebSocket(ServerURL);
+    if (!WebSocket.IsValid())
+    {
+        UE_LOG(LogTemp, Error, TEXT("Failed to create WebSocket for %s"), *ServerURL);
+        return false;
+    }
+    OnTextMessage = MoveTemp(InOnTextMessage);
+    OnBinaryMessage = MoveTemp(InOnBinaryMessage);
+
+    // Bind event handlers; Close unbinds them, so the socket never calls into a closed connection
+    WebSocket->OnConnected().AddRaw(this, &FMetaHumanWebSocketConnection::HandleConnected);
+    WebSocket->OnConnectionError().AddRaw(this, &FMetaHumanWebSocketConnection::HandleConnectionError);
+    WebSocket->OnClosed().AddRaw(this, &FMetaHumanWebSocketConnection::HandleClosed);
+    WebSocket->OnMessage().AddRaw(this, &FMetaHumanWebSocketConnection::HandleMessage);
+    WebSocket->OnRawMessage().AddRaw(this, &FMetaHumanWebSocketConnection::HandleRawMessage);
+
+    // Connect to server
+    WebSocket->Connect();
+
+    return true;
+}
+
+void FMetaHumanWebSocketConnection::Close()
+{
+    if (WebSocket.IsValid())
+    {
+        WebSocket->OnConnected().RemoveAll(this);
+        WebSocket->OnConnectionError().RemoveAll(this);
+        WebSocket->OnClosed().RemoveAll(this);
+        WebSocket->OnMessage().RemoveAll(this);
+        WebSocket->OnRawMessage().RemoveAll(this);
+        if (WebSocket->IsConnected())
+        {
+            WebSocket->Close();
+        }
+        WebSocket = nullptr;
+    }
+
+    OnTextMessage = nullptr;
+    OnBinaryMessage = nullptr;
+    PendingBinaryMessage.Empty();
+    bDiscardingRawMessage = false;
+}
+
+void FMetaHumanWebSocketConnection::HandleConnected()
+{
+    UE_LOG(LogTemp, Log, TEXT("WebSocket connected"));
+}
+
+void FMetaHumanWebSocketConnection::HandleConnectionError(const FString& Error)
+{
+    UE_LOG(LogTemp, Error, TEXT("WebSocket connection error: %s"), *Error);
+}
+
+void FMetaHumanWebSocketConnection::HandleClosed(int32 StatusCode, const FString& Reason, bool bWasClean)
+{
+    UE_LOG(LogTemp, Log, TEXT("WebSocket closed: %d, %s, Clean: %s"),
+        StatusCode, *Reason, bWasClean ? TEXT("true") : TEXT("false"));
+}
+
+void FMetaHumanWebSocketConnection::HandleMessage(const FString& Message)
+{
+    if (OnTextMessage)
+    {
+        OnTextMessage(Message);
+    }
+}
+
+void FMetaHumanWebSocketConnection::HandleRawMessage(const void* Data, SIZE_T Size, SIZE_T BytesRemaining)
+{
+    // Skip the remaining fragments of a message that was dropped
+    if (bDiscardingRawMessage)
+    {
+        bDiscardingRawMessage = BytesRemaining > 0;
+        return;
+    }
+
+    // Size the buffer for the whole message on its first fragment
+    const SIZE_T MessageSize = PendingBinaryMessage.Num() + Size + BytesRemaining;
+    if (MessageSize > MaxBinaryMessageSize)
+    {
+        UE_LOG(LogTemp, Error, TEXT("Dropping binary WebSocket message of %llu bytes"), (uint64)MessageSize);
+        PendingBinaryMessage.Empty();
+        bDiscardingRawMessage = BytesRemaining > 0;
+        return;
+    }
+    if (PendingBinaryMessage.Num() == 0)
+    {
+        PendingBinaryMessage.Reserve((int32)MessageSize);
+    }
+    PendingBinaryMessage.Append(static_cast<const uint8*>(Data), (int32)Size);
+
+    // Text messages arrive here too; only messages starting with the binary magic are kept
+    const int32 MagicSize = sizeof(FMetaHumanBinaryMessage::Magic);
+    if (PendingBinaryMessage.Num() >= MagicSize && PendingBinaryMessage.Num() - (int32)Size < MagicSize)
+    {
+        uint32 MessageMagic = 0;
+        FMemory::Memcpy(&MessageMagic, PendingBinaryMessage.GetData(), MagicSize);
+        if (MessageMagic != FMetaHumanBinaryMessage::Magic)
+        {
+            PendingBinaryMessage.Reset();
+            bDiscardingRawMessage = BytesRemaining > 0;
+            return;
+        }
+    }
+
+    // Hand the complete message on; the bytes move, they are not copied
+    if (BytesRemaining == 0)
+    {
+        if (PendingBinaryMessage.Num() >= MagicSize && OnBinaryMessage)
+        {
+            OnBinaryMessage(MoveTemp(PendingBinaryMessage));
+        }
+        PendingBinaryMessage.Reset();
+    }
+}
@@ -0,0 +1,97 @@
+/**
+ * MetaHumanWebSocketConnection.h
+ *
+ * This header file defines FMetaHumanWebSocketConnection, the WebSocket connection to the
+ * backend shared by UMetaHumanStreamingReceiver and UMetaHumanStreamingSubsystem.
+ *
+ * Libraries/Modules used:
+ * - CoreMinimal.h: Core Unreal Engine functionality
+ * - IWebSocket.h: WebSocket interface
+ *
+ * The connection:
+ * - Creates the WebSocket and logs its connection events
+ * - Hands each text message to its owner as it arrives
+ * - Collects the fragments of each binary message and hands the complete message to its
+ *   owner without copying or converting it to text
+ *
+ * The WebSocket's raw message event fires for text frames as well as binary ones, so only
+ * raw messages that start with the binary header's magic (see MetaHumanBinaryMessage.h) are
+ * collected; anything else, and messages larger than MaxBinaryMessageSize, are skipped to
+ * their last fragment.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "IWebSocket.h"
+
+/**
+ * WebSocket connection to the backend that reassembles binary messages
+ */
+class METAHUMANSTREAMING_API FMetaHumanWebSocketConnection
+{
+public:
+    // Largest binary message accepted; larger messages are dropped
+    static constexpr SIZE_T MaxBinaryMessageSize = 64 * 1024 * 1024;
+
+    FMetaHumanWebSocketConnection() = default;
+    ~FMetaHumanWebSocketConnection();
+
+    FMetaHumanWebSocketConnection(const FMetaHumanWebSocketConnection&) = delete;
+    FMetaHumanWebSocketConnection& operator=(const FMetaHumanWebSocketConnection&) = delete;
+
+    /**
+     * Connect to the backend, closing any previous connection
+     *
+     * The handlers are called on the game thread, and never after Close.
+     *
+     * @param ServerURL - The URL of the WebSocket server
+     * @param InOnTextMessage - Called with each text message
+     * @param InOnBinaryMessage - Called with each complete binary message
+     * @return bool - True if the connection was started
+     */
+    bool Connect(const FString& ServerURL, TFunction<void(const FString&)>&& InOnTextMessage, TFunction<void(TArray<uint8>&&)>&& InOnBinaryMessage);
+
+    /**
+     * Close the connection and drop the message being received
+     */
+    void Close();
+
+    /**
+     * Check whether the connection is open
+     *
+     * @return bool - True if the WebSocket is connected
+     */
+    bool IsConnected() const { return WebSocket.IsValid() && WebSocket->IsConnected(); }
+
+private:
+    // The WebSocket, or null when not connected
+    TSharedPtr<IWebSocket> WebSocket;
+
+    // Handlers of complete messages
+    TFunction<void(const FString&)> OnTextMessage;
+    TFunction<void(TArray<uint8>&&)> OnBinaryMessage;
+
+    // Fragments of the binary message being received
+    TArray<uint8> PendingBinaryMessage;
+
+    // Flag indicating whether the rest of the raw message being received is ignored
+    bool bDiscardingRawMessage = false;
+
+    /**
+     * WebSocket event handlers
+     */
+    void HandleConnected();
+    void HandleConnectionError(const FString& Error);
+    void HandleClosed(int32 StatusCode, const FString& Reason, bool bWasClean);
+    void HandleMessage(const FString& Message);
+
+    /**
+     * Collect a fragment of a raw message, and hand the message on once it is complete
+     *
+     * @param Data - The fragment bytes
+     * @param Size - Size of the fragment in bytes
+     * @param BytesRemaining - Bytes of the message still to come; 0 for the last fragment
+     */
+    void HandleRawMessage(const void* Data, SIZE_T Size, SIZE_T BytesRemaining);
+};
@@ -7,11 +7,10 @@
 
 #include "PixelStreamingCustomHandler.h"
 #include "MetaHumanStreamingReceiver.h"
+#include "MetaHumanStreamingSubsystem.h"
+#include "Engine/World.h"
 #include "PixelStreamingModule.h"
 #include "IPixelStreamingModule.h"
-#include "Dom/JsonObject.h"
-#include "Serialization/JsonReader.h"
-#include "Serialization/JsonSerializer.h"
 
 // Sets default values
 UPixelStreamingCustomHandler::UPixelStreamingCustomHandler()
@@ -60,6 +59,12 @@ void UPixelStreamingCustomHandler::RegisterCustomMessageHandlers()
             HandleProcessDataMessage(MessageContents);
         }
     );
+    PixelStreamingModule->AddCommandHandler(
+        TEXT("interrupt"),
+        [this](const FString& MessageContents) {
+            HandleInterruptMessage(MessageContents);
+        }
+    );
     
     UE_LOG(LogTemp, Log, TEXT("Registered custom Pixel Streaming message handlers"));
 }
@@ -74,8 +79,9 @@ void UPixelStreamingCustomHandler::UnregisterCustomMessageHandlers()
         return;
     }
     
-    // Unregister custom message handler
+    // Unregister custom message handlers
     PixelStreamingModule->RemoveCommandHandler(TEXT("process_data"));
+    PixelStreamingModule->RemoveCommandHandler(TEXT("interrupt"));
     
     UE_LOG(LogTemp, Log, TEXT("Unregistered custom Pixel Streaming message handlers"));
 }
@@ -87,6 +93,10 @@ void UPixelStreamingCustomHandler::HandleCustomMessage(const FString& MessageTyp
     {
         HandleProcessDataMessage(MessageContents);
     }
+    else if (MessageType == TEXT("interrupt"))
+    {
+        HandleInterruptMessage(MessageContents);
+    }
     else
     {
         UE_LOG(LogTemp, Warning, TEXT("Unknown custom message type: %s"), *MessageType);
@@ -95,27 +105,43 @@ void UPixelStreamingCustomHandler::HandleCustomMessage(const FString& MessageTyp
 
 void UPixelStreamingCustomHandler::HandleProcessDataMessage(const FString& MessageContents)
 {
+    // Without a receiver, let the subsystem route the message to the character it names
     if (!MetaHumanReceiver)
     {
-        UE_LOG(LogTemp, Error, TEXT("MetaHuman receiver not set"));
+        UMetaHumanStreamingSubsystem* StreamingSubsystem = GetWorld() ? GetWorld()->GetSubsystem<UMetaHumanStreamingSubsystem>() : nullptr;
+        if (!StreamingSubsystem || StreamingSubsystem->GetNumCharacters() == 0)
+        {
+            UE_LOG(LogTemp, Error, TEXT("MetaHuman receiver not set"));
+            return;
+        }
+        StreamingSubsystem->IngestMessageAsync(MessageContents);
+        UE_LOG(LogTemp, Log, TEXT("Routed data message from frontend"));
         return;
     }
     
-    // Parse the message as JSON
-    TSharedPtr<FJsonObject> JsonObject;
-    TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(MessageContents);
-    if (!FJsonSerializer::Deserialize(Reader, JsonObject) || !JsonObject.IsValid())
+    // Forward the data to the MetaHuman receiver, which decodes it off the game thread
+    MetaHumanReceiver->IngestMessageAsync(MessageContents);
+    
+    UE_LOG(LogTemp, Log, TEXT("Forwarded data message from frontend"));
+}
+
+void UPixelStreamingCustomHandler::HandleInterruptMessage(const FString& MessageContents)
+{
+    // Without a receiver, interrupt the character the message names
+    if (!MetaHumanReceiver)
     {
-        UE_LOG(LogTemp, Error, TEXT("Failed to parse process_data message as JSON"));
+        UMetaHumanStreamingSubsystem* StreamingSubsystem = GetWorld() ? GetWorld()->GetSubsystem<UMetaHumanStreamingSubsystem>() : nullptr;
+        if (!StreamingSubsystem || StreamingSubsystem->GetNumCharacters() == 0)
+        {
+            UE_LOG(LogTemp, Error, TEXT("MetaHuman receiver not set"));
+            return;
+        }
+        StreamingSubsystem->InterruptCharacter(MessageContents.TrimStartAndEnd());
         return;
     }
     
-    // Extract audio and blendshape data
-    FString AudioBase64 = JsonObject->GetStringField(TEXT("audio_base64"));
-    FString BlendshapeData = JsonObject->GetObjectField(TEXT("blendshapes"))->ToJsonString();
-    
-    // Forward the data to the MetaHuman receiver
-    MetaHumanReceiver->ProcessReceivedData(AudioBase64, BlendshapeData);
+    // Interrupt right away; the message carries no data
+    MetaHumanReceiver->Interrupt();
     
-    UE_LOG(LogTemp, Log, TEXT("Processed data message from frontend"));
+    UE_LOG(LogTemp, Log, TEXT("Forwarded interrupt from frontend"));
 }
@@ -67,7 +67,9 @@ public:
      * Set the MetaHuman streaming receiver to forward data to
      * 
      * This function sets the MetaHuman streaming receiver to forward data to.
-     * The receiver should be an instance of UMetaHumanStreamingReceiver.
+     * The receiver should be an instance of UMetaHumanStreamingReceiver. Without one,
+     * messages go to the world's UMetaHumanStreamingSubsystem, which routes them to the
+     * character they name.
      * 
      * @param InReceiver - The MetaHuman streaming receiver
      */
@@ -83,7 +85,7 @@ private:
      * Register custom message handlers with the Pixel Streaming subsystem
      * 
      * This function registers custom message handlers with the Pixel Streaming subsystem.
-     * It sets up handlers for specific message types like "process_data".
+     * It sets up handlers for specific message types like "process_data" and "interrupt".
      */
     void RegisterCustomMessageHandlers();
 
@@ -91,7 +93,7 @@ private:
      * Unregister custom message handlers from the Pixel Streaming subsystem
      * 
      * This function unregisters custom message handlers from the Pixel Streaming subsystem.
-     * It removes handlers for specific message types like "process_data".
+     * It removes handlers for specific message types like "process_data" and "interrupt".
      */
     void UnregisterCustomMessageHandlers();
 
@@ -110,10 +112,20 @@ private:
      * Handle process data message from the frontend
      * 
      * This function handles process_data messages from the frontend.
-     * It parses the message as JSON, extracts the audio and blendshape data,
-     * and forwards them to the MetaHuman receiver.
+     * It forwards the message to the MetaHuman receiver's asynchronous ingest
+     * pipeline, which parses and decodes it off the game thread.
      * 
      * @param MessageContents - The contents of the message
      */
     void HandleProcessDataMessage(const FString& MessageContents);
+
+    /**
+     * Handle interrupt message from the frontend
+     * 
+     * This function handles interrupt messages from the frontend, sent when the user
+     * talks over the character. It interrupts the MetaHuman receiver's playback at once.
+     * 
+     * @param MessageContents - Id of the character to interrupt when routing through the subsystem, or empty for the default character
+     */
+    void HandleInterruptMessage(const FString& MessageContents);
 };